@@ -0,0 +1,140 @@
+// Attitude filter: cost per sensor sample against the accel-only atan2
+// formulas it replaces, and lean-angle error on a simulated ride with road
+// vibration and braking.
+
+#include <ArkAttitude.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "bench.h"
+
+#define ATTITUDE_BENCH_RATE_HZ 200
+#define ATTITUDE_BENCH_SAMPLES 4096
+
+struct BenchImuSample {
+    float ax, ay, az;   // G
+    float gx, gy, gz;   // deg/s
+    float roll;         // True lean (degrees)
+};
+
+// Leans 0 -> 25 degrees and back every 4s, with +-0.25G vibration on every
+// axis, a 0.4G braking pulse each cycle and a 1 deg/s gyro bias
+static void benchRide(BenchImuSample* samples, uint16_t count) {
+    const float dt = 1.0f / ATTITUDE_BENCH_RATE_HZ;
+    const float degToRad = 0.017453292f;
+    for (uint16_t i = 0; i < count; i++) {
+        float t = i * dt;
+        float phase = 2.0f * 3.1415927f * t / 4.0f;
+        float roll = 12.5f * (1.0f - cosf(phase));
+        float rollRate = 12.5f * sinf(phase) * 2.0f * 3.1415927f / 4.0f;
+        float braking = fmodf(t, 4.0f) < 0.5f ? -0.4f : 0.0f;
+
+        BenchImuSample& s = samples[i];
+        s.roll = roll;
+        s.ax = braking + benchNoise(0.25f);
+        s.ay = sinf(roll * degToRad) + benchNoise(0.25f);
+        s.az = cosf(roll * degToRad) + benchNoise(0.25f);
+        s.gx = rollRate + 1.0f + benchNoise(2.0f);
+        s.gy = 1.0f + benchNoise(2.0f);
+        s.gz = 1.0f + benchNoise(2.0f);
+    }
+}
+
+static double benchFused(const BenchImuSample* samples, uint16_t count) {
+    AttitudeFilter filter;
+    Attitude attitude = {};
+    const float dt = 1.0f / ATTITUDE_BENCH_RATE_HZ;
+    uint64_t updates = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t i = 0; i < count; i++) {
+            const BenchImuSample& s = samples[i];
+            attitudeUpdate(filter, s.ax, s.ay, s.az, s.gx, s.gy, s.gz, dt);
+            attitudeGet(filter, attitude);
+        }
+        updates += count;
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(&attitude, sizeof(attitude));
+    return (double)elapsed / updates;
+}
+
+static double benchAccelOnly(const BenchImuSample* samples, uint16_t count) {
+    float angles[2] = {};
+    uint64_t updates = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t i = 0; i < count; i++) {
+            const BenchImuSample& s = samples[i];
+            angles[0] += atan2f(-s.ax, sqrtf(s.ay * s.ay + s.az * s.az)) * 57.29578f;
+            angles[1] += atan2f(s.ay, s.az) * 57.29578f;
+        }
+        updates += count;
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(angles, sizeof(angles));
+    return (double)elapsed / updates;
+}
+
+template <typename Fn>
+static double benchMath(const BenchImuSample* samples, uint16_t count, Fn fn) {
+    float sum = 0.0f;
+    uint64_t calls = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t i = 0; i < count; i++) {
+            sum += fn(samples[i]);
+        }
+        calls += count;
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(&sum, sizeof(sum));
+    return (double)elapsed / calls;
+}
+
+// RMS lean error after the filter has settled (first ride cycle skipped)
+static void benchLeanError(const BenchImuSample* samples, uint16_t count, double& accelRms, double& fusedRms) {
+    AttitudeFilter filter;
+    Attitude attitude;
+    const float dt = 1.0f / ATTITUDE_BENCH_RATE_HZ;
+    double accelSq = 0;
+    double fusedSq = 0;
+    uint32_t n = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        const BenchImuSample& s = samples[i];
+        attitudeUpdate(filter, s.ax, s.ay, s.az, s.gx, s.gy, s.gz, dt);
+        if (i < 4 * ATTITUDE_BENCH_RATE_HZ) continue;
+        attitudeGet(filter, attitude);
+        double accelRoll = atan2(s.ay, s.az) * 57.29578;
+        accelSq += (accelRoll - s.roll) * (accelRoll - s.roll);
+        fusedSq += (attitude.roll - s.roll) * (attitude.roll - s.roll);
+        n++;
+    }
+    accelRms = sqrt(accelSq / n);
+    fusedRms = sqrt(fusedSq / n);
+}
+
+int runAttitudeBench() {
+    printf("== Attitude filter (%d Hz samples) ==\n", ATTITUDE_BENCH_RATE_HZ);
+    static BenchImuSample samples[ATTITUDE_BENCH_SAMPLES];
+    srand(1);
+    benchRide(samples, ATTITUDE_BENCH_SAMPLES);
+
+    printf("accel-only pitch/roll (libm):   %6.1f ns/sample\n", benchAccelOnly(samples, ATTITUDE_BENCH_SAMPLES));
+    printf("fused update + attitude:        %6.1f ns/sample\n", benchFused(samples, ATTITUDE_BENCH_SAMPLES));
+    printf("atan2f %5.1f ns, fastAtan2 %5.1f ns; 1/sqrtf %5.1f ns, fastInvSqrt %5.1f ns\n",
+           benchMath(samples, ATTITUDE_BENCH_SAMPLES, [](const BenchImuSample& s) { return atan2f(s.ay, s.az); }),
+           benchMath(samples, ATTITUDE_BENCH_SAMPLES, [](const BenchImuSample& s) { return fastAtan2(s.ay, s.az); }),
+           benchMath(samples, ATTITUDE_BENCH_SAMPLES, [](const BenchImuSample& s) { return 1.0f / sqrtf(s.az * s.az + 0.5f); }),
+           benchMath(samples, ATTITUDE_BENCH_SAMPLES, [](const BenchImuSample& s) { return fastInvSqrt(s.az * s.az + 0.5f); }));
+
+    double accelRms = 0;
+    double fusedRms = 0;
+    benchLeanError(samples, ATTITUDE_BENCH_SAMPLES, accelRms, fusedRms);
+    printf("lean error with vibration + braking: accel-only %.2f deg RMS, fused %.2f deg RMS\n", accelRms, fusedRms);
+    printf("\n");
+    return 0;
+}
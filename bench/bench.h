@@ -0,0 +1,59 @@
+#ifndef ARK_BENCH_H
+#define ARK_BENCH_H
+
+// Host benchmarks for the ArkRender library.
+// Build and run with:  pio run -e native && .pio/build/native/program [suite]
+
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimum wall time spent on each measured case
+#define BENCH_MIN_TIME_NS 200000000ULL
+
+// Longest strip any suite renders (matches MAX_LEDS_PER_STRIP in the firmware)
+#define BENCH_MAX_LEDS 1000
+
+inline uint64_t benchNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the optimizer from discarding rendered frames
+inline void benchConsume(const void* data, size_t length) {
+    static volatile uint8_t sink = 0;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    sink = sink + bytes[0] + bytes[length - 1];
+}
+
+// Uniform noise in +-amplitude for synthetic sensor data (seed with srand)
+inline float benchNoise(float amplitude) {
+    return amplitude * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+}
+
+// Value to raw sensor counts at lsbPerUnit, clipped like the sensor's range
+inline int16_t benchCounts(float value, float lsbPerUnit) {
+    float counts = value * lsbPerUnit;
+    if (counts > 32767.0f) return 32767;
+    if (counts < -32768.0f) return -32768;
+    return (int16_t)lrintf(counts);
+}
+
+// Render one effect repeatedly on a numLeds strip (render_bench.cpp)
+void benchEffect(uint8_t effect, uint16_t numLeds, double& framesPerSec, double& nsPerLed);
+
+// Benchmark suites
+int runRenderBench();
+int runBlendBench();
+int runStripLengthBench();
+int runCompositeBench();
+int runPerfBench();
+int runAttitudeBench();
+// Extra arguments: [ride.bin] [setting=value ...]
+int runReplayBench(int argc, char** argv);
+// Extra arguments: [ride.bin]
+int runBrakingBench(int argc, char** argv);
+
+#endif // ARK_BENCH_H
@@ -0,0 +1,93 @@
+// Direction-fade blend: fixed-point packed kernel vs the previous float path.
+
+#include <ArkRender.h>
+
+#include "bench.h"
+
+static const uint16_t kLedCounts[] = { 11, 60, 144, 255 };
+static const uint8_t kLedCountCount = sizeof(kLedCounts) / sizeof(kLedCounts[0]);
+
+// Previous implementation: three float multiply-adds plus constrain per pixel
+static void blendLEDArraysFloat(CRGB* target, const CRGB* source1, const CRGB* source2, uint16_t numLeds, float fadeProgress) {
+    for (uint16_t i = 0; i < numLeds; i++) {
+        float r = source1[i].r + (source2[i].r - source1[i].r) * fadeProgress;
+        float g = source1[i].g + (source2[i].g - source1[i].g) * fadeProgress;
+        float b = source1[i].b + (source2[i].b - source1[i].b) * fadeProgress;
+        target[i].r = (uint8_t)constrain(r, 0, 255);
+        target[i].g = (uint8_t)constrain(g, 0, 255);
+        target[i].b = (uint8_t)constrain(b, 0, 255);
+    }
+}
+
+static double benchFloat(const CRGB* oldFrame, const CRGB* newFrame, CRGB* out, uint16_t numLeds) {
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t f = 0; f < 256; f++) {
+            blendLEDArraysFloat(out, oldFrame, newFrame, numLeds, f / 256.0f);
+        }
+        frames += 256;
+        benchConsume(out, numLeds * sizeof(CRGB));
+        elapsed = benchNowNs() - start;
+    }
+    return (double)elapsed / (frames * numLeds);
+}
+
+static double benchFixed(const CRGB* oldFrame, const CRGB* newFrame, CRGB* out, uint16_t numLeds) {
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t f = 0; f < 256; f++) {
+            blendLEDArrays(out, oldFrame, newFrame, numLeds, f);
+        }
+        frames += 256;
+        benchConsume(out, numLeds * sizeof(CRGB));
+        elapsed = benchNowNs() - start;
+    }
+    return (double)elapsed / (frames * numLeds);
+}
+
+// Largest per-channel difference between the two kernels over a whole fade
+static uint8_t maxDeviation(const CRGB* oldFrame, const CRGB* newFrame, uint16_t numLeds) {
+    static CRGB a[BENCH_MAX_LEDS];
+    static CRGB b[BENCH_MAX_LEDS];
+    uint8_t worst = 0;
+    for (uint16_t f = 0; f <= 256; f++) {
+        blendLEDArraysFloat(a, oldFrame, newFrame, numLeds, f / 256.0f);
+        blendLEDArrays(b, oldFrame, newFrame, numLeds, f);
+        for (uint16_t i = 0; i < numLeds; i++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                uint8_t d = a[i].raw[c] > b[i].raw[c] ? a[i].raw[c] - b[i].raw[c] : b[i].raw[c] - a[i].raw[c];
+                if (d > worst) worst = d;
+            }
+        }
+    }
+    return worst;
+}
+
+int runBlendBench() {
+    // 4-byte aligned like the heap-allocated strip buffers on the device
+    alignas(4) static CRGB oldFrame[255];
+    alignas(4) static CRGB newFrame[255];
+    alignas(4) static CRGB out[255];
+    for (uint16_t i = 0; i < 255; i++) {
+        oldFrame[i] = CHSV(i, 255, 255);
+        newFrame[i] = CRGB(random8(), random8(), random8());
+    }
+
+    printf("== Direction fade blend (per frame, one strip) ==\n");
+    printf("%5s | %12s %12s | %12s %12s | %7s | %s\n",
+           "LEDs", "float ns/LED", "fixed ns/LED", "float us/frm", "fixed us/frm", "speedup", "max dev");
+    for (uint8_t c = 0; c < kLedCountCount; c++) {
+        uint16_t numLeds = kLedCounts[c];
+        double floatNs = benchFloat(oldFrame, newFrame, out, numLeds);
+        double fixedNs = benchFixed(oldFrame, newFrame, out, numLeds);
+        printf("%5u | %12.2f %12.2f | %12.3f %12.3f | %6.2fx | %u\n",
+               numLeds, floatNs, fixedNs, floatNs * numLeds / 1000.0, fixedNs * numLeds / 1000.0,
+               floatNs / fixedNs, maxDeviation(oldFrame, newFrame, numLeds));
+    }
+    printf("\n");
+    return 0;
+}
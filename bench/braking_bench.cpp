@@ -0,0 +1,255 @@
+// Braking detector: trigger latency and false triggers on replayed rides,
+// comparing the jerk + filtered-deceleration detector at several latency
+// budgets with the detector it replaced (a raw sample past the threshold on
+// every sample for 200ms straight). Every stop must light within the budget
+// of its deceleration passing the threshold by more than the vibration can
+// hide; the suite fails otherwise. Stops that only just reach the threshold
+// light whenever the filtered deceleration gets past it.
+//
+//   program braking             synthetic stops with known onsets
+//   program braking ride.bin    brake-on times of each detector on a recorded ride
+
+#include <ArkMotion.h>
+#include <ArkMotionLog.h>
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "bench.h"
+
+#define BRAKING_BENCH_RATE_HZ 200
+#define BRAKING_BENCH_STOPS 40
+#define BRAKING_BENCH_CYCLE_MS 6000
+#define BRAKING_BENCH_MATCH_MS 1000         // Trigger this long after the threshold crossing still detects the stop
+#define BRAKING_BENCH_VIBRATION 0.2f        // G, uniform on every axis
+#define BRAKING_BENCH_MARGIN 0.1f           // G past the threshold the budget is measured from (~2x filtered vibration)
+#define BRAKING_LEGACY_SUSTAIN_MS 200
+
+struct BrakingBenchStop {
+    uint32_t onsetMs;   // Deceleration starts ramping in
+    uint32_t crossMs;   // True deceleration reaches the threshold
+    uint32_t clearMs;   // True deceleration passes the threshold by BRAKING_BENCH_MARGIN (0 = never)
+    float decel;        // G
+    uint16_t rampMs;
+};
+
+struct BrakingBenchResult {
+    uint16_t detected;
+    uint16_t falseTriggers;
+    std::vector<int32_t> latencies;     // ms after the threshold crossing
+    int32_t clearLatency;               // Worst ms after passing the threshold by the margin
+    double nsPerSample;
+};
+
+// The detector before the latency budget: every raw sample must stay past
+// the threshold, and one noisy sample restarts the 200ms
+struct LegacyBraking {
+    uint32_t detectedTime = 0;
+    bool active = false;
+};
+
+static void legacyBrakingDetect(LegacyBraking& legacy, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    float forwardAccel = getCalibratedForwardAccel(config.calibration, data);
+    if (forwardAccel < config.brakingThreshold) {
+        if (legacy.detectedTime == 0) {
+            legacy.detectedTime = nowMs;
+        } else if (nowMs - legacy.detectedTime >= BRAKING_LEGACY_SUSTAIN_MS) {
+            legacy.active = true;
+        }
+    } else {
+        legacy.detectedTime = 0;
+        if (legacy.active && forwardAccel >= 0) legacy.active = false;
+    }
+}
+
+// Each 6s cycle: cruise past a pothole, a 30ms rut and a 100ms 0.3G
+// slowdown (none of which should light the brakes), then stop from a
+// 0.55-1.0G deceleration ramped in over 0-400ms, held 1.5s
+static void brakingSynthesize(std::vector<MotionLogRecord>& records, BrakingBenchStop* stops, float threshold) {
+    const float decels[] = {0.55f, 0.65f, 0.8f, 1.0f};
+    const uint16_t ramps[] = {0, 50, 150, 400};
+    for (uint16_t k = 0; k < BRAKING_BENCH_STOPS; k++) {
+        BrakingBenchStop& stop = stops[k];
+        stop.decel = decels[k % 4];
+        stop.rampMs = ramps[(k / 4) % 4];
+        stop.onsetMs = k * BRAKING_BENCH_CYCLE_MS + 3500;
+        stop.crossMs = stop.onsetMs + (uint32_t)(stop.rampMs * -threshold / stop.decel);
+        float clearDecel = -threshold + BRAKING_BENCH_MARGIN;
+        stop.clearMs = stop.decel < clearDecel ? 0 : stop.onsetMs + (uint32_t)(stop.rampMs * clearDecel / stop.decel);
+    }
+
+    srand(7);
+    const uint32_t periodUs = 1000000 / BRAKING_BENCH_RATE_HZ;
+    uint32_t previousUs = 0;
+    uint32_t sampleCount = BRAKING_BENCH_STOPS * BRAKING_BENCH_CYCLE_MS * BRAKING_BENCH_RATE_HZ / 1000;
+    records.reserve(sampleCount);
+    for (uint32_t i = 0; i < sampleCount; i++) {
+        uint32_t ms = i * 1000 / BRAKING_BENCH_RATE_HZ;
+        const BrakingBenchStop& stop = stops[ms / BRAKING_BENCH_CYCLE_MS];
+        uint32_t cycleMs = ms % BRAKING_BENCH_CYCLE_MS;
+
+        float forward = 0.0f;
+        float bump = 0.0f;
+        if (cycleMs >= 1000 && cycleMs < 1010) bump = 3.0f;
+        if (cycleMs >= 1800 && cycleMs < 1830) forward = -0.9f;
+        if (cycleMs >= 2500 && cycleMs < 2600) forward = -0.3f;
+        if (ms >= stop.onsetMs && ms < stop.onsetMs + 1500) {
+            uint32_t t = ms - stop.onsetMs;
+            forward = t < stop.rampMs ? -stop.decel * t / stop.rampMs : -stop.decel;
+        }
+
+        MotionSample sample;
+        sample.timeUs = i * periodUs;
+        sample.ax = benchCounts(forward + bump + benchNoise(BRAKING_BENCH_VIBRATION), MOTION_ACCEL_LSB_PER_G);
+        sample.ay = benchCounts(bump + benchNoise(BRAKING_BENCH_VIBRATION), MOTION_ACCEL_LSB_PER_G);
+        sample.az = benchCounts(1.0f + bump + benchNoise(BRAKING_BENCH_VIBRATION), MOTION_ACCEL_LSB_PER_G);
+        sample.gx = benchCounts(benchNoise(3.0f), MOTION_GYRO_LSB_PER_DPS);
+        sample.gy = benchCounts(benchNoise(3.0f), MOTION_GYRO_LSB_PER_DPS);
+        sample.gz = benchCounts(benchNoise(3.0f), MOTION_GYRO_LSB_PER_DPS);
+        records.push_back(motionLogEncode(sample, previousUs));
+    }
+}
+
+// Replays the records through one detector (latencyMs 0 = legacy), calling
+// onTrigger(nowMs) on every brake-on
+template <typename Fn>
+static void brakingReplay(const std::vector<MotionLogRecord>& records, const MotionConfig& config,
+                          uint32_t latencyMs, Fn onTrigger) {
+    MotionConfig detectorConfig = config;
+    detectorConfig.brakingLatencyMs = latencyMs;
+    MotionDetectors motion;
+    LegacyBraking legacy;
+    float dt = 1.0f / config.sampleRateHz;
+    uint32_t timeUs = 0;
+    for (const MotionLogRecord& record : records) {
+        MotionSample sample = motionLogDecode(record, timeUs);
+        MotionData data = motionFuseSample(motion.attitude, sample, dt);
+        uint32_t nowMs = timeUs / 1000;
+        if (latencyMs == 0) {
+            bool wasActive = legacy.active;
+            legacyBrakingDetect(legacy, detectorConfig, data, nowMs);
+            if (legacy.active && !wasActive) onTrigger(nowMs);
+        } else {
+            bool wasActive = motion.brakingActive;
+            processBrakingDetection(motion, detectorConfig, data, nowMs);
+            if (motion.brakingActive && !wasActive) onTrigger(nowMs);
+        }
+    }
+}
+
+static BrakingBenchResult brakingScore(const std::vector<MotionLogRecord>& records, const BrakingBenchStop* stops,
+                                       const MotionConfig& config, uint32_t latencyMs) {
+    BrakingBenchResult result = {};
+    bool matched[BRAKING_BENCH_STOPS] = {};
+    brakingReplay(records, config, latencyMs, [&](uint32_t nowMs) {
+        for (uint16_t k = 0; k < BRAKING_BENCH_STOPS; k++) {
+            if (!matched[k] && nowMs >= stops[k].onsetMs && nowMs <= stops[k].crossMs + BRAKING_BENCH_MATCH_MS) {
+                matched[k] = true;
+                result.detected++;
+                result.latencies.push_back((int32_t)(nowMs - stops[k].crossMs));
+                if (stops[k].clearMs != 0) {
+                    result.clearLatency = std::max(result.clearLatency, (int32_t)(nowMs - stops[k].clearMs));
+                }
+                return;
+            }
+        }
+        result.falseTriggers++;
+    });
+    std::sort(result.latencies.begin(), result.latencies.end());
+
+    uint64_t samples = 0;
+    uint32_t triggers = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        brakingReplay(records, config, latencyMs, [&](uint32_t) { triggers++; });
+        samples += records.size();
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(&triggers, sizeof(triggers));
+    result.nsPerSample = (double)elapsed / samples;
+    return result;
+}
+
+// latencyMs 0 = no bound (legacy detector); returns false if the bound was broken
+static bool brakingPrint(const char* name, const BrakingBenchResult& result, uint32_t latencyMs) {
+    printf("%-28s %3d/%d", name, result.detected, BRAKING_BENCH_STOPS);
+    if (result.latencies.empty()) {
+        printf("      -       -       -");
+    } else {
+        size_t n = result.latencies.size();
+        printf("  %4ldms  %4ldms  %4ldms", (long)result.latencies[n / 2], (long)result.latencies[n * 9 / 10],
+               (long)result.latencies[n - 1]);
+    }
+    printf("  %5d  %6.1f ns", result.falseTriggers, result.nsPerSample);
+    bool withinBudget = result.detected == BRAKING_BENCH_STOPS && result.clearLatency <= (int32_t)latencyMs;
+    if (latencyMs > 0) printf("  %4ldms %s", (long)result.clearLatency, withinBudget ? "ok" : "OVER BUDGET");
+    printf("\n");
+    return latencyMs == 0 || withinBudget;
+}
+
+static int brakingLogBench(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        printf("Can't open %s\n", path);
+        return 1;
+    }
+    MotionLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || !motionLogHeaderValid(header)) {
+        printf("%s is not a ride log\n", path);
+        fclose(file);
+        return 1;
+    }
+    MotionConfig config = header.configBytes == sizeof(MotionConfig) ? header.config : MotionConfig();
+    config.sampleRateHz = header.sampleRateHz;
+    std::vector<MotionLogRecord> records;
+    MotionLogRecord record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        records.push_back(record);
+    }
+    fclose(file);
+
+    printf("== Braking detector (%s, %.1fs, threshold %.2fG) ==\n", path,
+           (double)records.size() / header.sampleRateHz, config.brakingThreshold);
+    const uint32_t budgets[] = {0, config.brakingLatencyMs};
+    for (uint32_t budget : budgets) {
+        uint32_t triggers = 0;
+        printf(budget == 0 ? "sustained %dms (previous):" : "jerk + filter, %ums budget:",
+               budget == 0 ? BRAKING_LEGACY_SUSTAIN_MS : budget);
+        brakingReplay(records, config, budget, [&](uint32_t nowMs) {
+            printf(" %.2fs", nowMs / 1000.0);
+            triggers++;
+        });
+        printf("  (%lu brake-ons)\n", (unsigned long)triggers);
+    }
+    printf("\n");
+    return 0;
+}
+
+int runBrakingBench(int argc, char** argv) {
+    if (argc > 0) return brakingLogBench(argv[0]);
+
+    MotionConfig config;
+    config.brakingEnabled = true;
+    config.sampleRateHz = BRAKING_BENCH_RATE_HZ;
+    static BrakingBenchStop stops[BRAKING_BENCH_STOPS];
+    std::vector<MotionLogRecord> records;
+    brakingSynthesize(records, stops, config.brakingThreshold);
+
+    printf("== Braking detector (%d stops at 0.55-1.0G, 0-400ms onset, +-%.1fG vibration, threshold %.2fG) ==\n",
+           BRAKING_BENCH_STOPS, BRAKING_BENCH_VIBRATION, config.brakingThreshold);
+    printf("latency from the true deceleration crossing the threshold; false = brake-ons outside any stop;\n");
+    printf("bound = worst latency from passing the threshold by %.1fG, against the budget\n", BRAKING_BENCH_MARGIN);
+    printf("detector                     found     p50     p90     max  false                   bound\n");
+    brakingPrint("sustained 200ms (previous)", brakingScore(records, stops, config, 0), 0);
+    const uint32_t budgets[] = {BRAKING_MIN_LATENCY_MS, BRAKING_DEFAULT_LATENCY_MS, 200};
+    bool bounded = true;
+    for (uint32_t budget : budgets) {
+        char name[40];
+        snprintf(name, sizeof(name), "jerk + filter, %lums budget", (unsigned long)budget);
+        bounded &= brakingPrint(name, brakingScore(records, stops, config, budget), budget);
+    }
+    printf("\n");
+    return bounded ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+// Layer compositor: cost of flattening a strip's layer stack per frame, from
+// the base-only fast path up to every overlay fading at once.
+
+#include <ArkCompositor.h>
+
+#include "bench.h"
+
+static const uint16_t kLedCounts[] = { 11, 144, 1000 };
+static const uint8_t kLedCountCount = sizeof(kLedCounts) / sizeof(kLedCounts[0]);
+
+enum CompositeCase : uint8_t {
+    CASE_BASE_ONLY = 0,     // Riding, no overlays
+    CASE_BLINKER,           // Turn signal on half the strip
+    CASE_BRAKE_BLINKER,     // Brake frame + turn signal
+    CASE_ALL_FADING,        // Brake, blinker and impact all partially transparent
+    CASE_COUNT
+};
+
+static const char* const kCaseNames[CASE_COUNT] = {
+    "base only", "base+blinker", "base+brake+blinker", "all layers fading"
+};
+
+static void setupStack(LayerStack& stack, uint8_t which, const CRGB* base, const CRGB* brake, uint16_t numLeds) {
+    stack = LayerStack();
+    stack.layers[LAYER_BASE].pixels = base;
+    layerFadeTo(stack.layers[LAYER_BASE], 255, LAYER_FADE_INSTANT);
+    stack.layers[LAYER_BLINKER].color = CRGB::Yellow;
+    layerSetRange(stack.layers[LAYER_BLINKER], numLeds / 2, numLeds);
+    stack.layers[LAYER_BRAKE].pixels = brake;
+    stack.layers[LAYER_IMPACT].color = CRGB::White;
+
+    if (which >= CASE_BLINKER) {
+        layerFadeTo(stack.layers[LAYER_BLINKER], 255, LAYER_FADE_INSTANT);
+    }
+    if (which >= CASE_BRAKE_BLINKER) {
+        layerFadeTo(stack.layers[LAYER_BRAKE], 255, LAYER_FADE_INSTANT);
+    }
+    if (which >= CASE_ALL_FADING) {
+        layerFadeTo(stack.layers[LAYER_BRAKE], 160, LAYER_FADE_INSTANT);
+        layerFadeTo(stack.layers[LAYER_BLINKER], 200, LAYER_FADE_INSTANT);
+        layerFadeTo(stack.layers[LAYER_IMPACT], 96, LAYER_FADE_INSTANT);
+    }
+}
+
+static double benchComposite(uint8_t which, uint16_t numLeds) {
+    static CRGB base[BENCH_MAX_LEDS];
+    static CRGB brake[BENCH_MAX_LEDS];
+    static CRGB out[BENCH_MAX_LEDS];
+    fill_rainbow(base, numLeds, 0, 3);
+    fill_solid(brake, numLeds, CRGB::Red);
+
+    LayerStack stack;
+    setupStack(stack, which, base, brake, numLeds);
+
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t f = 0; f < 256; f++) {
+            compositeLayers(out, numLeds, stack);
+        }
+        frames += 256;
+        benchConsume(out, numLeds * sizeof(CRGB));
+        elapsed = benchNowNs() - start;
+    }
+    return (double)elapsed / (frames * numLeds);
+}
+
+int runCompositeBench() {
+    printf("== Layer composite (per frame, one strip) ==\n");
+    printf("%-20s", "stack");
+    for (uint8_t c = 0; c < kLedCountCount; c++) {
+        printf(" | %4u LEDs ns/LED %6s", kLedCounts[c], "us");
+    }
+    printf("\n");
+
+    for (uint8_t which = 0; which < CASE_COUNT; which++) {
+        printf("%-20s", kCaseNames[which]);
+        for (uint8_t c = 0; c < kLedCountCount; c++) {
+            double nsPerLed = benchComposite(which, kLedCounts[c]);
+            printf(" | %15.2f %6.2f", nsPerLed, nsPerLed * kLedCounts[c] / 1000.0);
+        }
+        printf("\n");
+    }
+    printf("\n");
+    return 0;
+}
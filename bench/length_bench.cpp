@@ -0,0 +1,104 @@
+// Long strips: per-frame CPU cost (render + direction-fade blend + show-gate
+// hash) against the time the frame takes on the wire, at 300/600/1000 LEDs.
+// The wire time is fixed by the protocol (800 kHz, 24 or 32 bits per LED plus
+// the latch), so it sets the frame-rate ceiling for a given strip length no
+// matter how fast the render path is.
+
+#include <ArkRender.h>
+#include <ArkFrameClock.h>
+#include <ArkShowGate.h>
+
+#include "bench.h"
+
+static const uint16_t kLedCounts[] = { 300, 600, 1000 };
+static const uint8_t kLedCountCount = sizeof(kLedCounts) / sizeof(kLedCounts[0]);
+
+// WS2812/SK6812 timing: 1.25 us per bit, >= 80 us latch
+#define WIRE_NS_PER_BIT 1250
+#define WIRE_LATCH_US 80
+
+static double wireMicros(uint16_t numLeds, uint8_t bitsPerLed) {
+    return numLeds * bitsPerLed * WIRE_NS_PER_BIT / 1000.0 + WIRE_LATCH_US;
+}
+
+static double benchBlendMicros(uint16_t numLeds) {
+    alignas(4) static CRGB oldFrame[BENCH_MAX_LEDS];
+    alignas(4) static CRGB newFrame[BENCH_MAX_LEDS];
+    alignas(4) static CRGB out[BENCH_MAX_LEDS];
+    fill_rainbow(oldFrame, numLeds, 0, 1);
+    fill_solid(newFrame, numLeds, CRGB::Orange);
+
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t f = 0; f < 256; f++) {
+            blendLEDArrays(out, oldFrame, newFrame, numLeds, f);
+        }
+        frames += 256;
+        benchConsume(out, numLeds * sizeof(CRGB));
+        elapsed = benchNowNs() - start;
+    }
+    return elapsed / 1000.0 / frames;
+}
+
+static double benchHashMicros(uint16_t numLeds) {
+    static CRGB leds[BENCH_MAX_LEDS];
+    fill_rainbow(leds, numLeds, 0, 1);
+
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    uint32_t hash = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t f = 0; f < 256; f++) {
+            hash ^= frameHash(leds, numLeds, (uint8_t)f);
+        }
+        frames += 256;
+        benchConsume(&hash, sizeof(hash));
+        elapsed = benchNowNs() - start;
+    }
+    return elapsed / 1000.0 / frames;
+}
+
+int runStripLengthBench() {
+    printf("== Strip length (per frame, one strip) ==\n");
+    printf("%5s | %9s %9s %-22s | %8s %8s | %9s %9s | %8s %8s\n",
+           "LEDs", "avg us", "worst us", "(worst effect)", "blend us", "hash us",
+           "RGB wire", "RGBW wire", "RGB fps", "RGBW fps");
+
+    for (uint8_t c = 0; c < kLedCountCount; c++) {
+        uint16_t numLeds = kLedCounts[c];
+
+        double totalMicros = 0;
+        double worstMicros = 0;
+        uint8_t worstEffect = 0;
+        for (uint8_t effect = 0; effect < FX_COUNT; effect++) {
+            double fps = 0;
+            double nsPerLed = 0;
+            benchEffect(effect, numLeds, fps, nsPerLed);
+            double micros = 1e6 / fps;
+            totalMicros += micros;
+            if (micros > worstMicros) {
+                worstMicros = micros;
+                worstEffect = effect;
+            }
+        }
+
+        double blendMicros = benchBlendMicros(numLeds);
+        double hashMicros = benchHashMicros(numLeds);
+        double rgbWire = wireMicros(numLeds, 24);
+        double rgbwWire = wireMicros(numLeds, 32);
+
+        // Worst case: slowest effect during a direction fade, frame gated and sent
+        double cpuMicros = worstMicros * 2 + blendMicros + hashMicros;
+        printf("%5u | %9.1f %9.1f %-22s | %8.1f %8.1f | %9.0f %9.0f | %8.1f %8.1f\n",
+               numLeds, totalMicros / FX_COUNT, worstMicros, getEffectName(worstEffect),
+               blendMicros, hashMicros, rgbWire, rgbwWire,
+               1e6 / (cpuMicros + rgbWire), 1e6 / (cpuMicros + rgbwWire));
+    }
+    printf("fps = 1e6 / (2 x worst render + blend + hash + wire); host CPU times, wire times are exact.\n");
+    printf("Firmware frame clock targets %u fps by default (TARGET_FPS, %u-%u).\n\n",
+           ARKLIGHTS_FPS, FRAME_CLOCK_MIN_FPS, FRAME_CLOCK_MAX_FPS);
+    return 0;
+}
@@ -0,0 +1,58 @@
+// ArkLights host benchmark runner
+
+#include <string.h>
+
+#include "bench.h"
+
+int main(int argc, char** argv) {
+    const char* suite = argc > 1 ? argv[1] : "all";
+    bool all = strcmp(suite, "all") == 0;
+    bool ran = false;
+    int status = 0;
+
+    if (all || strcmp(suite, "render") == 0) {
+        runRenderBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "blend") == 0) {
+        runBlendBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "length") == 0) {
+        runStripLengthBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "composite") == 0) {
+        runCompositeBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "perf") == 0) {
+        runPerfBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "attitude") == 0) {
+        runAttitudeBench();
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "replay") == 0) {
+        status |= runReplayBench(argc > 2 ? argc - 2 : 0, argv + 2);
+        ran = true;
+    }
+
+    if (all || strcmp(suite, "braking") == 0) {
+        status |= runBrakingBench(argc > 2 ? argc - 2 : 0, argv + 2);
+        ran = true;
+    }
+
+    if (!ran) {
+        printf("Unknown suite '%s'. Available: all, render, blend, length, composite, perf, attitude, replay, braking\n", suite);
+        return 1;
+    }
+    return status;
+}
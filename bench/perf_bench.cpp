@@ -0,0 +1,50 @@
+// Stage profiler: what a PerfScope costs, and what it adds to an effect
+// render when the render engine's stage hooks are set.
+
+#include <ArkPerf.h>
+#include <ArkRender.h>
+
+#include "bench.h"
+
+static double benchPerfScope() {
+    static PerfStats stats;
+    uint64_t scopes = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint16_t i = 0; i < 1024; i++) {
+            PerfScope perf(stats);
+        }
+        scopes += 1024;
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(&stats.samples, sizeof(stats.samples));
+    return (double)elapsed / scopes;
+}
+
+int runPerfBench() {
+    printf("== Stage profiler ==\n");
+    printf("PerfScope (two counter reads + record): %.1f ns\n", benchPerfScope());
+
+    static PerfStats effectStats;
+    double framesPerSec = 0;
+    double nsPerLed = 0;
+    double offNs[2] = {};
+    double onNs[2] = {};
+    const uint16_t ledCounts[2] = { 11, 144 };
+    for (uint8_t c = 0; c < 2; c++) {
+        perfEffectStats = nullptr;
+        benchEffect(FX_SOLID, ledCounts[c], framesPerSec, nsPerLed);
+        offNs[c] = 1e9 / framesPerSec;
+        perfEffectStats = &effectStats;
+        benchEffect(FX_SOLID, ledCounts[c], framesPerSec, nsPerLed);
+        onNs[c] = 1e9 / framesPerSec;
+    }
+    perfEffectStats = nullptr;
+    for (uint8_t c = 0; c < 2; c++) {
+        printf("solid %4u LEDs: %8.1f ns/frame unprofiled, %8.1f ns/frame profiled\n",
+               ledCounts[c], offNs[c], onNs[c]);
+    }
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Per-effect render throughput: frames/sec and ns/LED for every FX_* effect
+// at the strip lengths we ship. Color order is applied by the LED controller
+// on output, so this is the complete per-frame render cost.
+
+#include <ArkRender.h>
+
+#include "bench.h"
+
+static const uint16_t kLedCounts[] = { 11, 60, 144, 255 };
+static const uint8_t kLedCountCount = sizeof(kLedCounts) / sizeof(kLedCounts[0]);
+
+void benchEffect(uint8_t effect, uint16_t numLeds, double& framesPerSec, double& nsPerLed) {
+    static CRGB leds[BENCH_MAX_LEDS];
+    fill_solid(leds, numLeds, CRGB::Black);
+
+    static uint8_t statePool[BENCH_MAX_LEDS + 64];
+    EffectTiming timing;
+    effectStateBind(timing.state, statePool, effectStateBytes(numLeds));
+    uint64_t frames = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        for (uint8_t i = 0; i < 64; i++) {
+            applyEffectToArray(leds, numLeds, effect, CRGB::Red, timing, CRGB::Black, false);
+            timing.step += 2;
+        }
+        frames += 64;
+        benchConsume(leds, numLeds * sizeof(CRGB));
+        elapsed = benchNowNs() - start;
+    }
+
+    framesPerSec = frames * 1e9 / elapsed;
+    nsPerLed = (double)elapsed / (frames * numLeds);
+}
+
+int runRenderBench() {
+    printf("== Render throughput ==\n");
+    printf("%-3s %-26s %-6s %-5s", "id", "effect", "kind", "reads");
+    for (uint8_t c = 0; c < kLedCountCount; c++) {
+        printf(" | %4u LEDs fps %7s", kLedCounts[c], "ns/LED");
+    }
+    printf("\n");
+
+    for (uint8_t effect = 0; effect < FX_COUNT; effect++) {
+        const EffectDescriptor* fx = getEffectDescriptor(effect);
+        printf("%-3u %-26s %-6s %-5s", effect, fx->name,
+               (fx->flags & FX_FLAG_ANIMATED) ? "anim" : "static",
+               (fx->flags & FX_FLAG_READS_FRAME) ? "yes" : "no");
+        for (uint8_t c = 0; c < kLedCountCount; c++) {
+            double fps = 0;
+            double nsPerLed = 0;
+            benchEffect(effect, kLedCounts[c], fps, nsPerLed);
+            printf(" | %13.0f %7.1f", fps, nsPerLed);
+        }
+        printf("\n");
+    }
+    printf("\n");
+    return 0;
+}
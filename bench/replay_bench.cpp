@@ -0,0 +1,365 @@
+// Ride replay: feeds a recorded IMU log (GET /api/recording, or the "record"
+// serial command) through the firmware's attitude filter and detectors, and
+// reports every detection with its time and latency. Thresholds can be
+// overridden on the command line, so tuning a detector is a re-run on the
+// desk instead of another ride:
+//
+//   program replay ride.bin braking_threshold=-0.4 park_stationary_time=1500
+//
+// Without a log a synthetic ride with known events is replayed, and each
+// detection is also scored against when the event really started.
+
+#include <ArkMotion.h>
+#include <ArkMotionLog.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "bench.h"
+
+#define REPLAY_RATE_HZ 200
+#define REPLAY_RIDE_SECONDS 70
+#define REPLAY_MATCH_WINDOW_MS 3000     // Detection counts for a true event that started this long before
+#define REPLAY_MAX_TRUTHS 16
+#define REPLAY_TURN_SPEED 5.0f          // m/s through the sustained turn (sets its yaw rate)
+
+struct ReplayTruth {
+    uint32_t timeMs;
+    uint16_t event;     // MOTION_EVENT_* bit
+    bool matched;
+};
+
+// A stretch where an event must not happen (e.g. the blinker dropping mid-turn)
+struct ReplayQuiet {
+    uint32_t startMs, endMs;
+    uint16_t event;
+};
+
+struct ReplayLog {
+    MotionLogHeader header;
+    std::vector<MotionLogRecord> records;
+    ReplayTruth truths[REPLAY_MAX_TRUTHS];
+    uint8_t truthCount = 0;
+    ReplayQuiet quiets[REPLAY_MAX_TRUTHS];
+    uint8_t quietCount = 0;
+};
+
+static const char* replayEventName(uint16_t event) {
+    switch (event) {
+        case MOTION_EVENT_BRAKE_ON: return "brake on";
+        case MOTION_EVENT_BRAKE_OFF: return "brake off";
+        case MOTION_EVENT_BLINKER_ON: return "blinker on";
+        case MOTION_EVENT_BLINKER_OFF: return "blinker off";
+        case MOTION_EVENT_PARK_ON: return "park on";
+        case MOTION_EVENT_PARK_OFF: return "park off";
+        case MOTION_EVENT_IMPACT: return "impact";
+        case MOTION_EVENT_DIRECTION_FADE: return "direction fade";
+        case MOTION_EVENT_DIRECTION: return "direction";
+        case MOTION_EVENT_IMPACT_PEAK: return "impact peak";
+        default: return "?";
+    }
+}
+
+static void replayAddTruth(ReplayLog& log, uint32_t timeMs, uint16_t event) {
+    if (log.truthCount < REPLAY_MAX_TRUTHS) {
+        log.truths[log.truthCount++] = {log.header.startMs + timeMs, event, false};
+    }
+}
+
+static void replayAddQuiet(ReplayLog& log, uint32_t startMs, uint32_t endMs, uint16_t event) {
+    if (log.quietCount < REPLAY_MAX_TRUTHS) {
+        log.quiets[log.quietCount++] = {log.header.startMs + startMs, log.header.startMs + endMs, event};
+    }
+}
+
+// Lean (degrees) ramping to peak over 0.5s, held, and back over 0.5s
+static float replayLean(float t, float start, float end, float peak, float& rate) {
+    rate = 0.0f;
+    if (t < start || t > end) return 0.0f;
+    if (t < start + 0.5f) {
+        rate = peak / 0.5f;
+        return peak * (t - start) / 0.5f;
+    }
+    if (t > end - 0.5f) {
+        rate = -peak / 0.5f;
+        return peak * (end - t) / 0.5f;
+    }
+    return peak;
+}
+
+// Parked, ride off, brake, lean right then left, a pothole, a long right
+// hand turn, brake to a stop and park again - with road vibration whenever
+// the wheels turn. The short leans tilt the board without turning; the long
+// turn is coordinated like a real one (the rider leans until the
+// accelerometer reads straight down the board, and the board yaws), so only
+// the gyro shows the lean.
+static void replaySynthesize(ReplayLog& log) {
+    MotionConfig config;
+    config.brakingEnabled = true;
+    motionLogInitHeader(log.header, REPLAY_RATE_HZ, 1000, config);
+
+    replayAddTruth(log, 2000, MOTION_EVENT_PARK_ON);
+    replayAddTruth(log, 5000, MOTION_EVENT_PARK_OFF);
+    replayAddTruth(log, 15000, MOTION_EVENT_BRAKE_ON);
+    replayAddTruth(log, 20000, MOTION_EVENT_BLINKER_ON);
+    replayAddTruth(log, 30000, MOTION_EVENT_BLINKER_ON);
+    replayAddTruth(log, 40000, MOTION_EVENT_IMPACT);
+    replayAddTruth(log, 44000, MOTION_EVENT_BLINKER_ON);
+    replayAddQuiet(log, 44000, 54000, MOTION_EVENT_BLINKER_OFF);
+    replayAddTruth(log, 58000, MOTION_EVENT_BRAKE_ON);
+    replayAddTruth(log, 63000, MOTION_EVENT_PARK_ON);
+
+    srand(1);
+    const uint32_t periodUs = 1000000 / REPLAY_RATE_HZ;
+    const float degToRad = 0.017453292f;
+    uint32_t previousUs = 0;
+    for (uint32_t i = 0; i < REPLAY_RIDE_SECONDS * REPLAY_RATE_HZ; i++) {
+        float t = (float)i / REPLAY_RATE_HZ;
+        bool rolling = t >= 5.0f && t < 61.0f;
+        float vibration = rolling ? 0.15f : 0.005f;
+        float gyroNoise = rolling ? 3.0f : 0.2f;
+
+        float forward = 0.0f;
+        if (t >= 5.0f && t < 8.0f) forward = 0.2f;
+        if (t >= 15.0f && t < 17.0f) forward = -0.8f;
+        if (t >= 58.0f && t < 61.0f) forward = -0.6f;
+
+        float rollRate;
+        float roll = replayLean(t, 20.0f, 23.0f, 25.0f, rollRate);
+        if (roll == 0.0f) roll = replayLean(t, 30.0f, 33.0f, -25.0f, rollRate);
+        float turnRate;
+        float turnRoll = replayLean(t, 44.0f, 54.0f, 25.0f, turnRate);
+        if (turnRoll != 0.0f) {
+            roll = turnRoll;
+            rollRate = turnRate;
+        }
+
+        float ax = forward + benchNoise(vibration);
+        float ay = sinf(roll * degToRad) + benchNoise(vibration);
+        float az = cosf(roll * degToRad) + benchNoise(vibration);
+        float yawY = 0.0f, yawZ = 0.0f;
+        if (turnRoll != 0.0f) {
+            // Lean balances the centripetal force: accel stays along the board's Z axis,
+            // and the board yaws about the true vertical
+            float yawRate = 9.81f * tanf(turnRoll * degToRad) / REPLAY_TURN_SPEED / degToRad;
+            ay = benchNoise(vibration);
+            az = 1.0f / cosf(turnRoll * degToRad) + benchNoise(vibration);
+            yawY = yawRate * sinf(turnRoll * degToRad);
+            yawZ = yawRate * cosf(turnRoll * degToRad);
+        }
+        if (i >= 40 * REPLAY_RATE_HZ && i < 40 * REPLAY_RATE_HZ + 3) {
+            // Pothole - 15ms spike peaking at 6.9G
+            ax = ay = az = (i == 40 * REPLAY_RATE_HZ + 1) ? 4.0f : 2.0f;
+        }
+
+        MotionSample sample;
+        sample.timeUs = i * periodUs;
+        sample.ax = benchCounts(ax, MOTION_ACCEL_LSB_PER_G);
+        sample.ay = benchCounts(ay, MOTION_ACCEL_LSB_PER_G);
+        sample.az = benchCounts(az, MOTION_ACCEL_LSB_PER_G);
+        sample.gx = benchCounts(rollRate + benchNoise(gyroNoise), MOTION_GYRO_LSB_PER_DPS);
+        sample.gy = benchCounts(yawY + benchNoise(gyroNoise), MOTION_GYRO_LSB_PER_DPS);
+        sample.gz = benchCounts(yawZ + benchNoise(gyroNoise), MOTION_GYRO_LSB_PER_DPS);
+        log.records.push_back(motionLogEncode(sample, previousUs));
+    }
+}
+
+static bool replayLoad(ReplayLog& log, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+    bool ok = fread(&log.header, sizeof(log.header), 1, file) == 1 && motionLogHeaderValid(log.header);
+    if (!ok) {
+        printf("%s is not a ride log (version %d expected)\n", path, MOTION_LOG_VERSION);
+    } else if (log.header.configBytes != sizeof(MotionConfig)) {
+        // Recorded by different firmware - fall back to default settings
+        printf("%s: detector settings from another firmware version, using defaults\n", path);
+        log.header.config = MotionConfig();
+    }
+    MotionLogRecord record;
+    while (ok && fread(&record, sizeof(record), 1, file) == 1) {
+        log.records.push_back(record);
+    }
+    fclose(file);
+    return ok;
+}
+
+// key=value overrides, named as in the firmware's JSON API
+static bool replayOverride(MotionConfig& config, const char* arg) {
+    const char* equals = strchr(arg, '=');
+    if (equals == nullptr) return false;
+    size_t keyLength = equals - arg;
+    float value = strtof(equals + 1, nullptr);
+    struct { const char* key; float* field; } floats[] = {
+        {"braking_threshold", &config.brakingThreshold},
+        {"forward_accel_threshold", &config.forwardAccelThreshold},
+        {"motion_sensitivity", &config.motionSensitivity},
+        {"park_accel_noise_threshold", &config.parkAccelNoiseThreshold},
+        {"park_gyro_noise_threshold", &config.parkGyroNoiseThreshold},
+    };
+    struct { const char* key; bool* field; } flags[] = {
+        {"direction_based_lighting", &config.directionBasedLighting},
+        {"braking_enabled", &config.brakingEnabled},
+        {"blinker_enabled", &config.blinkerEnabled},
+        {"park_mode_enabled", &config.parkModeEnabled},
+        {"impact_detection_enabled", &config.impactDetectionEnabled},
+    };
+    for (auto& entry : floats) {
+        if (strlen(entry.key) == keyLength && strncmp(arg, entry.key, keyLength) == 0) {
+            *entry.field = value;
+            return true;
+        }
+    }
+    for (auto& entry : flags) {
+        if (strlen(entry.key) == keyLength && strncmp(arg, entry.key, keyLength) == 0) {
+            *entry.field = value != 0.0f;
+            return true;
+        }
+    }
+    if (keyLength == 15 && strncmp(arg, "blinker_timeout", keyLength) == 0) {
+        config.blinkerTimeout = (uint16_t)value;
+    } else if (keyLength == 15 && strncmp(arg, "braking_latency", keyLength) == 0) {
+        config.brakingLatencyMs = (uint16_t)value;
+    } else if (keyLength == 20 && strncmp(arg, "park_stationary_time", keyLength) == 0) {
+        config.parkStationaryTime = (uint16_t)value;
+    } else if (keyLength == 16 && strncmp(arg, "impact_threshold", keyLength) == 0) {
+        config.impactThreshold = (uint8_t)value;
+    } else {
+        printf("Unknown setting '%.*s'\n", (int)keyLength, arg);
+    }
+    return true;
+}
+
+// How long the detector's condition held before it fired (0 = fires on the sample)
+static uint32_t replayDetectorLatency(const MotionDetectors& motion, uint16_t event, uint32_t nowMs) {
+    switch (event) {
+        case MOTION_EVENT_BRAKE_ON: return nowMs - motion.brakingDetectedTime;
+        case MOTION_EVENT_PARK_ON: return nowMs - motion.parkStartTime;
+        case MOTION_EVENT_DIRECTION_FADE: return nowMs - motion.directionChangeDetectedTime;
+        case MOTION_EVENT_DIRECTION: return nowMs - motion.directionFadeStartTime;
+        default: return 0;
+    }
+}
+
+// Replays the whole log once; prints events when verbose, returns the event count
+static uint32_t replayRun(ReplayLog& log, const MotionConfig& config, bool verbose, uint32_t& unexpected) {
+    MotionDetectors motion;
+    float dt = 1.0f / log.header.sampleRateHz;
+    uint32_t timeUs = 0;
+    uint32_t count = 0;
+    unexpected = 0;
+    for (const MotionLogRecord& record : log.records) {
+        MotionSample sample = motionLogDecode(record, timeUs);
+        MotionData data = motionFuseSample(motion.attitude, sample, dt);
+        uint32_t nowMs = log.header.startMs + timeUs / 1000;
+        uint16_t events = motionDetect(motion, config, data, nowMs);
+        for (uint16_t bit = 1; events != 0; bit <<= 1) {
+            if (!(events & bit)) continue;
+            events &= ~bit;
+            count++;
+            if (!verbose) continue;
+
+            printf("%8.3fs  %-15s %6lums", (nowMs - log.header.startMs) / 1000.0,
+                   replayEventName(bit), (unsigned long)replayDetectorLatency(motion, bit, nowMs));
+            if (bit == MOTION_EVENT_IMPACT_PEAK) printf("  (%.1fG)", motion.lastImpactG);
+            if (log.truthCount > 0) {
+                ReplayTruth* truth = nullptr;
+                for (uint8_t i = 0; i < log.truthCount; i++) {
+                    ReplayTruth& candidate = log.truths[i];
+                    if (candidate.event == bit && candidate.timeMs <= nowMs &&
+                        nowMs - candidate.timeMs <= REPLAY_MATCH_WINDOW_MS && !candidate.matched) {
+                        truth = &candidate;
+                        break;
+                    }
+                }
+                bool quiet = false;
+                for (uint8_t i = 0; i < log.quietCount; i++) {
+                    const ReplayQuiet& window = log.quiets[i];
+                    quiet |= window.event == bit && nowMs >= window.startMs && nowMs < window.endMs;
+                }
+                if (truth != nullptr) {
+                    truth->matched = true;
+                    printf("  %+6ldms after onset", (long)(nowMs - truth->timeMs));
+                } else if (quiet) {
+                    unexpected++;
+                    printf("  unexpected (mid-turn)");
+                } else if (bit & (MOTION_EVENT_BRAKE_ON | MOTION_EVENT_BLINKER_ON | MOTION_EVENT_PARK_ON |
+                                  MOTION_EVENT_PARK_OFF | MOTION_EVENT_IMPACT)) {
+                    unexpected++;
+                    printf("  unexpected");
+                }
+            }
+            printf("\n");
+        }
+    }
+    return count;
+}
+
+int runReplayBench(int argc, char** argv) {
+    ReplayLog log;
+    const char* path = nullptr;
+    for (int i = 0; i < argc; i++) {
+        if (strchr(argv[i], '=') == nullptr) path = argv[i];
+    }
+    if (path != nullptr) {
+        if (!replayLoad(log, path)) return 1;
+    } else {
+        replaySynthesize(log);
+    }
+    if (log.records.empty()) {
+        printf("%s has no samples\n", path);
+        return 1;
+    }
+    MotionConfig config = log.header.config;
+    config.sampleRateHz = log.header.sampleRateHz;
+    for (int i = 0; i < argc; i++) {
+        replayOverride(config, argv[i]);
+    }
+
+    double rideSeconds = (double)log.records.size() / log.header.sampleRateHz;
+    printf("== Ride replay (%s, %.1fs at %d Hz) ==\n", path != nullptr ? path : "synthetic ride",
+           rideSeconds, log.header.sampleRateHz);
+    printf("braking %s (%.2fG, %ums), blinkers %s (x%.2f, %ums), park %s (%.3fG, %.1fdps, %ums), impact %s (%dG), direction %s\n",
+           config.brakingEnabled ? "on" : "off", config.brakingThreshold, config.brakingLatencyMs,
+           config.blinkerEnabled ? "on" : "off", config.motionSensitivity, config.blinkerTimeout,
+           config.parkModeEnabled ? "on" : "off", config.parkAccelNoiseThreshold, config.parkGyroNoiseThreshold,
+           config.parkStationaryTime, config.impactDetectionEnabled ? "on" : "off", config.impactThreshold,
+           config.directionBasedLighting ? "on" : "off");
+    printf("    time  event           detector latency\n");
+
+    uint32_t unexpected = 0;
+    uint32_t events = replayRun(log, config, true, unexpected);
+    uint8_t missed = 0;
+    for (uint8_t i = 0; i < log.truthCount; i++) {
+        if (!log.truths[i].matched) {
+            printf("  missed %s at %.3fs\n", replayEventName(log.truths[i].event),
+                   (log.truths[i].timeMs - log.header.startMs) / 1000.0);
+            missed++;
+        }
+    }
+    if (log.truthCount > 0) {
+        printf("%lu events, %lu unexpected, %d of %d missed\n", (unsigned long)events, (unsigned long)unexpected,
+               missed, log.truthCount);
+    } else {
+        printf("%lu events\n", (unsigned long)events);
+    }
+
+    // Replay speed (events already printed; these passes are silent)
+    uint64_t passes = 0;
+    uint64_t start = benchNowNs();
+    uint64_t elapsed = 0;
+    while (elapsed < BENCH_MIN_TIME_NS) {
+        uint32_t ignored;
+        events += replayRun(log, config, false, ignored);
+        passes++;
+        elapsed = benchNowNs() - start;
+    }
+    benchConsume(&events, sizeof(events));
+    double nsPerSample = (double)elapsed / (passes * log.records.size());
+    printf("replay: %.1f ns/sample, %.0fx real time\n", nsPerSample, 1e9 / (nsPerSample * log.header.sampleRateHz));
+    printf("\n");
+    return 0;
+}
@@ -1161,8 +1161,8 @@ function applyCustomLEDConfig(light) {
     const count = parseInt(countEl.value) || 20;
     const type = parseInt(typeEl.value) || 0;
     
-    if (count < 1 || count > 200) {
-        alert('LED count must be between 1 and 200');
+    if (count < 1 || count > 1000) {
+        alert('LED count must be between 1 and 1000');
         return;
     }
     
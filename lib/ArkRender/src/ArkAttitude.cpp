@@ -0,0 +1,139 @@
+// Attitude filter (Mahony complementary filter)
+
+#include "ArkAttitude.h"
+
+#include <string.h>
+
+#define ATTITUDE_DEG_TO_RAD 0.017453292f
+#define ATTITUDE_RAD_TO_DEG 57.29578f
+#define ATTITUDE_HALF_PI 1.5707964f
+#define ATTITUDE_PI 3.1415927f
+
+float fastInvSqrt(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f375a86 - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(y));
+    float half = 0.5f * x;
+    y = y * (1.5f - half * y * y);
+    y = y * (1.5f - half * y * y);
+    return y;
+}
+
+float fastAtan2(float y, float x) {
+    float absX = x < 0.0f ? -x : x;
+    float absY = y < 0.0f ? -y : y;
+    float maxAbs = absX > absY ? absX : absY;
+    if (maxAbs == 0.0f) return 0.0f;
+
+    // atan on [0, 1], then unfold into the right octant
+    float a = (absX < absY ? absX : absY) / maxAbs;
+    float s = a * a;
+    float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f +
+              s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+    if (absY > absX) r = ATTITUDE_HALF_PI - r;
+    if (x < 0.0f) r = ATTITUDE_PI - r;
+    return y < 0.0f ? -r : r;
+}
+
+// Shortest rotation that lines the sensor's gravity up with earth Z (zero yaw)
+static void attitudeSeed(AttitudeFilter& filter, float ax, float ay, float az, float invNorm) {
+    ax *= invNorm;
+    ay *= invNorm;
+    az *= invNorm;
+    float w = 1.0f + az;
+    float lengthSq = w * w + ay * ay + ax * ax;
+    if (lengthSq < 1e-6f) {
+        // Exactly upside down: any half turn about a horizontal axis
+        filter.q0 = 0.0f;
+        filter.q1 = 1.0f;
+        filter.q2 = 0.0f;
+        filter.q3 = 0.0f;
+    } else {
+        float n = fastInvSqrt(lengthSq);
+        filter.q0 = w * n;
+        filter.q1 = ay * n;
+        filter.q2 = -ax * n;
+        filter.q3 = 0.0f;
+    }
+    filter.initialized = true;
+}
+
+void attitudeUpdate(AttitudeFilter& filter, float ax, float ay, float az,
+                    float gx, float gy, float gz, float dt) {
+    float normSq = ax * ax + ay * ay + az * az;
+    if (!filter.initialized) {
+        if (normSq > 0.0f) attitudeSeed(filter, ax, ay, az, fastInvSqrt(normSq));
+        return;
+    }
+
+    float q0 = filter.q0, q1 = filter.q1, q2 = filter.q2, q3 = filter.q3;
+    gx *= ATTITUDE_DEG_TO_RAD;
+    gy *= ATTITUDE_DEG_TO_RAD;
+    gz *= ATTITUDE_DEG_TO_RAD;
+
+    if (normSq > 0.0f) {
+        float invNorm = fastInvSqrt(normSq);
+        float deviation = normSq * invNorm - 1.0f;
+        if (deviation < 0.0f) deviation = -deviation;
+        float weight = 1.0f - deviation * (1.0f / ATTITUDE_ACCEL_REJECT_G);
+
+        if (weight > 0.0f) {
+            ax *= invNorm;
+            ay *= invNorm;
+            az *= invNorm;
+
+            // Gravity as the current attitude predicts it
+            float vx = 2.0f * (q1 * q3 - q0 * q2);
+            float vy = 2.0f * (q0 * q1 + q2 * q3);
+            float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+            // Error = rotation from predicted to measured gravity
+            float ex = (ay * vz - az * vy) * weight;
+            float ey = (az * vx - ax * vz) * weight;
+            float ez = (ax * vy - ay * vx) * weight;
+
+            if (filter.ki > 0.0f) {
+                filter.biasX += filter.ki * ex * dt;
+                filter.biasY += filter.ki * ey * dt;
+                filter.biasZ += filter.ki * ez * dt;
+            }
+            gx += filter.kp * ex;
+            gy += filter.kp * ey;
+            gz += filter.kp * ez;
+        }
+    }
+    gx += filter.biasX;
+    gy += filter.biasY;
+    gz += filter.biasZ;
+
+    // Integrate q' = 0.5 * q * (0, g)
+    float h = 0.5f * dt;
+    gx *= h;
+    gy *= h;
+    gz *= h;
+    float n0 = q0 + (-q1 * gx - q2 * gy - q3 * gz);
+    float n1 = q1 + (q0 * gx + q2 * gz - q3 * gy);
+    float n2 = q2 + (q0 * gy - q1 * gz + q3 * gx);
+    float n3 = q3 + (q0 * gz + q1 * gy - q2 * gx);
+
+    float invNorm = fastInvSqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+    filter.q0 = n0 * invNorm;
+    filter.q1 = n1 * invNorm;
+    filter.q2 = n2 * invNorm;
+    filter.q3 = n3 * invNorm;
+}
+
+void attitudeGet(const AttitudeFilter& filter, Attitude& out) {
+    float q0 = filter.q0, q1 = filter.q1, q2 = filter.q2, q3 = filter.q3;
+    out.gravityX = 2.0f * (q1 * q3 - q0 * q2);
+    out.gravityY = 2.0f * (q0 * q1 + q2 * q3);
+    out.gravityZ = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+    float horizontalSq = out.gravityY * out.gravityY + out.gravityZ * out.gravityZ;
+    float horizontal = horizontalSq > 0.0f ? horizontalSq * fastInvSqrt(horizontalSq) : 0.0f;
+    out.pitch = fastAtan2(-out.gravityX, horizontal) * ATTITUDE_RAD_TO_DEG;
+    out.roll = fastAtan2(out.gravityY, out.gravityZ) * ATTITUDE_RAD_TO_DEG;
+    out.yaw = fastAtan2(2.0f * (q1 * q2 + q0 * q3), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * ATTITUDE_RAD_TO_DEG;
+}
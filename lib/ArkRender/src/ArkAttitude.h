@@ -0,0 +1,57 @@
+#ifndef ARK_ATTITUDE_H
+#define ARK_ATTITUDE_H
+
+// Attitude filter - complementary (Mahony) fusion of gyro and accelerometer
+// into a quaternion. The gyro carries the attitude between samples; the
+// accelerometer's gravity direction slowly pulls it back so gyro drift never
+// accumulates. Accelerometer readings far from 1G (braking, bumps, road
+// vibration peaks) are trusted less, so they no longer tilt the lean angle.
+//
+// Single precision throughout, with a fast inverse square root and a
+// polynomial atan2 - no libm calls per sample.
+
+#include <stdint.h>
+
+// Proportional gain: how fast gravity corrects the gyro (1/s). 1.0 settles
+// in a few seconds while ignoring shocks shorter than a few hundred ms.
+#define ATTITUDE_DEFAULT_KP 1.0f
+// Integral gain: learns constant gyro bias (1/s^2)
+#define ATTITUDE_DEFAULT_KI 0.02f
+// Accelerometer weight falls linearly to 0 at this deviation from 1G
+#define ATTITUDE_ACCEL_REJECT_G 0.3f
+
+struct AttitudeFilter {
+    float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;   // Body-to-earth rotation
+    float biasX = 0.0f, biasY = 0.0f, biasZ = 0.0f;     // Integral feedback (rad/s)
+    float kp = ATTITUDE_DEFAULT_KP;
+    float ki = ATTITUDE_DEFAULT_KI;
+    bool initialized = false;
+};
+
+// Attitude in the firmware's units (degrees). Pitch and roll use the same
+// axes and signs as the accel-only formulas they replace; yaw is a heading
+// relative to power-on and drifts slowly (no magnetometer).
+struct Attitude {
+    float pitch, roll, yaw;
+    float gravityX, gravityY, gravityZ;  // Estimated gravity in the sensor frame (unit length, G)
+};
+
+// Forget the current attitude; the next update seeds it from the accelerometer
+inline void attitudeReset(AttitudeFilter& filter) {
+    AttitudeFilter fresh;
+    fresh.kp = filter.kp;
+    fresh.ki = filter.ki;
+    filter = fresh;
+}
+
+// One sensor sample: accel in G, gyro in deg/s, dt in seconds
+void attitudeUpdate(AttitudeFilter& filter, float ax, float ay, float az,
+                    float gx, float gy, float gz, float dt);
+
+void attitudeGet(const AttitudeFilter& filter, Attitude& out);
+
+// Fast math used by the filter (exposed for the benchmarks)
+float fastInvSqrt(float x);             // ~5e-6 relative error
+float fastAtan2(float y, float x);      // Radians, ~2e-6 rad error
+
+#endif // ARK_ATTITUDE_H
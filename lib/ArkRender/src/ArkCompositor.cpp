@@ -0,0 +1,93 @@
+// Layer compositor - flattens a strip's layer stack into its output frame
+
+#include "ArkCompositor.h"
+
+#include <string.h>
+
+bool layerStackStep(LayerStack& stack) {
+    bool changed = false;
+    for (uint8_t l = 0; l < LAYER_COUNT; l++) {
+        Layer& layer = stack.layers[l];
+        if (layer.opacity == layer.targetOpacity) continue;
+
+        if (layer.opacity < layer.targetOpacity) {
+            uint8_t room = layer.targetOpacity - layer.opacity;
+            layer.opacity += room < layer.fadeRate ? room : layer.fadeRate;
+        } else {
+            uint8_t room = layer.opacity - layer.targetOpacity;
+            layer.opacity -= room < layer.fadeRate ? room : layer.fadeRate;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool layerStackFading(const LayerStack& stack) {
+    for (uint8_t l = 0; l < LAYER_COUNT; l++) {
+        if (stack.layers[l].opacity != stack.layers[l].targetOpacity) return true;
+    }
+    return false;
+}
+
+static inline bool layerCoversStrip(const Layer& layer, uint16_t numLeds) {
+    return layer.mask == nullptr && layer.maskStart == 0 && layer.maskEnd >= numLeds;
+}
+
+void compositeLayers(CRGB* out, uint16_t numLeds, const LayerStack& stack) {
+    // Collect the visible layers once so the pixel loop skips the rest. An
+    // opaque layer covering the whole strip hides everything below it.
+    const Layer* visible[LAYER_COUNT];
+    uint8_t count = 0;
+    for (uint8_t l = 0; l < LAYER_COUNT; l++) {
+        const Layer& layer = stack.layers[l];
+        if (layer.opacity == 0) continue;
+        if (layer.opacity == 255 && layerCoversStrip(layer, numLeds)) {
+            count = 0;
+        }
+        visible[count++] = &layer;
+    }
+
+    if (count == 0) {
+        fill_solid(out, numLeds, CRGB::Black);
+        return;
+    }
+
+    // Common case: only the base effect (or one opaque overlay) is showing
+    const Layer& bottom = *visible[0];
+    bool bottomOpaque = bottom.opacity == 255 && layerCoversStrip(bottom, numLeds);
+    if (count == 1 && bottomOpaque) {
+        if (bottom.pixels == nullptr) {
+            fill_solid(out, numLeds, bottom.color);
+        } else if (bottom.pixels != out) {
+            memcpy(out, bottom.pixels, numLeds * sizeof(CRGB));
+        }
+        return;
+    }
+
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint16_t r = 0;
+        uint16_t g = 0;
+        uint16_t b = 0;
+        for (uint8_t l = 0; l < count; l++) {
+            const Layer& layer = *visible[l];
+            uint8_t coverage;
+            if (layer.mask != nullptr) {
+                coverage = layer.mask[i];
+            } else {
+                coverage = (i >= layer.maskStart && i < layer.maskEnd) ? 255 : 0;
+            }
+            uint16_t alpha = scale8(coverage, layer.opacity);
+            if (alpha == 0) continue;
+
+            // 0..255 -> 0..256 so a fully opaque pixel replaces what is below exactly
+            alpha += alpha >> 7;
+            const CRGB& c = layer.pixels != nullptr ? layer.pixels[i] : layer.color;
+            r = (r * (256 - alpha) + c.r * alpha) >> 8;
+            g = (g * (256 - alpha) + c.g * alpha) >> 8;
+            b = (b * (256 - alpha) + c.b * alpha) >> 8;
+        }
+        out[i].r = r;
+        out[i].g = g;
+        out[i].b = b;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef ARK_COMPOSITOR_H
+#define ARK_COMPOSITOR_H
+
+// Layer compositor - stacks the brake, blinker and impact overlays over a
+// strip's base effect. Every layer has a coverage mask and an opacity that
+// fades towards a target, and the stack is flattened into the output frame in
+// a single pass per pixel. Overlays never paint into the base frame, so the
+// base animation (including effects that read their previous frame) keeps
+// running underneath them.
+
+#include "ArkPixel.h"
+
+// Stack order, bottom to top
+enum LayerId : uint8_t {
+    LAYER_BASE = 0,     // Strip effect (normal, direction fade or park)
+    LAYER_BRAKE,        // Brake light
+    LAYER_BLINKER,      // Turn signal
+    LAYER_IMPACT,       // Impact flash
+    LAYER_COUNT
+};
+
+#define LAYER_RANGE_END 0xFFFF  // maskEnd value covering the whole strip
+#define LAYER_FADE_INSTANT 255  // fadeRate that jumps straight to the target opacity
+
+struct Layer {
+    const CRGB* pixels = nullptr;       // Per-pixel colors, or nullptr for a solid layer
+    CRGB color = CRGB::Black;           // Solid color used when pixels is nullptr
+    const uint8_t* mask = nullptr;      // Per-pixel coverage (255 = covered); overrides the range below
+    uint16_t maskStart = 0;             // Covered pixels [maskStart, maskEnd) when mask is nullptr
+    uint16_t maskEnd = LAYER_RANGE_END;
+    uint8_t opacity = 0;                // Current opacity (0 = layer skipped)
+    uint8_t targetOpacity = 0;          // Opacity the layer fades towards
+    uint8_t fadeRate = LAYER_FADE_INSTANT;  // Opacity change per frame
+};
+
+struct LayerStack {
+    Layer layers[LAYER_COUNT];
+};
+
+// Fade a layer towards targetOpacity by fadeRate per frame (LAYER_FADE_INSTANT applies it now)
+inline void layerFadeTo(Layer& layer, uint8_t targetOpacity, uint8_t fadeRate) {
+    layer.targetOpacity = targetOpacity;
+    layer.fadeRate = fadeRate;
+    if (fadeRate == LAYER_FADE_INSTANT) {
+        layer.opacity = targetOpacity;
+    }
+}
+
+// Limit a layer to pixels [start, end)
+inline void layerSetRange(Layer& layer, uint16_t start, uint16_t end) {
+    layer.mask = nullptr;
+    layer.maskStart = start;
+    layer.maskEnd = end;
+}
+
+// Advance every layer's fade by one frame; returns true if any opacity changed
+bool layerStackStep(LayerStack& stack);
+
+// True while any layer has not reached its target opacity
+bool layerStackFading(const LayerStack& stack);
+
+// Flatten the stack into out. out may be the base layer's own pixel buffer.
+void compositeLayers(CRGB* out, uint16_t numLeds, const LayerStack& stack);
+
+#endif // ARK_COMPOSITOR_H
@@ -0,0 +1,41 @@
+// Frame arena - preallocated scratch buffers for the render pipeline
+
+#include "ArkFrameArena.h"
+
+#include <new>
+#include <string.h>
+
+bool frameArenaReserve(FrameArena& arena, uint16_t maxLeds, uint16_t stateBytes) {
+    // Round up so every slot starts on a 4-byte boundary (CRGB is 3 bytes),
+    // which keeps the blend kernel on its word path
+    uint16_t slotLeds = (maxLeds + 3) & ~3;
+    if (slotLeds == 0) slotLeds = 4;
+
+    if (arena.block != nullptr && arena.slotLeds == slotLeds && arena.stateBytes == stateBytes) {
+        return true;
+    }
+
+    frameArenaRelease(arena);
+
+    uint32_t size = (uint32_t)slotLeds * FRAME_SLOT_COUNT * sizeof(CRGB) + stateBytes;
+    arena.block = new (std::nothrow) uint8_t[size];
+    if (arena.block == nullptr) {
+        return false;
+    }
+    memset(arena.block, 0, size);
+    arena.slotLeds = slotLeds;
+    arena.stateBytes = stateBytes;
+    arena.bytes = size;
+    arena.allocations++;
+    return true;
+}
+
+void frameArenaRelease(FrameArena& arena) {
+    if (arena.block != nullptr) {
+        delete[] arena.block;
+        arena.block = nullptr;
+    }
+    arena.slotLeds = 0;
+    arena.stateBytes = 0;
+    arena.bytes = 0;
+}
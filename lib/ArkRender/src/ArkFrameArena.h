@@ -0,0 +1,46 @@
+#ifndef ARK_FRAME_ARENA_H
+#define ARK_FRAME_ARENA_H
+
+// Frame arena - owns every scratch buffer the render pipeline needs.
+// Sized once per LED configuration (initializeLEDs) and reused every frame,
+// so rendering itself never touches the heap.
+
+#include "ArkPixel.h"
+
+// Scratch buffers, each large enough for the longer of the two strips
+// (front/back roles swap between the physical strips in direction mode)
+enum FrameSlot : uint8_t {
+    FRAME_HEADLIGHT_OLD = 0,  // Snapshot of the headlight when a direction fade starts
+    FRAME_TAILLIGHT_OLD,      // Snapshot of the taillight when a direction fade starts
+    FRAME_FRONT_NEW,          // New-direction front effect during a fade
+    FRAME_BACK_NEW,           // New-direction back effect during a fade
+    FRAME_HEADLIGHT_BASE,     // Headlight base effect (bottom of its layer stack)
+    FRAME_TAILLIGHT_BASE,     // Taillight base effect (bottom of its layer stack)
+    FRAME_BRAKE,              // Brake light overlay for whichever strip is at the back
+    FRAME_SLOT_COUNT
+};
+
+struct FrameArena {
+    uint8_t* block = nullptr;   // Single allocation backing all frame slots and the state pool
+    uint16_t slotLeds = 0;      // Capacity of each slot in LEDs (multiple of 4 for word alignment)
+    uint16_t stateBytes = 0;    // Size of the effect state pool that follows the frame slots
+    uint32_t allocations = 0;   // Heap allocations made by the arena since boot
+    uint32_t bytes = 0;         // Current size of the backing block
+
+    inline CRGB* slot(FrameSlot which) const {
+        return reinterpret_cast<CRGB*>(block + (uint32_t)which * slotLeds * sizeof(CRGB));
+    }
+
+    // Effect state pool (4-byte aligned, carved up per strip by the caller)
+    inline uint8_t* statePool() const {
+        return block + (uint32_t)FRAME_SLOT_COUNT * slotLeds * sizeof(CRGB);
+    }
+};
+
+// Make sure every slot can hold maxLeds pixels and the state pool holds
+// stateBytes. Only allocates when the required capacity changes (contents are
+// zeroed when it does); returns false if the allocation failed.
+bool frameArenaReserve(FrameArena& arena, uint16_t maxLeds, uint16_t stateBytes);
+void frameArenaRelease(FrameArena& arena);
+
+#endif // ARK_FRAME_ARENA_H
@@ -0,0 +1,72 @@
+// Frame clock and frame timing histograms
+
+#include "ArkFrameClock.h"
+
+const uint32_t frameHistogramBoundsUs[FRAME_HISTOGRAM_BUCKETS] = {
+    250, 500, 1000, 2000, 4000, 8000, 12000, 16000,
+    20000, 24000, 28000, 33000, 40000, 50000, 100000, UINT32_MAX
+};
+
+void frameClockSetFps(FrameClock& clock, uint16_t fps) {
+    if (fps < FRAME_CLOCK_MIN_FPS) fps = FRAME_CLOCK_MIN_FPS;
+    if (fps > FRAME_CLOCK_MAX_FPS) fps = FRAME_CLOCK_MAX_FPS;
+    clock.periodUs = 1000000UL / fps;
+    clock.running = false;
+}
+
+uint32_t frameClockBegin(FrameClock& clock, uint32_t nowUs) {
+    uint32_t intervalUs = clock.frames > 0 ? nowUs - clock.lastStartUs : 0;
+    clock.lastStartUs = nowUs;
+    clock.frames++;
+
+    if (!clock.running) {
+        clock.deadlineUs = nowUs + clock.periodUs;
+        clock.running = true;
+        return intervalUs;
+    }
+
+    // This frame was due at deadlineUs; the next one is a period later. If
+    // that has already passed too, skip ahead on the grid. Signed difference
+    // so the comparison survives micros() wrapping.
+    clock.deadlineUs += clock.periodUs;
+    int32_t lateUs = (int32_t)(nowUs - clock.deadlineUs);
+    if (lateUs >= 0) {
+        uint32_t missed = (uint32_t)lateUs / clock.periodUs + 1;
+        clock.dropped += missed;
+        clock.deadlineUs += missed * clock.periodUs;
+    }
+    return intervalUs;
+}
+
+uint32_t frameClockWaitUs(const FrameClock& clock, uint32_t nowUs) {
+    int32_t remainingUs = (int32_t)(clock.deadlineUs - nowUs);
+    return remainingUs > 0 ? (uint32_t)remainingUs : 0;
+}
+
+void frameHistogramRecord(FrameHistogram& histogram, uint32_t us) {
+    uint8_t bucket = 0;
+    while (us > frameHistogramBoundsUs[bucket]) {
+        bucket++;  // Last bound is UINT32_MAX, so this always stops
+    }
+    histogram.counts[bucket]++;
+    histogram.samples++;
+    histogram.totalUs += us;
+    if (us < histogram.minUs) histogram.minUs = us;
+    if (us > histogram.maxUs) histogram.maxUs = us;
+}
+
+uint32_t frameHistogramPercentile(const FrameHistogram& histogram, uint8_t percent) {
+    if (histogram.samples == 0) return 0;
+    uint64_t rank = ((uint64_t)histogram.samples * percent + 99) / 100;
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < FRAME_HISTOGRAM_BUCKETS; b++) {
+        seen += histogram.counts[b];
+        if (seen >= rank) {
+            uint32_t bound = frameHistogramBoundsUs[b];
+            return bound < histogram.maxUs ? bound : histogram.maxUs;
+        }
+    }
+    return histogram.maxUs;
+}
@@ -0,0 +1,73 @@
+#ifndef ARK_FRAME_CLOCK_H
+#define ARK_FRAME_CLOCK_H
+
+// Frame clock - the single schedule every frame (render, composite, show)
+// runs on. Frames start on a fixed grid of deadlines derived from the target
+// FPS; a frame that starts a whole period late skips the deadlines it missed
+// (counted as dropped) instead of bursting to catch up, so the grid never
+// drifts. Effect animation is driven by elapsed time (effectClockAdvance), so
+// the target FPS only changes smoothness, not animation speed.
+//
+// Frame histograms bucket per-frame durations (frame interval, render time,
+// show time) on fixed microsecond bounds so they cost a few compares per
+// sample and can be read at any time without stopping the render task.
+
+#include <stdint.h>
+
+#include "ArkRender.h"
+
+#define FRAME_CLOCK_MIN_FPS 10
+#define FRAME_CLOCK_MAX_FPS 120
+
+struct FrameClock {
+    uint32_t periodUs = 1000000UL / ARKLIGHTS_FPS;
+    uint32_t deadlineUs = 0;     // Scheduled start of the next frame
+    uint32_t lastStartUs = 0;    // Actual start of the current frame
+    bool running = false;
+    uint32_t frames = 0;
+    uint32_t dropped = 0;        // Deadlines skipped because a frame started a whole period late
+};
+
+// Set the target frame rate (clamped to FRAME_CLOCK_MIN_FPS..FRAME_CLOCK_MAX_FPS).
+// The grid restarts at the next frame.
+void frameClockSetFps(FrameClock& clock, uint16_t fps);
+
+inline uint16_t frameClockFps(const FrameClock& clock) {
+    return (uint16_t)((1000000UL + clock.periodUs / 2) / clock.periodUs);
+}
+
+// Mark the start of a frame at nowUs and schedule the next deadline.
+// Returns the interval since the previous frame started (0 for the first).
+uint32_t frameClockBegin(FrameClock& clock, uint32_t nowUs);
+
+// Microseconds from nowUs until the next deadline (0 once it has passed)
+uint32_t frameClockWaitUs(const FrameClock& clock, uint32_t nowUs);
+
+#define FRAME_HISTOGRAM_BUCKETS 16
+
+// Upper bound (inclusive) of each bucket in microseconds; the last bucket is open
+extern const uint32_t frameHistogramBoundsUs[FRAME_HISTOGRAM_BUCKETS];
+
+struct FrameHistogram {
+    uint32_t counts[FRAME_HISTOGRAM_BUCKETS] = {};
+    uint32_t samples = 0;
+    uint32_t minUs = UINT32_MAX;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+};
+
+void frameHistogramRecord(FrameHistogram& histogram, uint32_t us);
+
+inline void frameHistogramReset(FrameHistogram& histogram) {
+    histogram = FrameHistogram();
+}
+
+inline uint32_t frameHistogramMeanUs(const FrameHistogram& histogram) {
+    return histogram.samples > 0 ? (uint32_t)(histogram.totalUs / histogram.samples) : 0;
+}
+
+// Upper bound of the bucket holding the given percentile (0-100), capped at
+// the largest sample seen. 0 while the histogram is empty.
+uint32_t frameHistogramPercentile(const FrameHistogram& histogram, uint8_t percent);
+
+#endif // ARK_FRAME_CLOCK_H
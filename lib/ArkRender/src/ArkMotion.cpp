@@ -0,0 +1,358 @@
+// Motion detectors
+
+#include "ArkMotion.h"
+
+#include <math.h>
+
+#define MOTION_RAD_TO_DEG 57.29578f
+
+// Samples the braking filter takes to reach BRAKING_DECIDE_FRACTION on a step
+// to the threshold - the onset is backdated by this much
+static const float brakingFilterDelaySamples = logf(1.0f - BRAKING_DECIDE_FRACTION) / logf(BRAKING_FILTER_ALPHA);
+
+MotionData motionFuseSample(AttitudeFilter& attitude, const MotionSample& sample, float dt) {
+    // Convert raw values to meaningful units
+    float accelX = sample.ax / MOTION_ACCEL_LSB_PER_G;
+    float accelY = sample.ay / MOTION_ACCEL_LSB_PER_G;
+    float accelZ = sample.az / MOTION_ACCEL_LSB_PER_G;
+    float gyroX = sample.gx / MOTION_GYRO_LSB_PER_DPS;
+    float gyroY = sample.gy / MOTION_GYRO_LSB_PER_DPS;
+    float gyroZ = sample.gz / MOTION_GYRO_LSB_PER_DPS;
+
+    attitudeUpdate(attitude, accelX, accelY, accelZ, gyroX, gyroY, gyroZ, dt);
+    Attitude fused;
+    attitudeGet(attitude, fused);
+
+    return {
+        fused.pitch,
+        fused.roll,
+        fused.yaw,
+        accelX,
+        accelY,
+        accelZ,
+        gyroX,
+        gyroY,
+        gyroZ,
+        fused.gravityX,
+        fused.gravityY,
+        fused.gravityZ
+    };
+}
+
+uint16_t motionDetect(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    bool wasBraking = motion.brakingActive;
+    bool wasBlinking = motion.blinkerActive;
+    bool wasParked = motion.parkModeActive;
+    bool wasFading = motion.directionChangePending;
+    bool wasForward = motion.isMovingForward;
+    uint32_t impacts = motion.impactCount;
+    bool peakPending = motion.impactPeakPending;
+
+    // Process motion features
+    if (config.directionBasedLighting) {
+        processDirectionDetection(motion, config, data, nowMs);
+    }
+
+    if (config.brakingEnabled) {
+        processBrakingDetection(motion, config, data, nowMs);
+    }
+
+    if (config.blinkerEnabled) {
+        processBlinkers(motion, config, data, nowMs);
+    }
+
+    if (config.parkModeEnabled) {
+        processParkMode(motion, config, data, nowMs);
+    }
+
+    if (config.impactDetectionEnabled) {
+        processImpactDetection(motion, config, data, nowMs);
+    }
+
+    uint16_t events = 0;
+    if (motion.brakingActive != wasBraking) events |= wasBraking ? MOTION_EVENT_BRAKE_OFF : MOTION_EVENT_BRAKE_ON;
+    if (motion.blinkerActive != wasBlinking) events |= wasBlinking ? MOTION_EVENT_BLINKER_OFF : MOTION_EVENT_BLINKER_ON;
+    if (motion.parkModeActive != wasParked) events |= wasParked ? MOTION_EVENT_PARK_OFF : MOTION_EVENT_PARK_ON;
+    if (motion.impactCount != impacts) events |= MOTION_EVENT_IMPACT;
+    if (peakPending && !motion.impactPeakPending) events |= MOTION_EVENT_IMPACT_PEAK;
+    if (motion.directionChangePending && !wasFading) events |= MOTION_EVENT_DIRECTION_FADE;
+    if (motion.isMovingForward != wasForward) events |= MOTION_EVENT_DIRECTION;
+    return events;
+}
+
+void processBrakingDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    if (motion.manualBrakeActive) return;
+
+    // Potholes and kerbs spike far past any braking force - keep them out of the filter
+    float motionX = data.accelX - data.gravityX;
+    float motionY = data.accelY - data.gravityY;
+    float motionZ = data.accelZ - data.gravityZ;
+    if (motionX * motionX + motionY * motionY + motionZ * motionZ > BRAKING_SPIKE_G * BRAKING_SPIKE_G) return;
+
+    // Gravity removed, so riding downhill doesn't read as braking. The fused
+    // gravity slowly leans into a long deceleration, so it is held from
+    // before the deceleration began until it has gone again.
+    if (motion.brakingDetectedTime == 0 && motion.brakingFilteredAccel > config.brakingThreshold * BRAKING_ARM_FRACTION) {
+        motion.brakingGravityX = data.gravityX;
+        motion.brakingGravityY = data.gravityY;
+        motion.brakingGravityZ = data.gravityZ;
+    }
+    float forwardMotion = calibratedForward(config.calibration, data.accelX - motion.brakingGravityX,
+                                            data.accelY - motion.brakingGravityY, data.accelZ - motion.brakingGravityZ);
+    float previous = motion.brakingFilteredAccel;
+    motion.brakingFilteredAccel = BRAKING_FILTER_ALPHA * previous + (1.0f - BRAKING_FILTER_ALPHA) * forwardMotion;
+    float forwardAccel = motion.brakingFilteredAccel;
+    float jerk = (forwardAccel - previous) * config.sampleRateHz;
+    motion.brakingJerk = BRAKING_JERK_ALPHA * motion.brakingJerk + (1.0f - BRAKING_JERK_ALPHA) * jerk;
+
+    // Only detect braking when moving forward and not in park mode (stationary)
+    bool armed = motion.isMovingForward && !motion.parkModeActive &&
+                 forwardAccel < config.brakingThreshold * BRAKING_ARM_FRACTION;
+
+    if (armed) {
+        if (motion.brakingJerk < BRAKING_JERK_ONSET) {
+            motion.brakingJerkConfirmed = true;
+        }
+        if (forwardAccel < config.brakingThreshold * BRAKING_DECIDE_FRACTION) {
+            uint32_t filterDelayMs = (uint32_t)(brakingFilterDelaySamples * 1000.0f / config.sampleRateHz);
+            if (motion.brakingDetectedTime == 0) {
+                motion.brakingDetectedTime = nowMs - filterDelayMs;
+                if (motion.brakingDetectedTime == 0) motion.brakingDetectedTime = 1;
+            }
+            uint32_t elapsed = nowMs - motion.brakingDetectedTime;
+            bool confirmed = motion.brakingJerkConfirmed && forwardAccel < config.brakingThreshold &&
+                             elapsed >= BRAKING_MIN_HOLD_MS + filterDelayMs;
+            // Decided on the last sample before the budget runs out, not the first one after.
+            // The budget only sets when the light comes on - it still takes the full threshold.
+            bool budgetUp = forwardAccel < config.brakingThreshold &&
+                            elapsed + 1000 / config.sampleRateHz > config.brakingLatencyMs;
+            if (!motion.brakingActive && (confirmed || budgetUp)) {
+                // Sharp onset held, or the budget is up with the deceleration past the threshold - activate braking
+                motion.brakingActive = true;
+                motion.brakingStartTime = nowMs;
+            }
+        }
+    } else {
+        // Deceleration gone (or not moving forward) - reset detection
+        motion.brakingDetectedTime = 0;
+        motion.brakingJerkConfirmed = false;
+
+        // Stop braking once acceleration is back to zero or positive, or we're parked
+        if (motion.brakingActive && (forwardAccel >= 0 || motion.parkModeActive)) {
+            motion.brakingActive = false;
+        }
+    }
+}
+
+// Lean for the blinkers. In a steady turn the rider leans until the
+// accelerometer reads straight down the board again, so the fused gravity
+// settles back to upright within about a second. While turning the lean is
+// therefore the roll rate integrated from the gyro alone; outside turns it
+// settles onto the fused lean, which keeps gyro drift from building up.
+static float updateLeanAngle(MotionDetectors& motion, const MotionConfig& config, const MotionData& data) {
+    float dt = 1.0f / config.sampleRateHz;
+
+    // Yaw about the gravity direction - a coordinated turn always has some
+    float yawRate = data.gyroX * data.gravityX + data.gyroY * data.gravityY + data.gyroZ * data.gravityZ;
+    bool turning = fabsf(yawRate) > BLINKER_TURN_RATE;
+
+    // Rate the gravity direction swings along the left/right axis (gravity x gyro)
+    float gx = data.gravityX, gy = data.gravityY, gz = data.gravityZ;
+    const AttitudeFilter& attitude = motion.attitude;
+    float swingRate = calibratedLeftRight(config.calibration, gy * data.gyroZ - gz * data.gyroY,
+                                          gz * data.gyroX - gx * data.gyroZ, gx * data.gyroY - gy * data.gyroX);
+    if (!turning) {
+        // The attitude filter's bias is only trusted outside turns - it reads a turn as bias
+        motion.leanRateBias = calibratedLeftRight(config.calibration, gy * attitude.biasZ - gz * attitude.biasY,
+                                                  gz * attitude.biasX - gx * attitude.biasZ,
+                                                  gx * attitude.biasY - gy * attitude.biasX) * MOTION_RAD_TO_DEG;
+    }
+    float lateral = calibratedLeftRight(config.calibration, gx, gy, gz);
+    float cosLean = sqrtf(fmaxf(1.0f - lateral * lateral, 0.25f));
+    motion.leanAngle += (swingRate + motion.leanRateBias) / cosLean * dt;
+
+    float settleMs = turning ? BLINKER_TURN_SETTLE_MS : BLINKER_LEAN_SETTLE_MS;
+    float fusedLean = getCalibratedLeanAngle(config.calibration, data);
+    motion.leanAngle += (fusedLean - motion.leanAngle) * (dt * 1000.0f / settleMs);
+    return motion.leanAngle;
+}
+
+void processBlinkers(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    // Tracked even under manual control, so the lean is current when it ends
+    float leanAngle = updateLeanAngle(motion, config, data);
+    if (motion.manualBlinkerActive) return;
+
+    // Detect turn intent based on lean angle
+    float turnThreshold = BLINKER_LEAN_ANGLE * config.motionSensitivity;
+    bool turnIntent = fabsf(leanAngle) > turnThreshold;
+
+    if (turnIntent) {
+        if (!motion.blinkerActive) {
+            motion.blinkerActive = true;
+            motion.blinkerDirection = (leanAngle > 0) ? 1 : -1; // 1 = right, -1 = left
+            motion.blinkerStartTime = nowMs;
+        }
+    } else if (motion.blinkerActive && nowMs - motion.blinkerStartTime > config.blinkerTimeout) {
+        motion.blinkerActive = false;
+        motion.blinkerDirection = 0;
+    }
+}
+
+void processParkMode(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    // Motion magnitude from accelerometer and gyroscope. The fused gravity
+    // vector is removed from the acceleration, which also catches sideways
+    // pushes that leave the total magnitude near 1G.
+    float motionX = data.accelX - data.gravityX;
+    float motionY = data.accelY - data.gravityY;
+    float motionZ = data.accelZ - data.gravityZ;
+    float accelDeviation = sqrtf(motionX * motionX + motionY * motionY + motionZ * motionZ);
+    float gyroDegPerSec = sqrtf(data.gyroX * data.gyroX + data.gyroY * data.gyroY + data.gyroZ * data.gyroZ);
+
+    // Check if device is stationary (below noise thresholds)
+    bool isStationary = (accelDeviation < config.parkAccelNoiseThreshold) &&
+                        (gyroDegPerSec < config.parkGyroNoiseThreshold);
+
+    if (isStationary) {
+        if (!motion.parkModeActive) {
+            if (motion.parkStartTime == 0) {
+                // Start park mode timer
+                motion.parkStartTime = nowMs;
+            } else if (nowMs - motion.parkStartTime > config.parkStationaryTime) {
+                // Stationary long enough
+                motion.parkModeActive = true;
+            }
+        }
+    } else {
+        // Motion detected - deactivate park mode (or restart the countdown)
+        motion.parkModeActive = false;
+        motion.parkStartTime = 0;
+    }
+}
+
+void processImpactDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    // Total acceleration (already in G) - every sensor sample is checked, so short spikes aren't missed
+    float gForce = sqrtf(data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ);
+
+    // Track the peak for a few samples after the trigger (the first sample over rarely is the peak)
+    if (motion.impactPeakPending) {
+        if (gForce > motion.lastImpactG) motion.lastImpactG = gForce;
+        if (nowMs - motion.lastImpactTime >= IMPACT_PEAK_WINDOW_MS) motion.impactPeakPending = false;
+        return;
+    }
+
+    // Detect impact (sudden high acceleration)
+    if (gForce > config.impactThreshold && nowMs - motion.lastImpactTime > IMPACT_LOCKOUT_MS) {
+        motion.lastImpactTime = nowMs;
+        motion.lastImpactG = gForce;
+        motion.impactPeakPending = true;
+        motion.impactCount++;
+    }
+}
+
+void processDirectionDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs) {
+    // Gravity removed, so pitch (hills, mounting angle) doesn't read as acceleration
+    float rawForwardAccel = getCalibratedForwardMotion(config.calibration, data);
+
+    // Apply low-pass filter to reduce noise
+    motion.filteredForwardAccel = DIRECTION_FILTER_ALPHA * motion.filteredForwardAccel +
+                                  (1.0f - DIRECTION_FILTER_ALPHA) * rawForwardAccel;
+    float forwardAccel = motion.filteredForwardAccel;
+
+    // Determine desired direction based on filtered forward acceleration
+    // Use hysteresis to prevent rapid switching (different thresholds for forward vs backward)
+    // Positive = forward, negative = backward
+    float forwardThreshold = config.forwardAccelThreshold;
+    float backwardThreshold = -config.forwardAccelThreshold;
+
+    // Add hysteresis: once moving in a direction, require more force to change
+    if (motion.isMovingForward) {
+        backwardThreshold = -config.forwardAccelThreshold * 0.7f;  // Easier to detect backward when currently forward
+    } else {
+        forwardThreshold = config.forwardAccelThreshold * 0.7f;  // Easier to detect forward when currently backward
+    }
+
+    bool desiredForward = forwardAccel > forwardThreshold;
+    bool desiredBackward = forwardAccel < backwardThreshold;
+
+    // If we're in a fade transition, continue it (don't check for new changes)
+    if (motion.directionChangePending) {
+        uint32_t fadeElapsed = nowMs - motion.directionFadeStartTime;
+
+        if (fadeElapsed < DIRECTION_FADE_DURATION) {
+            // Still fading - update progress (rendered by the render task)
+            motion.directionFadeProgress = (float)fadeElapsed / DIRECTION_FADE_DURATION;
+            if (motion.directionFadeProgress > 1.0f) motion.directionFadeProgress = 1.0f;
+        } else if (fadeElapsed < DIRECTION_FADE_DURATION + DIRECTION_FADE_HOLD_MS) {
+            // Fade duration reached - hold 100% long enough for the render task to draw it
+            motion.directionFadeProgress = 1.0f;
+        } else {
+            // Fade complete - now apply direction change
+            motion.isMovingForward = !motion.isMovingForward;
+            motion.directionChangePending = false;
+            motion.directionFadeProgress = 0.0f;
+            motion.directionChangeDetectedTime = 0;
+        }
+        // During fade, don't process new direction changes
+        return;
+    }
+
+    // Check if direction change is needed
+    bool needsChange = (motion.isMovingForward && desiredBackward) || (!motion.isMovingForward && desiredForward);
+
+    if (needsChange) {
+        if (motion.directionChangeDetectedTime == 0) {
+            // Start tracking sustained direction change
+            motion.directionChangeDetectedTime = nowMs;
+        } else if (nowMs - motion.directionChangeDetectedTime >= DIRECTION_SUSTAIN_TIME) {
+            // Direction has been sustained long enough - start fade transition
+            motion.directionChangePending = true;
+            motion.directionFadeStartTime = nowMs;
+            motion.directionFadeProgress = 0.0f;
+        }
+    } else {
+        // Direction matches current state - reset detection timer
+        motion.directionChangeDetectedTime = 0;
+    }
+}
+
+float calibratedForward(const CalibrationData& calibration, float x, float y, float z) {
+    if (!calibration.valid) return x;
+
+    switch (calibration.forwardAxis) {
+        case 'X': return x * calibration.forwardSign;
+        case 'Y': return y * calibration.forwardSign;
+        case 'Z': return z * calibration.forwardSign;
+        default: return x;
+    }
+}
+
+float calibratedLeftRight(const CalibrationData& calibration, float x, float y, float z) {
+    if (!calibration.valid) return y;
+
+    switch (calibration.leftRightAxis) {
+        case 'X': return x * calibration.leftRightSign;
+        case 'Y': return y * calibration.leftRightSign;
+        case 'Z': return z * calibration.leftRightSign;
+        default: return y;
+    }
+}
+
+float getCalibratedForwardAccel(const CalibrationData& calibration, const MotionData& data) {
+    return calibratedForward(calibration, data.accelX, data.accelY, data.accelZ);
+}
+
+float getCalibratedLeftRightAccel(const CalibrationData& calibration, const MotionData& data) {
+    return calibratedLeftRight(calibration, data.accelX, data.accelY, data.accelZ);
+}
+
+float getCalibratedForwardMotion(const CalibrationData& calibration, const MotionData& data) {
+    return calibratedForward(calibration, data.accelX - data.gravityX, data.accelY - data.gravityY,
+                             data.accelZ - data.gravityZ);
+}
+
+float getCalibratedLeanAngle(const CalibrationData& calibration, const MotionData& data) {
+    float lateral = calibratedLeftRight(calibration, data.gravityX, data.gravityY, data.gravityZ);
+    if (lateral > 1.0f) lateral = 1.0f;
+    if (lateral < -1.0f) lateral = -1.0f;
+    return asinf(lateral) * MOTION_RAD_TO_DEG;
+}
@@ -0,0 +1,178 @@
+#ifndef ARK_MOTION_H
+#define ARK_MOTION_H
+
+// Motion detectors - direction, braking, blinkers, park mode and impact,
+// fed one IMU sample at a time. Everything they read is passed in (config,
+// calibration, sample time) and everything they decide lands in
+// MotionDetectors, so the firmware runs them on live samples and the host
+// replays recorded rides through exactly the same code.
+
+#include <stdint.h>
+
+#include "ArkAttitude.h"
+
+// MPU6050 scale at the ranges the firmware configures (+-8G so crash peaks
+// don't clip, +-500 deg/s)
+#define MOTION_ACCEL_LSB_PER_G 4096.0f
+#define MOTION_GYRO_LSB_PER_DPS 65.5f
+
+// Braking - forward deceleration (gravity removed) through a short low-pass,
+// plus its rate of change (jerk). The latency budget caps the time from the
+// deceleration reaching the threshold to the brake light: the onset is dated
+// when the filtered deceleration passes BRAKING_DECIDE_FRACTION of the
+// threshold, backdated by the filter delay, and once the budget is up the
+// brakes light on the first sample past the full threshold. A hard onset
+// (jerk) that is past the threshold for BRAKING_MIN_HOLD_MS lights earlier.
+// The onset timer only restarts once the deceleration has mostly gone, so
+// road noise can't keep resetting it.
+#define BRAKING_FILTER_ALPHA 0.75f      // Low-pass per 200Hz sample (~15ms time constant)
+#define BRAKING_JERK_ALPHA 0.85f        // Low-pass per sample on jerk (~30ms)
+#define BRAKING_JERK_ONSET -4.0f        // G/s - a braking onset at least this sharp confirms early
+#define BRAKING_MIN_HOLD_MS 40          // Shortest hold even when confirmed (rejects ruts and dips)
+#define BRAKING_ARM_FRACTION 0.5f       // Onset timer runs while deceleration is past this share of the threshold
+#define BRAKING_DECIDE_FRACTION 0.8f    // Onset is dated when deceleration passes this share of the threshold
+#define BRAKING_SPIKE_G 1.5f            // Samples this far from gravity are bumps, not braking - skipped
+#define BRAKING_DEFAULT_LATENCY_MS 100  // Latency budget: longest time from threshold to brake light
+#define BRAKING_MIN_LATENCY_MS 80       // Shorter budgets decide before a 30ms rut has died away
+#define BRAKING_MAX_LATENCY_MS 500
+#define DIRECTION_SUSTAIN_TIME 500      // ms direction must be sustained before switching
+#define DIRECTION_FADE_DURATION 1500    // ms for smooth fade transition (needs to be visible)
+#define DIRECTION_FADE_HOLD_MS 100      // 100% is held this long after the fade - one frame at the slowest frame rate (10 fps)
+#define DIRECTION_FILTER_ALPHA 0.965f   // Low-pass coefficient per 200Hz sample (higher = more filtering; ~140ms)
+#define BLINKER_LEAN_ANGLE 15.0f        // Lean (degrees) that triggers a blinker at sensitivity 1.0
+#define BLINKER_TURN_RATE 10.0f         // deg/s of yaw that counts as turning (lean then comes from the gyro)
+#define BLINKER_LEAN_SETTLE_MS 500      // Gyro lean settles onto the fused lean this fast outside turns
+#define BLINKER_TURN_SETTLE_MS 30000    // ...and this slowly while turning, so drift can't build up
+#define IMPACT_PEAK_WINDOW_MS 50        // Peak G is tracked this long after an impact triggers
+#define IMPACT_LOCKOUT_MS 1000          // One impact per second at most
+
+// One MPU6050 FIFO record in raw sensor counts
+struct MotionSample {
+    uint32_t timeUs;    // micros() when the sensor took it (reconstructed from the read time)
+    int16_t ax, ay, az;
+    int16_t gx, gy, gz;
+};
+
+// One sample in physical units, with the fused attitude
+struct MotionData {
+    float pitch, roll, yaw;             // Fused attitude (degrees); yaw is heading since boot
+    float accelX, accelY, accelZ;       // G
+    float gyroX, gyroY, gyroZ;          // deg/s
+    float gravityX, gravityY, gravityZ; // Fused gravity direction (G) - accel minus this is motion
+};
+
+// Mounting orientation captured by the calibration steps
+struct CalibrationData {
+    float levelAccelX, levelAccelY, levelAccelZ;
+    float forwardAccelX, forwardAccelY, forwardAccelZ;
+    float backwardAccelX, backwardAccelY, backwardAccelZ;
+    float leftAccelX, leftAccelY, leftAccelZ;
+    float rightAccelX, rightAccelY, rightAccelZ;
+    char forwardAxis = 'X';
+    char leftRightAxis = 'Y';
+    int forwardSign = 1;
+    int leftRightSign = 1;
+    bool valid = false;
+};
+
+// Detector settings (user settings in the firmware, log header or command
+// line in the replay harness)
+struct MotionConfig {
+    bool directionBasedLighting = false;
+    bool brakingEnabled = false;
+    bool blinkerEnabled = true;
+    bool parkModeEnabled = true;
+    bool impactDetectionEnabled = true;
+    float forwardAccelThreshold = 0.3f;     // G-force threshold for direction change
+    float brakingThreshold = -0.5f;         // G-force deceleration threshold (negative = deceleration)
+    uint16_t brakingLatencyMs = BRAKING_DEFAULT_LATENCY_MS;  // Longest time from threshold to brake light
+    float motionSensitivity = 1.0f;         // 0.5 to 2.0 - blinker lean threshold is BLINKER_LEAN_ANGLE x this
+    uint16_t blinkerTimeout = 2000;         // ms before turning off blinker
+    float parkAccelNoiseThreshold = 0.05f;  // G deviation from gravity that still counts as stationary
+    float parkGyroNoiseThreshold = 2.5f;    // deg/s that still counts as stationary
+    uint16_t parkStationaryTime = 2000;     // ms of stationary time before park mode activates
+    uint8_t impactThreshold = 3;            // G-force threshold for impact detection
+    uint16_t sampleRateHz = 200;            // Sample rate the detectors are fed at (jerk scale)
+    CalibrationData calibration;
+};
+
+// Detector state. Times are milliseconds on the caller's clock (millis() in
+// the firmware, log time in the replay harness).
+struct MotionDetectors {
+    AttitudeFilter attitude;
+
+    // Direction detection
+    bool isMovingForward = true;            // true = forward, false = backward
+    bool directionChangePending = false;    // Direction change detected but not yet applied
+    float directionFadeProgress = 0.0f;     // 0.0 to 1.0 for fade transition
+    uint32_t directionChangeDetectedTime = 0;
+    uint32_t directionFadeStartTime = 0;
+    float filteredForwardAccel = 0.0f;
+
+    // Braking
+    bool brakingActive = false;
+    bool manualBrakeActive = false;         // API override - detection paused
+    uint32_t brakingDetectedTime = 0;       // Deceleration passed BRAKING_DECIDE_FRACTION, filter delay removed (0 = not yet)
+    uint32_t brakingStartTime = 0;
+    float brakingFilteredAccel = 0.0f;      // G, forward (negative = decelerating)
+    float brakingJerk = 0.0f;               // G/s
+    bool brakingJerkConfirmed = false;      // Sharp onset seen since the deceleration began
+    float brakingGravityX = 0.0f, brakingGravityY = 0.0f, brakingGravityZ = 1.0f;  // Held while decelerating
+
+    // Blinkers
+    float leanAngle = 0.0f;                 // Degrees, integrated roll rate (see processBlinkers)
+    float leanRateBias = 0.0f;              // deg/s, gyro bias along the roll axis (held while turning)
+    bool blinkerActive = false;
+    int8_t blinkerDirection = 0;            // -1 = left, 1 = right, 0 = none
+    bool manualBlinkerActive = false;       // API override - detection paused
+    uint32_t blinkerStartTime = 0;
+
+    // Park mode
+    bool parkModeActive = false;
+    uint32_t parkStartTime = 0;
+
+    // Impact
+    uint32_t lastImpactTime = 0;
+    uint32_t impactCount = 0;               // Bumped per impact; the render task flashes on change
+    float lastImpactG = 0.0f;               // Peak so far (final at MOTION_EVENT_IMPACT_PEAK)
+    bool impactPeakPending = false;
+};
+
+// What a sample changed (returned by motionDetect)
+#define MOTION_EVENT_BRAKE_ON (1 << 0)
+#define MOTION_EVENT_BRAKE_OFF (1 << 1)
+#define MOTION_EVENT_BLINKER_ON (1 << 2)
+#define MOTION_EVENT_BLINKER_OFF (1 << 3)
+#define MOTION_EVENT_PARK_ON (1 << 4)
+#define MOTION_EVENT_PARK_OFF (1 << 5)
+#define MOTION_EVENT_IMPACT (1 << 6)
+#define MOTION_EVENT_DIRECTION_FADE (1 << 7)    // Direction change confirmed, fade started
+#define MOTION_EVENT_DIRECTION (1 << 8)         // Fade finished, isMovingForward flipped
+#define MOTION_EVENT_IMPACT_PEAK (1 << 9)       // Impact peak window closed, lastImpactG is final
+
+// Convert a raw sample (after feeding it to the attitude filter, dt seconds
+// after the previous one) into physical units with the fused attitude
+MotionData motionFuseSample(AttitudeFilter& attitude, const MotionSample& sample, float dt);
+
+// Run the enabled detectors on one sample; returns MOTION_EVENT_* bits
+uint16_t motionDetect(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+
+// Individual detectors (motionDetect runs them in this order)
+void processDirectionDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+void processBrakingDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+void processBlinkers(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+void processParkMode(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+void processImpactDetection(MotionDetectors& motion, const MotionConfig& config, const MotionData& data, uint32_t nowMs);
+
+// Any sensor-frame vector along the calibrated axes (X / Y uncalibrated)
+float calibratedForward(const CalibrationData& calibration, float x, float y, float z);
+float calibratedLeftRight(const CalibrationData& calibration, float x, float y, float z);
+
+float getCalibratedForwardAccel(const CalibrationData& calibration, const MotionData& data);
+float getCalibratedLeftRightAccel(const CalibrationData& calibration, const MotionData& data);
+// Forward acceleration with gravity removed (G)
+float getCalibratedForwardMotion(const CalibrationData& calibration, const MotionData& data);
+// Lean angle (degrees) from the fused gravity direction along the left/right axis
+float getCalibratedLeanAngle(const CalibrationData& calibration, const MotionData& data);
+
+#endif // ARK_MOTION_H
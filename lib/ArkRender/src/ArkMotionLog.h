@@ -0,0 +1,80 @@
+#ifndef ARK_MOTION_LOG_H
+#define ARK_MOTION_LOG_H
+
+// Ride log - raw IMU samples as the detectors saw them, for replaying rides
+// through the same detector code on the host. A header (with the detector
+// settings in force when recording started) is followed by fixed-size
+// records in sample order. Little-endian, as written by the ESP32.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ArkMotion.h"
+
+#define MOTION_LOG_MAGIC "AIMU"
+#define MOTION_LOG_VERSION 2            // 2: accel at +-8G (MOTION_ACCEL_LSB_PER_G)
+
+struct MotionLogHeader {
+    char magic[4];              // MOTION_LOG_MAGIC
+    uint16_t version;           // MOTION_LOG_VERSION
+    uint16_t sampleRateHz;      // Sensor rate the detectors were tuned at
+    uint16_t configBytes;       // sizeof(MotionConfig) on the recorder (must match to reuse config)
+    uint16_t reserved;
+    uint32_t startMs;           // millis() of the first sample
+    MotionConfig config;
+};
+
+// One sample: time since the previous one plus the raw FIFO counts
+struct MotionLogRecord {
+    uint16_t deltaUs;           // Saturates at 65535 (gaps longer than that are rare and only shift time)
+    int16_t ax, ay, az;
+    int16_t gx, gy, gz;
+};
+static_assert(sizeof(MotionLogRecord) == 14, "MotionLogRecord must stay packed at 14 bytes");
+
+inline void motionLogInitHeader(MotionLogHeader& header, uint16_t sampleRateHz, uint32_t startMs,
+                                const MotionConfig& config) {
+    memset((void*)&header, 0, sizeof(header));  // Padding too - the header is written byte for byte
+    memcpy(header.magic, MOTION_LOG_MAGIC, sizeof(header.magic));
+    header.version = MOTION_LOG_VERSION;
+    header.sampleRateHz = sampleRateHz;
+    header.configBytes = sizeof(MotionConfig);
+    header.startMs = startMs;
+    header.config = config;
+}
+
+inline bool motionLogHeaderValid(const MotionLogHeader& header) {
+    return memcmp(header.magic, MOTION_LOG_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == MOTION_LOG_VERSION && header.sampleRateHz > 0;
+}
+
+// previousUs is the timeUs of the previous record's sample (updated here)
+inline MotionLogRecord motionLogEncode(const MotionSample& sample, uint32_t& previousUs) {
+    uint32_t delta = sample.timeUs - previousUs;
+    previousUs = sample.timeUs;
+    MotionLogRecord record;
+    record.deltaUs = delta > 0xFFFF ? 0xFFFF : (uint16_t)delta;
+    record.ax = sample.ax;
+    record.ay = sample.ay;
+    record.az = sample.az;
+    record.gx = sample.gx;
+    record.gy = sample.gy;
+    record.gz = sample.gz;
+    return record;
+}
+
+// timeUs is the running sample time (advanced here)
+inline MotionSample motionLogDecode(const MotionLogRecord& record, uint32_t& timeUs) {
+    timeUs += record.deltaUs;
+    MotionSample sample;
+    sample.timeUs = timeUs;
+    sample.ax = record.ax;
+    sample.ay = record.ay;
+    sample.az = record.az;
+    sample.gx = record.gx;
+    sample.gy = record.gy;
+    sample.gz = record.gz;
+    return sample;
+}
+
+#endif // ARK_MOTION_LOG_H
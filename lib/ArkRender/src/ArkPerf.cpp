@@ -0,0 +1,52 @@
+// Stage profiler
+
+#include "ArkPerf.h"
+
+PerfStats* perfEffectStats = nullptr;
+PerfStats* perfBlendStats = nullptr;
+
+// Bucket = octave (position of the top bit) and the next PERF_SUB_BUCKET_BITS
+// bits below it. Values below 2^PERF_SUB_BUCKET_BITS get a bucket each.
+static inline uint8_t perfBucket(uint32_t cycles) {
+    if (cycles < (1u << PERF_SUB_BUCKET_BITS)) return (uint8_t)cycles;
+    uint8_t top = 31 - __builtin_clz(cycles);
+    uint8_t sub = (cycles >> (top - PERF_SUB_BUCKET_BITS)) & ((1u << PERF_SUB_BUCKET_BITS) - 1);
+    return (uint8_t)(((top - PERF_SUB_BUCKET_BITS + 1) << PERF_SUB_BUCKET_BITS) | sub);
+}
+
+// Largest value that falls into a bucket
+static uint32_t perfBucketUpperBound(uint8_t bucket) {
+    if (bucket < (1u << PERF_SUB_BUCKET_BITS)) return bucket;
+    uint8_t top = (bucket >> PERF_SUB_BUCKET_BITS) + PERF_SUB_BUCKET_BITS - 1;
+    uint32_t sub = bucket & ((1u << PERF_SUB_BUCKET_BITS) - 1);
+    uint64_t width = 1ull << (top - PERF_SUB_BUCKET_BITS);
+    uint64_t upper = (1ull << top) + (sub + 1) * width - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+}
+
+void perfRecord(PerfStats& stats, uint32_t cycles) {
+    if (stats.resetPending) {
+        stats = PerfStats();
+    }
+    stats.counts[perfBucket(cycles)]++;
+    stats.samples++;
+    stats.totalCycles += cycles;
+    if (cycles < stats.minCycles) stats.minCycles = cycles;
+    if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+}
+
+uint32_t perfPercentile(const PerfStats& stats, uint8_t percent) {
+    if (stats.samples == 0) return 0;
+    uint64_t rank = ((uint64_t)stats.samples * percent + 99) / 100;
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+        seen += stats.counts[b];
+        if (seen >= rank) {
+            uint32_t bound = perfBucketUpperBound(b);
+            return bound < stats.maxCycles ? bound : stats.maxCycles;
+        }
+    }
+    return stats.maxCycles;
+}
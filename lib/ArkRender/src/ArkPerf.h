@@ -0,0 +1,76 @@
+#ifndef ARK_PERF_H
+#define ARK_PERF_H
+
+// Stage profiler - CPU cycle counts per firmware stage (motion, effects,
+// show, HTTP, ...) aggregated into fixed-size stats: min/avg/max plus a
+// log-scale histogram for percentiles. Recording a sample is a cycle-counter
+// read, a count-leading-zeros and a handful of adds, so it stays enabled in
+// release builds.
+//
+// Each stage has a single writer (the task that runs it); readers on other
+// cores may see a sample half-applied, which only skews a report by one
+// sample. Resets are requested by the reader and applied by the writer on
+// its next sample.
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+// CPU cycles on the calling core (wraps every 2^32 cycles, ~18s at 240MHz)
+inline uint32_t perfCycles() {
+    return ESP.getCycleCount();
+}
+
+#else // Host build: nanoseconds stand in for cycles
+
+#include <chrono>
+
+inline uint32_t perfCycles() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
+
+// Four buckets per power of two: percentiles are within 19% of the real value
+#define PERF_SUB_BUCKET_BITS 2
+#define PERF_BUCKETS (32 << PERF_SUB_BUCKET_BITS)
+
+struct PerfStats {
+    uint32_t counts[PERF_BUCKETS] = {};
+    uint32_t samples = 0;
+    uint32_t minCycles = UINT32_MAX;
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+    volatile bool resetPending = false;
+};
+
+void perfRecord(PerfStats& stats, uint32_t cycles);
+
+inline uint32_t perfMeanCycles(const PerfStats& stats) {
+    return stats.samples > 0 ? (uint32_t)(stats.totalCycles / stats.samples) : 0;
+}
+
+// Upper bound of the bucket holding the given percentile (0-100), capped at
+// the largest sample seen. 0 while there are no samples.
+uint32_t perfPercentile(const PerfStats& stats, uint8_t percent);
+
+// Ask the stage's writer to clear its stats before its next sample
+inline void perfRequestReset(PerfStats& stats) {
+    stats.resetPending = true;
+}
+
+// Times the enclosing scope into a stage
+struct PerfScope {
+    PerfStats& stats;
+    uint32_t start;
+    explicit PerfScope(PerfStats& s) : stats(s), start(perfCycles()) {}
+    ~PerfScope() { perfRecord(stats, perfCycles() - start); }
+};
+
+// Render engine stages, recorded when the firmware points them at its stats
+extern PerfStats* perfEffectStats;      // applyEffectToArray
+extern PerfStats* perfBlendStats;       // blendLEDArrays
+
+#endif // ARK_PERF_H
@@ -0,0 +1,163 @@
+#ifndef ARK_PIXEL_H
+#define ARK_PIXEL_H
+
+// Pixel primitives for the render engine.
+// On the device this is just FastLED. On the host (PlatformIO `native` env)
+// it provides the small subset of FastLED the effects use, so the render
+// path can be built and benchmarked without Arduino or hardware.
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+inline long arkMap(long x, long inMin, long inMax, long outMin, long outMax) {
+    return map(x, inMin, inMax, outMin, outMax);
+}
+
+inline long arkRandom(long hi) {
+    return random(hi);
+}
+
+inline long arkRandom(long lo, long hi) {
+    return random(lo, hi);
+}
+
+#else // Host build
+
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef uint8_t fract8;
+
+struct CHSV {
+    union {
+        struct {
+            union { uint8_t hue; uint8_t h; };
+            union { uint8_t saturation; uint8_t sat; uint8_t s; };
+            union { uint8_t value; uint8_t val; uint8_t v; };
+        };
+        uint8_t raw[3];
+    };
+
+    inline CHSV() = default;
+    constexpr CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    // Subset of FastLED's HTML color codes used by the firmware
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    };
+
+    inline CRGB() = default;
+    constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    constexpr CRGB(uint32_t colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    constexpr CRGB(HTMLColorCode colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    inline CRGB(const CHSV& hsv) { hsv2rgb_rainbow(hsv, *this); }
+
+    inline CRGB& operator=(const CHSV& hsv) {
+        hsv2rgb_rainbow(hsv, *this);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scaledown);
+};
+
+inline bool operator==(const CRGB& lhs, const CRGB& rhs) {
+    return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+
+inline bool operator!=(const CRGB& lhs, const CRGB& rhs) {
+    return !(lhs == rhs);
+}
+
+// lib8tion math (same results as FastLED's portable C versions)
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return (((uint16_t)i) * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : t;
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (a << 8) | b;
+    partial += (b * amountOfB);
+    partial -= (a * amountOfB);
+    return partial >> 8;
+}
+
+uint8_t sin8(uint8_t theta);
+uint8_t random8();
+uint16_t random16();
+void random16_set_seed(uint16_t seed);
+
+CRGB HeatColor(uint8_t temperature);
+CHSV rgb2hsv_approximate(const CRGB& rgb);
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color);
+void fill_rainbow(CRGB* leds, int numToFill, uint8_t initialHue, uint8_t deltaHue = 5);
+
+// Arduino helpers
+long arkMap(long x, long inMin, long inMax, long outMin, long outMax);
+long arkRandom(long lo, long hi);
+
+inline long arkRandom(long hi) {
+    return arkRandom(0, hi);
+}
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+template <typename T>
+inline T min(T a, T b) {
+    return a < b ? a : b;
+}
+
+template <typename T>
+inline T max(T a, T b) {
+    return a > b ? a : b;
+}
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+#endif // ARDUINO
+
+#endif // ARK_PIXEL_H
@@ -0,0 +1,219 @@
+// Host implementations of the FastLED subset declared in ArkPixel.h.
+// Only compiled for the `native` environment; the device uses FastLED itself.
+
+#ifndef ARDUINO
+
+#include "ArkPixel.h"
+
+static uint16_t rand16seed = 1337;
+
+CRGB& CRGB::nscale8(uint8_t scaledown) {
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return *this;
+}
+
+uint8_t sin8(uint8_t theta) {
+    static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = (uint8_t)255 - offset;
+    }
+    offset &= 0x3F; // 0..63
+
+    uint8_t secoffset = offset & 0x0F; // 0..15
+    if (theta & 0x40) {
+        ++secoffset;
+    }
+
+    uint8_t section = offset >> 4; // 0..3
+    const uint8_t* p = b_m16_interleave + (section * 2);
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+
+    uint8_t mx = (m16 * secoffset) >> 4;
+    int8_t y = mx + b;
+    if (theta & 0x80) {
+        y = -y;
+    }
+    y += 128;
+    return y;
+}
+
+uint8_t random8() {
+    rand16seed = (rand16seed * 2053) + 13849;
+    return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8)));
+}
+
+uint16_t random16() {
+    rand16seed = (rand16seed * 2053) + 13849;
+    return rand16seed;
+}
+
+void random16_set_seed(uint16_t seed) {
+    rand16seed = seed;
+}
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    const uint8_t K255 = 255;
+    const uint8_t K171 = 171;
+    const uint8_t K170 = 170;
+    const uint8_t K85 = 85;
+
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset8 = (hue & 0x1F) << 3; // 0..248
+    uint8_t third = scale8(offset8, (256 / 3)); // max = 85
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                // R -> O
+                r = K255 - third; g = third; b = 0;
+            } else {
+                // O -> Y
+                r = K171; g = K85 + third; b = 0;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                // Y -> G
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); // max = 170
+                r = K171 - twothirds; g = K170 + third; b = 0;
+            } else {
+                // G -> A
+                r = 0; g = K255 - third; b = third;
+            }
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                // A -> B
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); // max = 170
+                r = 0; g = K171 - twothirds; b = K85 + twothirds;
+            } else {
+                // B -> P
+                r = third; g = 0; b = K255 - third;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                // P -> K
+                r = K85 + third; g = 0; b = K171 - third;
+            } else {
+                // K -> R
+                r = K170 + third; g = 0; b = K85 - third;
+            }
+        }
+    }
+
+    // Desaturate and add the brightness floor
+    if (sat != 255) {
+        if (sat == 0) {
+            r = 255; g = 255; b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale) + desat;
+            g = scale8(g, satscale) + desat;
+            b = scale8(b, satscale) + desat;
+        }
+    }
+
+    // Scale down for value < 255
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = 0; g = 0; b = 0;
+        } else {
+            r = scale8(r, val);
+            g = scale8(g, val);
+            b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+// Integer RGB -> HSV. Close to FastLED's rgb2hsv_approximate, not bit-exact;
+// good enough for the host build where only render cost matters.
+CHSV rgb2hsv_approximate(const CRGB& rgb) {
+    uint8_t maxc = rgb.r > rgb.g ? (rgb.r > rgb.b ? rgb.r : rgb.b) : (rgb.g > rgb.b ? rgb.g : rgb.b);
+    uint8_t minc = rgb.r < rgb.g ? (rgb.r < rgb.b ? rgb.r : rgb.b) : (rgb.g < rgb.b ? rgb.g : rgb.b);
+    uint8_t delta = maxc - minc;
+
+    if (maxc == 0) {
+        return CHSV(0, 0, 0);
+    }
+
+    uint8_t sat = (uint16_t)delta * 255 / maxc;
+    if (delta == 0) {
+        return CHSV(0, 0, maxc);
+    }
+
+    int16_t hue;
+    if (maxc == rgb.r) {
+        hue = 0 + 43 * ((int16_t)rgb.g - rgb.b) / delta;
+    } else if (maxc == rgb.g) {
+        hue = 85 + 43 * ((int16_t)rgb.b - rgb.r) / delta;
+    } else {
+        hue = 171 + 43 * ((int16_t)rgb.r - rgb.g) / delta;
+    }
+
+    return CHSV((uint8_t)hue, sat, maxc);
+}
+
+CRGB HeatColor(uint8_t temperature) {
+    CRGB heatcolor;
+
+    // Scale 'heat' down from 0-255 to 0-191
+    uint8_t t192 = scale8_video(temperature, 191);
+    uint8_t heatramp = (t192 & 0x3F) << 2;
+
+    if (t192 & 0x80) {
+        heatcolor.r = 255; heatcolor.g = 255; heatcolor.b = heatramp;
+    } else if (t192 & 0x40) {
+        heatcolor.r = 255; heatcolor.g = heatramp; heatcolor.b = 0;
+    } else {
+        heatcolor.r = heatramp; heatcolor.g = 0; heatcolor.b = 0;
+    }
+
+    return heatcolor;
+}
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+    for (int i = 0; i < numToFill; i++) {
+        leds[i] = color;
+    }
+}
+
+void fill_rainbow(CRGB* leds, int numToFill, uint8_t initialHue, uint8_t deltaHue) {
+    CHSV hsv(initialHue, 240, 255);
+    for (int i = 0; i < numToFill; i++) {
+        leds[i] = hsv;
+        hsv.hue += deltaHue;
+    }
+}
+
+long arkMap(long x, long inMin, long inMax, long outMin, long outMax) {
+    const long run = inMax - inMin;
+    if (run == 0) {
+        return -1; // Matches the ESP32 core's behaviour for an empty input range
+    }
+    return ((x - inMin) * (outMax - outMin)) / run + outMin;
+}
+
+long arkRandom(long lo, long hi) {
+    if (lo >= hi) {
+        return lo;
+    }
+    return lo + (long)(((uint32_t)random16() << 16 | random16()) % (uint32_t)(hi - lo));
+}
+
+#endif // ARDUINO
@@ -0,0 +1,896 @@
+// ArkLights render engine - effect rendering, blending and color order handling
+// No Arduino or hardware dependencies beyond what ArkPixel.h provides.
+
+#include "ArkRender.h"
+#include "ArkPerf.h"
+
+#include <math.h>
+#include <string.h>
+
+bool effectBackgroundEnabled = false;
+CRGB effectBackgroundColor = CRGB::Black;
+
+const char* getEffectName(uint8_t effect) {
+    const EffectDescriptor* fx = getEffectDescriptor(effect);
+    return fx != nullptr ? fx->name : "Unknown";
+}
+
+// Helper function to get effect-specific speed multiplier
+// With the new consistent frame rate system, multipliers are reduced since speed control works better
+uint8_t getEffectSpeedMultiplier(uint8_t effect) {
+    const EffectDescriptor* fx = getEffectDescriptor(effect);
+    return fx != nullptr ? fx->speedMultiplier : 1;
+}
+
+// Speed 0 = 0.1 steps per frame, speed 255 = 8 steps per frame at the nominal
+// FRAMETIME_FIXED frame time, expressed per second so it holds at any frame rate
+uint32_t effectStepRate(uint8_t speed) {
+    uint32_t centiStepsPerFrame = arkMap(speed, 0, 255, 10, 800);
+    return centiStepsPerFrame * 1000 / FRAMETIME_FIXED;
+}
+
+void effectClockAdvance(EffectTiming& timing, uint32_t nowUs, uint8_t speed) {
+    uint32_t elapsedUs = nowUs - timing.lastFrameUs; // Wraps cleanly with micros()
+    timing.lastFrameUs = nowUs;
+    if (elapsedUs > EFFECT_CLOCK_MAX_DELTA_US) {
+        elapsedUs = EFFECT_CLOCK_MAX_DELTA_US;
+    }
+
+    // 1/100 steps per second * microseconds -> 16.16 steps
+    uint64_t advance = ((uint64_t)elapsedUs * effectStepRate(speed) << 16) / 100000000ULL;
+    timing.phase += (uint32_t)advance;
+    timing.step = timing.phase >> 16;
+}
+
+// Blend four packed 8-bit channels at once: two lanes of 0x00FF00FF per pass.
+// weight is in 1/256ths of b (0 = all a, 256 = all b); each lane peaks at
+// 255 * 256, so lanes never carry into each other.
+static inline uint32_t blendPackedWord(uint32_t a, uint32_t b, uint16_t weight) {
+    uint16_t inverse = 256 - weight;
+    uint32_t lo = (((a & 0x00FF00FF) * inverse + (b & 0x00FF00FF) * weight) >> 8) & 0x00FF00FF;
+    uint32_t hi = (((a >> 8) & 0x00FF00FF) * inverse + ((b >> 8) & 0x00FF00FF) * weight) & 0xFF00FF00;
+    return lo | hi;
+}
+
+// Fixed-point kernel: the CRGB arrays are treated as a flat byte stream and
+// blended one 32-bit word (4 channels) at a time.
+static void blendLEDArraysUntimed(CRGB* target, const CRGB* source1, const CRGB* source2, uint16_t numLeds, uint16_t fade256) {
+    size_t bytes = (size_t)numLeds * sizeof(CRGB);
+    if (fade256 == 0) {
+        memmove(target, source1, bytes);
+        return;
+    }
+    if (fade256 >= 256) {
+        memmove(target, source2, bytes);
+        return;
+    }
+
+    uint8_t* out = reinterpret_cast<uint8_t*>(target);
+    const uint8_t* in1 = reinterpret_cast<const uint8_t*>(source1);
+    const uint8_t* in2 = reinterpret_cast<const uint8_t*>(source2);
+    size_t i = 0;
+
+    // Word loop needs 4-byte alignment (unaligned 32-bit loads fault on Xtensa)
+    if ((((uintptr_t)out | (uintptr_t)in1 | (uintptr_t)in2) & 3) == 0) {
+        uint32_t* out32 = reinterpret_cast<uint32_t*>(out);
+        const uint32_t* in1w = reinterpret_cast<const uint32_t*>(in1);
+        const uint32_t* in2w = reinterpret_cast<const uint32_t*>(in2);
+        size_t words = bytes / 4;
+        for (size_t w = 0; w < words; w++) {
+            out32[w] = blendPackedWord(in1w[w], in2w[w], fade256);
+        }
+        i = words * 4;
+    }
+
+    uint16_t inverse = 256 - fade256;
+    for (; i < bytes; i++) {
+        out[i] = (in1[i] * inverse + in2[i] * fade256) >> 8;
+    }
+}
+
+// Helper function to blend two LED arrays with fade progress
+void blendLEDArrays(CRGB* target, const CRGB* source1, const CRGB* source2, uint16_t numLeds, uint16_t fade256) {
+    uint32_t perfStart = perfBlendStats != nullptr ? perfCycles() : 0;
+    blendLEDArraysUntimed(target, source1, source2, numLeds, fade256);
+    if (perfBlendStats != nullptr) perfRecord(*perfBlendStats, perfCycles() - perfStart);
+}
+
+// Helper function to apply effect to LED array
+void applyEffectToArray(CRGB* leds, uint16_t numLeds, uint8_t effect, CRGB color, EffectTiming& timing, CRGB backgroundColor, bool backgroundEnabled) {
+    const EffectDescriptor* fx = getEffectDescriptor(effect);
+    if (fx == nullptr || numLeds == 0) {
+        return;
+    }
+
+    uint8_t* state = nullptr;
+    if (fx->stateFixed > 0 || fx->statePerLed > 0) {
+        EffectState& instance = timing.state;
+        uint16_t needed = fx->stateFixed + (uint16_t)fx->statePerLed * numLeds;
+        if (instance.data == nullptr || needed > instance.capacity) {
+            // No room for this effect's state - stay dark rather than write past the pool
+            fill_solid(leds, numLeds, CRGB::Black);
+            return;
+        }
+        if (instance.effect != effect) {
+            // Effect just started on this strip - don't inherit the previous effect's state
+            memset(instance.data, 0, instance.capacity);
+            instance.effect = effect;
+        }
+        state = instance.data;
+    }
+
+    effectBackgroundEnabled = backgroundEnabled;
+    effectBackgroundColor = backgroundColor;
+    if (perfEffectStats != nullptr) {
+        uint32_t start = perfCycles();
+        fx->render(leds, numLeds, color, timing.step, state);
+        perfRecord(*perfEffectStats, perfCycles() - start);
+    } else {
+        fx->render(leds, numLeds, color, timing.step, state);
+    }
+}
+
+uint16_t effectStateBytes(uint16_t numLeds) {
+    uint16_t bytes = 0;
+    for (uint8_t i = 0; i < FX_COUNT; i++) {
+        uint16_t needed = effectTable[i].stateFixed + (uint16_t)effectTable[i].statePerLed * numLeds;
+        if (needed > bytes) bytes = needed;
+    }
+    return (bytes + 3) & ~3; // Keep the next strip's region word aligned
+}
+
+void effectStateBind(EffectState& state, uint8_t* data, uint16_t capacity) {
+    state.data = data;
+    state.capacity = data != nullptr ? capacity : 0;
+    state.effect = FX_STATE_UNBOUND;
+}
+
+CRGB getEffectBackgroundColor() {
+    return effectBackgroundEnabled ? effectBackgroundColor : CRGB::Black;
+}
+
+CRGB mixColors(const CRGB& base, const CRGB& added) {
+    if (base.r == 0 && base.g == 0 && base.b == 0) {
+        return added;
+    }
+    if (added.r == 0 && added.g == 0 && added.b == 0) {
+        return base;
+    }
+
+    CHSV baseHsv = rgb2hsv_approximate(base);
+    CHSV addedHsv = rgb2hsv_approximate(added);
+
+    uint16_t valueSum = baseHsv.value + addedHsv.value;
+    uint8_t weight = valueSum > 0 ? static_cast<uint8_t>((addedHsv.value * 255) / valueSum) : 128;
+    uint8_t blendedHue = blend8(baseHsv.hue, addedHsv.hue, weight);
+    uint8_t blendedSat = max(baseHsv.sat, addedHsv.sat);
+    uint8_t blendedVal = max(baseHsv.val, addedHsv.val);
+
+    return CHSV(blendedHue, blendedSat, blendedVal);
+}
+
+// Static Rainbow Effect
+void effectStaticRainbow(CRGB* leds, uint16_t numLeds) {
+    // Static rainbow - no movement, just rainbow colors across the strip
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint8_t hue = (i * 255) / numLeds;
+        leds[i] = CHSV(hue, 255, 255);
+    }
+}
+
+// ============================================================================
+// IMPROVED EFFECT FUNCTIONS WITH CONSISTENT TIMING
+// ============================================================================
+
+// Improved Breath Effect with consistent timing
+void effectBreathImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step-based timing for consistent speed across different strip lengths
+    uint8_t breathPhase = (step * 2) % 256; // 0-255 cycle
+    uint8_t brightness = sin8(breathPhase);
+    
+    CRGB breathColor = color;
+    breathColor.nscale8(brightness);
+    fill_solid(leds, numLeds, breathColor);
+}
+
+// Improved Rainbow Effect with consistent timing
+void effectRainbowImproved(CRGB* leds, uint16_t numLeds, uint16_t step) {
+    // Use step-based timing for consistent rainbow speed
+    // Apply speed multiplier: faster base speed for rainbow (multiply step by multiplier)
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_RAINBOW);
+    uint16_t hueOffset = (step * multiplier) % 256; // Faster rainbow movement
+    
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint8_t hue = (hueOffset + (i * 256 / numLeds)) % 256;
+        leds[i] = CHSV(hue, 255, 255);
+    }
+}
+
+// Improved Chase Effect with consistent timing
+// PEV-Friendly: Improved Pulse Effect with consistent timing
+void effectPulseImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step for consistent timing across synced devices
+    uint8_t phase = (step * 4) % 256; // Smooth cycle
+    uint8_t brightness = sin8(phase);
+    
+    // Ensure minimum visibility
+    brightness = arkMap(brightness, 0, 255, 40, 255);
+    
+    CRGB pulseColor = color;
+    pulseColor.nscale8(brightness);
+    fill_solid(leds, numLeds, pulseColor);
+}
+
+// Improved Blink Rainbow Effect with consistent timing
+void effectBlinkRainbowImproved(CRGB* leds, uint16_t numLeds, uint16_t step) {
+    // Blink every 20 steps (adjustable)
+    bool blinkState = (step / 20) % 2;
+    if (blinkState) {
+        effectRainbowImproved(leds, numLeds, step);
+    } else {
+        fill_solid(leds, numLeds, getEffectBackgroundColor());
+    }
+}
+
+// Improved Twinkle Effect with consistent timing
+// PEV-Friendly: Improved Gradient Shift Effect with consistent timing
+void effectGradientShiftImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step for consistent timing across synced devices
+    uint8_t phase = (step * 2) % 256;
+    
+    for (uint16_t i = 0; i < numLeds; i++) {
+        // Create smooth gradient across the strip
+        uint8_t position = (i * 256 / numLeds + phase) % 256;
+        
+        // Vary brightness smoothly across the strip
+        uint8_t brightness = sin8(position);
+        brightness = arkMap(brightness, 0, 255, 60, 255); // Minimum 60 brightness
+        
+        CRGB gradientColor = color;
+        gradientColor.nscale8(brightness);
+        leds[i] = gradientColor;
+    }
+}
+
+// Improved Fire Effect with consistent timing
+void effectFireImproved(CRGB* leds, uint16_t numLeds, uint16_t step, uint8_t* heat) {
+    // Use step for consistent fire behavior
+    uint8_t cooling = 50 + (step % 50);
+    uint8_t sparking = 50 + (step % 70);
+    
+    // Cool down every cell a little
+    for (uint16_t i = 0; i < numLeds; i++) {
+        heat[i] = qsub8(heat[i], arkRandom(0, ((cooling * 10) / numLeds) + 2));
+    }
+    
+    // Heat from each cell drifts 'up' and diffuses a little
+    for (uint16_t k = numLeds - 1; k >= 2; k--) {
+        heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
+    }
+    
+    // Randomly ignite new 'sparks' near the bottom
+    if (arkRandom(255) < sparking) {
+        uint8_t y = arkRandom(7);
+        if (y < numLeds) {
+            heat[y] = qadd8(heat[y], arkRandom(160, 255));
+        }
+    }
+    
+    // Convert heat to LED colors
+    for (uint16_t j = 0; j < numLeds; j++) {
+        CRGB color = HeatColor(heat[j]);
+        leds[j] = color;
+    }
+}
+
+// Improved Meteor Effect with consistent timing
+void effectMeteorImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Fade all LEDs
+    for (uint16_t i = 0; i < numLeds; i++) {
+        leds[i].nscale8(192); // Fade by 25%
+    }
+    
+    // Apply speed multiplier for faster movement
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_METEOR);
+    // Use step for consistent meteor movement
+    uint8_t meteorSize = 3 + (step % 3);
+    uint16_t meteorPos = ((step * multiplier) / 2) % (numLeds + meteorSize);
+    
+    // Draw meteor
+    for (uint8_t i = 0; i < meteorSize; i++) {
+        if (meteorPos - i >= 0 && meteorPos - i < numLeds) {
+            uint8_t brightness = 255 - (i * 255 / meteorSize);
+            CRGB meteorColor = color;
+            meteorColor.nscale8(brightness);
+            leds[meteorPos - i] = meteorColor;
+        }
+    }
+}
+
+// Improved Wave Effect with consistent timing
+void effectWaveImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Apply speed multiplier for faster movement
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_WAVE);
+    // Use step for consistent wave movement
+    uint16_t wavePos = ((step * multiplier) / 2) % (numLeds * 2);
+    
+    // Create wave pattern
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint16_t distance = abs((int)i - (int)wavePos);
+        if (distance > numLeds) distance = (numLeds * 2) - distance;
+        
+        uint8_t brightness = 255 - (distance * 255 / numLeds);
+        if (brightness > 0) {
+            CRGB waveColor = color;
+            waveColor.nscale8(brightness);
+            leds[i] = waveColor;
+        } else {
+            leds[i] = getEffectBackgroundColor();
+        }
+    }
+}
+
+// Improved Comet Effect with consistent timing
+// PEV-Friendly: Improved Center Burst Effect with consistent timing
+void effectCenterBurstImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step for consistent timing across synced devices
+    uint8_t phase = (step * 3) % 256;
+    
+    // Use sine wave for smooth expansion/contraction
+    uint8_t expansion = sin8(phase);
+    uint16_t maxRadius = numLeds / 2;
+    uint16_t radius = arkMap(expansion, 0, 255, 0, maxRadius);
+    
+    uint16_t center = numLeds / 2;
+    
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint16_t distance = abs((int)i - (int)center);
+        
+        if (distance <= radius) {
+            // Inside the burst - calculate brightness based on distance from edge
+            uint16_t edgeDistance = radius - distance;
+            uint8_t brightness = arkMap(edgeDistance, 0, radius > 0 ? radius : 1, 100, 255);
+            CRGB burstColor = color;
+            burstColor.nscale8(brightness);
+            leds[i] = burstColor;
+        } else {
+            // Outside the burst
+            leds[i] = getEffectBackgroundColor();
+        }
+    }
+}
+
+// Improved Candle Effect with consistent timing
+void effectCandleImproved(CRGB* leds, uint16_t numLeds, uint16_t step) {
+    for (uint16_t i = 0; i < numLeds; i++) {
+        // Base candle color (warm white/orange)
+        CRGB baseColor = CRGB(255, 147, 41); // Warm orange
+        
+        // Use step for consistent flicker pattern
+        uint8_t flicker = (step * 3 + i * 7) % 100;
+        uint8_t brightness = 150 + flicker;
+        
+        CRGB candleColor = baseColor;
+        candleColor.nscale8(brightness);
+        leds[i] = candleColor;
+    }
+}
+
+// Improved Knight Rider Effect with consistent timing (KITT scanner)
+void effectKnightRiderImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Fade all LEDs to black (preserves color better than nscale8)
+    // Use a slower fade to black to preserve color hue
+    for (uint16_t i = 0; i < numLeds; i++) {
+        // Fade each channel independently toward black (preserves color better)
+        // Fade by ~25% per frame for smoother trail
+        leds[i].r = (leds[i].r * 192) >> 8; // ~25% fade
+        leds[i].g = (leds[i].g * 192) >> 8;
+        leds[i].b = (leds[i].b * 192) >> 8;
+    }
+    
+    // Calculate scanner position (smooth back-and-forth motion)
+    // Slow down the scanner by dividing step (Knight Rider should be slower)
+    // Allow scanner to go "off-screen" past the edges for authentic KITT effect
+    // The scanner appears to leave the LED bar before turning around
+    uint16_t trailLength = numLeds / 3;
+    if (trailLength < 3) trailLength = 3;
+    if (trailLength > 8) trailLength = 8;
+    
+    // Extend the cycle to allow scanner to go past edges
+    // Forward: -trailLength to numLeds + trailLength
+    // Backward: numLeds + trailLength to -trailLength
+    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
+    uint16_t position = (step / 4) % cycleLength; // Divide by 4 to slow down scanner
+    
+    // Determine direction and actual position (can be negative or beyond numLeds)
+    int16_t scannerPos;
+    bool forward;
+    if (position < (numLeds + trailLength * 2)) {
+        // Forward direction: goes from -trailLength to numLeds + trailLength
+        scannerPos = (int16_t)position - trailLength;
+        forward = true;
+    } else {
+        // Backward direction: goes from numLeds + trailLength to -trailLength
+        scannerPos = (int16_t)(cycleLength - position) - trailLength;
+        forward = false;
+    }
+    
+    // Draw trail first (behind scanner) - only draw visible parts
+    for (uint8_t i = 1; i <= trailLength; i++) {
+        int16_t trailPos;
+        
+        if (forward) {
+            // Trail behind (to the left when going forward)
+            trailPos = scannerPos - i;
+        } else {
+            // Trail behind (to the right when going backward)
+            trailPos = scannerPos + i;
+        }
+        
+        // Only draw if position is visible (within LED bounds)
+        if (trailPos >= 0 && trailPos < numLeds) {
+            // Exponential fade for smooth trail (brighter closer to main light)
+            // Use a curve: brightness = 255 * (1 - (i/trailLength)^2)
+            float fadeRatio = (float)i / trailLength;
+            uint8_t brightness = 255 * (1.0 - fadeRatio * fadeRatio);
+            
+            // Scale color channels independently to preserve hue
+            CRGB trailColor;
+            trailColor.r = (color.r * brightness) >> 8;
+            trailColor.g = (color.g * brightness) >> 8;
+            trailColor.b = (color.b * brightness) >> 8;
+            leds[trailPos] = trailColor; // Overwrite (not blend) to prevent color mixing
+        }
+    }
+    
+    // Main scanner light (bright center) - only draw if visible
+    if (scannerPos >= 0 && scannerPos < numLeds) {
+        leds[scannerPos] = color; // Full brightness main light
+    }
+}
+
+// Improved Police Effect with consistent timing
+void effectPoliceImproved(CRGB* leds, uint16_t numLeds, uint16_t step) {
+    // Use step for consistent flash pattern
+    bool flashState = (step / 10) % 2;
+    
+    for (uint16_t i = 0; i < numLeds; i++) {
+        if (flashState) {
+            // Red on odd positions, blue on even
+            leds[i] = (i % 2) ? CRGB::Red : CRGB::Blue;
+        } else {
+            // Blue on odd positions, red on even
+            leds[i] = (i % 2) ? CRGB::Blue : CRGB::Red;
+        }
+    }
+}
+
+// Improved Strobe Effect with consistent timing
+void effectStrobeImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step for consistent strobe pattern
+    bool strobeState = (step / 5) % 2;
+    
+    if (strobeState) {
+        fill_solid(leds, numLeds, color);
+    } else {
+        fill_solid(leds, numLeds, getEffectBackgroundColor());
+    }
+}
+
+// Improved Larson Scanner Effect with consistent timing
+void effectLarsonScannerImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Fade all LEDs
+    for (uint16_t i = 0; i < numLeds; i++) {
+        leds[i].nscale8(220); // Fade by 14%
+    }
+    
+    // Use step for consistent scanner movement
+    uint8_t scannerSize = 2 + (step % 2);
+    uint16_t scannerPos = (step / 3) % ((numLeds + scannerSize) * 2);
+    
+    // Determine direction
+    bool forward = (scannerPos < (numLeds + scannerSize));
+    uint16_t actualPos = forward ? scannerPos : ((numLeds + scannerSize) * 2) - scannerPos - 1;
+    
+    // Draw scanner with fade
+    for (uint8_t i = 0; i < scannerSize; i++) {
+        if (actualPos - i >= 0 && actualPos - i < numLeds) {
+            uint8_t brightness = 255 - (i * 200 / scannerSize);
+            CRGB scannerColor = color;
+            scannerColor.nscale8(brightness);
+            leds[actualPos - i] = scannerColor;
+        }
+    }
+}
+
+// Improved Color Wipe Effect with consistent timing
+void effectColorWipeImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Apply speed multiplier for faster movement
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_COLOR_WIPE);
+    // Use step for consistent wipe movement
+    uint16_t wipePos = ((step * multiplier) / 3) % (numLeds * 2);
+    
+    // Determine direction
+    bool forward = (wipePos < numLeds);
+    uint16_t actualPos = forward ? wipePos : (numLeds * 2) - wipePos - 1;
+    
+    // Clear all LEDs
+    fill_solid(leds, numLeds, getEffectBackgroundColor());
+    
+    // Fill up to position
+    for (uint16_t i = 0; i <= actualPos && i < numLeds; i++) {
+        leds[i] = color;
+    }
+}
+
+// Rainbow Color Wipe Effect (single-direction sweep, alternating direction)
+void effectRainbowWipeImproved(CRGB* leds, uint16_t numLeds, uint16_t step) {
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_RAINBOW_WIPE);
+    uint16_t sweepStep = (step * multiplier) / 3;
+    uint16_t sweepIndex = sweepStep / numLeds;
+    uint16_t pos = sweepStep % numLeds;
+    bool forward = (sweepIndex % 2 == 0);
+
+    uint8_t prevHue = ((sweepIndex - 1) * 57 + 23) & 0xFF;
+    uint8_t currHue = (sweepIndex * 57 + 23) & 0xFF;
+    if (abs((int)prevHue - (int)currHue) < 32) {
+        currHue = (currHue + 64) & 0xFF;
+    }
+
+    CRGB backgroundColor = CHSV(prevHue, 255, 255);
+    CRGB wipeColor = CHSV(currHue, 255, 255);
+    fill_solid(leds, numLeds, backgroundColor);
+
+    if (forward) {
+        for (uint16_t i = 0; i <= pos && i < numLeds; i++) {
+            leds[i] = wipeColor;
+        }
+    } else {
+        uint16_t actualPos = (numLeds - 1) - pos;
+        for (uint16_t i = actualPos; i < numLeds; i++) {
+            leds[i] = wipeColor;
+        }
+    }
+}
+
+// Improved Theater Chase Effect with consistent timing
+// PEV-Friendly: Improved Hazard Effect with consistent timing
+void effectHazardImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Use step for consistent timing across synced devices
+    bool firstHalf = ((step / 15) % 2) == 0; // Toggle every ~15 steps
+    
+    uint16_t midPoint = numLeds / 2;
+    
+    for (uint16_t i = 0; i < numLeds; i++) {
+        bool isFirstHalf = (i < midPoint);
+        
+        if ((isFirstHalf && firstHalf) || (!isFirstHalf && !firstHalf)) {
+            leds[i] = color;
+        } else {
+            // Dim the other half instead of turning off completely
+            CRGB dimColor = color;
+            dimColor.nscale8(40); // 15% brightness
+            leds[i] = dimColor;
+        }
+    }
+}
+
+// Improved Running Lights Effect with consistent timing
+void effectRunningLightsImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Apply speed multiplier for faster movement
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_RUNNING_LIGHTS);
+    // Use step for consistent running movement
+    uint16_t runPos = ((step * multiplier) / 2) % numLeds;
+    
+    // Clear all LEDs
+    fill_solid(leds, numLeds, getEffectBackgroundColor());
+    
+    // Create running light pattern
+    for (uint8_t i = 0; i < 3; i++) {
+        uint16_t pos = (runPos + i) % numLeds;
+        uint8_t brightness = 255 - (i * 85); // Fade each light
+        CRGB runColor = color;
+        runColor.nscale8(brightness);
+        leds[pos] = runColor;
+    }
+}
+
+// Improved Color Sweep Effect with consistent timing
+void effectColorSweepImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    // Apply speed multiplier for faster movement
+    uint8_t multiplier = getEffectSpeedMultiplier(FX_COLOR_SWEEP);
+    // Use step for consistent sweep movement
+    uint16_t sweepPos = ((step * multiplier) / 2) % (numLeds * 2);
+    
+    // Determine direction
+    bool forward = (sweepPos < numLeds);
+    uint16_t actualPos = forward ? sweepPos : (numLeds * 2) - sweepPos - 1;
+    
+    // Create sweep pattern
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint16_t distance = abs((int)i - (int)actualPos);
+        if (distance < 5) {
+            uint8_t brightness = 255 - (distance * 50);
+            CRGB sweepColor = color;
+            sweepColor.nscale8(brightness);
+            leds[i] = sweepColor;
+        } else {
+            leds[i] = getEffectBackgroundColor();
+        }
+    }
+}
+
+void effectRainbowKnightRiderImproved(CRGB* leds, uint16_t numLeds, uint16_t step, ScannerColorState& state) {
+    if (!state.initialized) {
+        state.lastForward = true;
+        state.color = CRGB::Red;
+        state.initialized = true;
+    }
+
+    uint16_t trailLength = numLeds / 3;
+    if (trailLength < 3) trailLength = 3;
+    if (trailLength > 8) trailLength = 8;
+
+    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
+    uint16_t position = (step / 4) % cycleLength;
+
+    bool forward = (position < (numLeds + trailLength * 2));
+    int16_t scannerPos;
+    if (forward) {
+        scannerPos = (int16_t)position - trailLength;
+    } else {
+        scannerPos = (int16_t)(cycleLength - position) - trailLength;
+    }
+
+    if (forward != state.lastForward) {
+        state.color = CHSV(random8(), 255, 255);
+        state.lastForward = forward;
+    }
+
+    fill_solid(leds, numLeds, getEffectBackgroundColor());
+
+    for (uint8_t i = 1; i <= trailLength; i++) {
+        int16_t trailPos = forward ? (scannerPos - i) : (scannerPos + i);
+        if (trailPos >= 0 && trailPos < numLeds) {
+            float fadeRatio = (float)i / trailLength;
+            uint8_t brightness = 255 * (1.0 - fadeRatio * fadeRatio);
+            CRGB trailColor;
+            trailColor.r = (state.color.r * brightness) >> 8;
+            trailColor.g = (state.color.g * brightness) >> 8;
+            trailColor.b = (state.color.b * brightness) >> 8;
+            leds[trailPos] = trailColor;
+        }
+    }
+
+    if (scannerPos >= 0 && scannerPos < numLeds) {
+        leds[scannerPos] = state.color;
+    }
+}
+
+void effectDualKnightRiderImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step) {
+    CRGB secondaryColor = getEffectBackgroundColor();
+
+    uint16_t trailLength = numLeds;
+    if (trailLength < 4) trailLength = 4;
+    if (trailLength > 16) trailLength = 16;
+
+    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
+    uint16_t position = (step / 4) % cycleLength;
+
+    bool forward = (position < (numLeds + trailLength * 2));
+    bool oppositeForward = !forward;
+
+    int16_t primaryPos = forward
+        ? (int16_t)position - trailLength
+        : (int16_t)(cycleLength - position) - trailLength;
+
+    int16_t posMin = -static_cast<int16_t>(trailLength);
+    int16_t posMax = static_cast<int16_t>(numLeds - 1 + trailLength);
+    int16_t secondaryPos = posMin + posMax - primaryPos;
+
+    fill_solid(leds, numLeds, CRGB::Black);
+
+    for (uint8_t i = 1; i <= trailLength; i++) {
+        float fadeRatio = (float)i / trailLength;
+        uint8_t brightness = 255 * (1.0 - sqrtf(fadeRatio));
+
+        int16_t primaryTrail = forward ? (primaryPos - i) : (primaryPos + i);
+        if (primaryTrail >= 0 && primaryTrail < numLeds) {
+            CRGB trailColor;
+            trailColor.r = (color.r * brightness) >> 8;
+            trailColor.g = (color.g * brightness) >> 8;
+            trailColor.b = (color.b * brightness) >> 8;
+            leds[primaryTrail] = mixColors(leds[primaryTrail], trailColor);
+        }
+
+        int16_t secondaryTrail = oppositeForward ? (secondaryPos - i) : (secondaryPos + i);
+        if (secondaryTrail >= 0 && secondaryTrail < numLeds) {
+            CRGB trailColor;
+            trailColor.r = (secondaryColor.r * brightness) >> 8;
+            trailColor.g = (secondaryColor.g * brightness) >> 8;
+            trailColor.b = (secondaryColor.b * brightness) >> 8;
+            leds[secondaryTrail] = mixColors(leds[secondaryTrail], trailColor);
+        }
+    }
+
+    if (primaryPos >= 0 && primaryPos < numLeds) {
+        leds[primaryPos] = mixColors(leds[primaryPos], color);
+    }
+    if (secondaryPos >= 0 && secondaryPos < numLeds) {
+        leds[secondaryPos] = mixColors(leds[secondaryPos], secondaryColor);
+    }
+}
+
+void effectDualRainbowKnightRiderImproved(CRGB* leds, uint16_t numLeds, uint16_t step, DualScannerColorState& state) {
+    if (!state.initialized) {
+        state.lastForward = true;
+        state.lastOppositeForward = false;
+        state.primaryColor = CHSV(0, 255, 255);
+        state.secondaryColor = CHSV(160, 255, 255);
+        state.initialized = true;
+    }
+
+    uint16_t trailLength = numLeds;
+    if (trailLength < 4) trailLength = 4;
+    if (trailLength > 16) trailLength = 16;
+
+    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
+    uint16_t position = (step / 4) % cycleLength;
+
+    bool forward = (position < (numLeds + trailLength * 2));
+    bool oppositeForward = !forward;
+
+    int16_t primaryPos = forward
+        ? (int16_t)position - trailLength
+        : (int16_t)(cycleLength - position) - trailLength;
+
+    int16_t posMin = -static_cast<int16_t>(trailLength);
+    int16_t posMax = static_cast<int16_t>(numLeds - 1 + trailLength);
+    int16_t secondaryPos = posMin + posMax - primaryPos;
+
+    if (forward != state.lastForward) {
+        state.primaryColor = CHSV(random8(), 255, 255);
+        state.lastForward = forward;
+    }
+    if (oppositeForward != state.lastOppositeForward) {
+        state.secondaryColor = CHSV(random8(), 255, 255);
+        state.lastOppositeForward = oppositeForward;
+    }
+
+    fill_solid(leds, numLeds, CRGB::Black);
+
+    for (uint8_t i = 1; i <= trailLength; i++) {
+        float fadeRatio = (float)i / trailLength;
+        uint8_t brightness = 255 * (1.0 - sqrtf(fadeRatio));
+
+        int16_t primaryTrail = forward ? (primaryPos - i) : (primaryPos + i);
+        if (primaryTrail >= 0 && primaryTrail < numLeds) {
+            CRGB trailColor;
+            trailColor.r = (state.primaryColor.r * brightness) >> 8;
+            trailColor.g = (state.primaryColor.g * brightness) >> 8;
+            trailColor.b = (state.primaryColor.b * brightness) >> 8;
+            leds[primaryTrail] = mixColors(leds[primaryTrail], trailColor);
+        }
+
+        int16_t secondaryTrail = oppositeForward ? (secondaryPos - i) : (secondaryPos + i);
+        if (secondaryTrail >= 0 && secondaryTrail < numLeds) {
+            CRGB trailColor;
+            trailColor.r = (state.secondaryColor.r * brightness) >> 8;
+            trailColor.g = (state.secondaryColor.g * brightness) >> 8;
+            trailColor.b = (state.secondaryColor.b * brightness) >> 8;
+            leds[secondaryTrail] = mixColors(leds[secondaryTrail], trailColor);
+        }
+    }
+
+    if (primaryPos >= 0 && primaryPos < numLeds) {
+        leds[primaryPos] = mixColors(leds[primaryPos], state.primaryColor);
+    }
+    if (secondaryPos >= 0 && secondaryPos < numLeds) {
+        leds[secondaryPos] = mixColors(leds[secondaryPos], state.secondaryColor);
+    }
+}
+
+// ============================================================================
+// EFFECT TABLE
+// ============================================================================
+
+// Adapters from the individual effect signatures to EffectRenderFn
+static void renderSolid(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) {
+    (void)step; (void)state;
+    fill_solid(leds, numLeds, color);
+}
+
+static void renderStaticRainbow(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) {
+    (void)color; (void)step; (void)state;
+    effectStaticRainbow(leds, numLeds);
+}
+
+static void renderFire(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) {
+    (void)color;
+    effectFireImproved(leds, numLeds, step, state);
+}
+
+static void renderRainbowKnightRider(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) {
+    (void)color;
+    effectRainbowKnightRiderImproved(leds, numLeds, step, *reinterpret_cast<ScannerColorState*>(state));
+}
+
+static void renderDualRainbowKnightRider(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) {
+    (void)color;
+    effectDualRainbowKnightRiderImproved(leds, numLeds, step, *reinterpret_cast<DualScannerColorState*>(state));
+}
+
+#define FX_COLOR_ADAPTER(fn) \
+    static void fn##Render(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) { \
+        (void)state; \
+        fn(leds, numLeds, color, step); \
+    }
+
+#define FX_COLORLESS_ADAPTER(fn) \
+    static void fn##Render(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state) { \
+        (void)color; (void)state; \
+        fn(leds, numLeds, step); \
+    }
+
+FX_COLOR_ADAPTER(effectBreathImproved)
+FX_COLOR_ADAPTER(effectPulseImproved)
+FX_COLOR_ADAPTER(effectGradientShiftImproved)
+FX_COLOR_ADAPTER(effectMeteorImproved)
+FX_COLOR_ADAPTER(effectWaveImproved)
+FX_COLOR_ADAPTER(effectCenterBurstImproved)
+FX_COLOR_ADAPTER(effectKnightRiderImproved)
+FX_COLOR_ADAPTER(effectStrobeImproved)
+FX_COLOR_ADAPTER(effectLarsonScannerImproved)
+FX_COLOR_ADAPTER(effectColorWipeImproved)
+FX_COLOR_ADAPTER(effectHazardImproved)
+FX_COLOR_ADAPTER(effectRunningLightsImproved)
+FX_COLOR_ADAPTER(effectColorSweepImproved)
+FX_COLOR_ADAPTER(effectDualKnightRiderImproved)
+FX_COLORLESS_ADAPTER(effectRainbowImproved)
+FX_COLORLESS_ADAPTER(effectBlinkRainbowImproved)
+FX_COLORLESS_ADAPTER(effectCandleImproved)
+FX_COLORLESS_ADAPTER(effectPoliceImproved)
+FX_COLORLESS_ADAPTER(effectRainbowWipeImproved)
+
+#define FX_ANIM FX_FLAG_ANIMATED
+#define FX_READ FX_FLAG_READS_FRAME
+
+// Indexed by FX_* ID. State sizes cover what the effect keeps between frames
+// outside the LED buffer (fire heat map, rainbow scanner colors); it lives in
+// the strip's EffectState.
+constexpr EffectDescriptor effectTable[FX_COUNT] = {
+    //  id                            name                         render                                  flags              speed  fixed                          perLed
+    { FX_SOLID,                     "Solid",                     renderSolid,                            0,                 1,     0,                             0 },
+    { FX_BREATH,                    "Breath",                    effectBreathImprovedRender,             FX_ANIM,           1,     0,                             0 },
+    { FX_RAINBOW,                   "Rainbow",                   effectRainbowImprovedRender,            FX_ANIM,           2,     0,                             0 },
+    { FX_PULSE,                     "Pulse",                     effectPulseImprovedRender,              FX_ANIM,           1,     0,                             0 },
+    { FX_BLINK_RAINBOW,             "Blink Rainbow",             effectBlinkRainbowImprovedRender,       FX_ANIM,           2,     0,                             0 },
+    { FX_GRADIENT_SHIFT,            "Gradient Shift",            effectGradientShiftImprovedRender,      FX_ANIM,           1,     0,                             0 },
+    { FX_FIRE,                      "Fire",                      renderFire,                             FX_ANIM,           1,     0,                             1 },
+    { FX_METEOR,                    "Meteor",                    effectMeteorImprovedRender,             FX_ANIM | FX_READ, 1,     0,                             0 },
+    { FX_WAVE,                      "Wave",                      effectWaveImprovedRender,               FX_ANIM,           1,     0,                             0 },
+    { FX_CENTER_BURST,              "Center Burst",              effectCenterBurstImprovedRender,        FX_ANIM,           1,     0,                             0 },
+    { FX_CANDLE,                    "Candle",                    effectCandleImprovedRender,             FX_ANIM,           1,     0,                             0 },
+    { FX_STATIC_RAINBOW,            "Static Rainbow",            renderStaticRainbow,                    0,                 1,     0,                             0 },
+    { FX_KNIGHT_RIDER,              "Knight Rider",              effectKnightRiderImprovedRender,        FX_ANIM | FX_READ, 1,     0,                             0 },
+    { FX_POLICE,                    "Police",                    effectPoliceImprovedRender,             FX_ANIM,           1,     0,                             0 },
+    { FX_STROBE,                    "Strobe",                    effectStrobeImprovedRender,             FX_ANIM,           1,     0,                             0 },
+    { FX_LARSON_SCANNER,            "Larson Scanner",            effectLarsonScannerImprovedRender,      FX_ANIM | FX_READ, 1,     0,                             0 },
+    { FX_COLOR_WIPE,                "Color Wipe",                effectColorWipeImprovedRender,          FX_ANIM,           1,     0,                             0 },
+    { FX_HAZARD,                    "Hazard",                    effectHazardImprovedRender,             FX_ANIM,           1,     0,                             0 },
+    { FX_RUNNING_LIGHTS,            "Running Lights",            effectRunningLightsImprovedRender,      FX_ANIM,           1,     0,                             0 },
+    { FX_COLOR_SWEEP,               "Color Sweep",               effectColorSweepImprovedRender,         FX_ANIM,           1,     0,                             0 },
+    { FX_RAINBOW_KNIGHT_RIDER,      "Rainbow Knight Rider",      renderRainbowKnightRider,               FX_ANIM,           1,     sizeof(ScannerColorState),     0 },
+    { FX_DUAL_KNIGHT_RIDER,         "Dual Knight Rider",         effectDualKnightRiderImprovedRender,    FX_ANIM,           1,     0,                             0 },
+    { FX_DUAL_RAINBOW_KNIGHT_RIDER, "Dual Rainbow Knight Rider", renderDualRainbowKnightRider,           FX_ANIM,           1,     sizeof(DualScannerColorState), 0 },
+    { FX_RAINBOW_WIPE,              "Rainbow Wipe",              effectRainbowWipeImprovedRender,        FX_ANIM,           1,     0,                             0 },
+};
+
+#undef FX_ANIM
+#undef FX_READ
+
+// Catch a reordered or missing entry at compile time
+static constexpr bool effectTableOrdered(uint8_t i = 0) {
+    return i >= FX_COUNT || (effectTable[i].id == i && effectTable[i].render != nullptr && effectTableOrdered(i + 1));
+}
+static_assert(effectTableOrdered(), "effectTable must have one entry per FX_* ID, in ID order");
@@ -0,0 +1,179 @@
+#ifndef ARK_RENDER_H
+#define ARK_RENDER_H
+
+// ArkLights render engine
+// Hardware-independent effect rendering and blending.
+// Builds against FastLED on the device and against ArkPixel's host shim in
+// the `native` environment (see bench/render_bench.cpp).
+
+#include "ArkPixel.h"
+
+// Effect IDs
+#define FX_SOLID 0
+#define FX_BREATH 1
+#define FX_RAINBOW 2
+#define FX_PULSE 3              // Replaced FX_CHASE - smooth rhythmic pulsing
+#define FX_BLINK_RAINBOW 4
+#define FX_GRADIENT_SHIFT 5     // Replaced FX_TWINKLE - color gradient that moves
+#define FX_FIRE 6
+#define FX_METEOR 7
+#define FX_WAVE 8
+#define FX_CENTER_BURST 9       // Replaced FX_COMET - expands from center outward
+#define FX_CANDLE 10
+#define FX_STATIC_RAINBOW 11
+#define FX_KNIGHT_RIDER 12
+#define FX_POLICE 13
+#define FX_STROBE 14
+#define FX_LARSON_SCANNER 15
+#define FX_COLOR_WIPE 16
+#define FX_RAINBOW_WIPE 23
+#define FX_HAZARD 17            // Replaced FX_THEATER_CHASE - alternating halves flash
+#define FX_RUNNING_LIGHTS 18
+#define FX_COLOR_SWEEP 19
+#define FX_RAINBOW_KNIGHT_RIDER 20
+#define FX_DUAL_KNIGHT_RIDER 21
+#define FX_DUAL_RAINBOW_KNIGHT_RIDER 22
+#define FX_COUNT 24
+
+// Speed normalization for consistent effect timing. Effect speeds are
+// defined per nominal ARKLIGHTS_FPS frame; it is also the default target of
+// the frame clock (ArkFrameClock.h).
+#define ARKLIGHTS_FPS 42
+#define FRAMETIME_FIXED (1000/ARKLIGHTS_FPS)
+#define MIN_FRAME_DELAY 2
+
+// Speed formula for length-normalized effects
+#define SPEED_FORMULA_L(speed, length) (5U + (50U*(255U - speed))/length)
+
+#define FX_STATE_UNBOUND 0xFF
+
+// Per-instance effect state (one per strip). Backed by a region of the frame
+// arena's state pool; cleared whenever a different effect starts using it.
+struct EffectState {
+    uint8_t* data = nullptr;
+    uint16_t capacity = 0;              // Bytes available at data
+    uint8_t effect = FX_STATE_UNBOUND;  // Effect the data currently belongs to
+};
+
+// Effect timing system. Effects animate from `step`, the integer part of a
+// phase accumulator that advances with elapsed time (effectClockAdvance), so
+// animation speed does not depend on the frame rate actually achieved.
+struct EffectTiming {
+    uint32_t lastFrameUs = 0;     // Monotonic clock (micros) at the last advance
+    uint16_t step = 0;            // Animation position, phase >> 16
+    uint32_t phase = 0;           // Step phase accumulator (16.16 fixed point)
+    bool needsUpdate = false;
+    EffectState state;            // Persistent state of the effect on this strip
+};
+
+// Longest gap credited to the effect clock in one advance. A longer stall
+// (OTA, blocking flash write) pauses the animation instead of leaping ahead.
+#define EFFECT_CLOCK_MAX_DELTA_US 250000UL
+
+// Animation rate at an effect speed (0-255) in 1/100 steps per second.
+// Matches the old fixed 0.1-8 steps per frame at ARKLIGHTS_FPS.
+uint32_t effectStepRate(uint8_t speed);
+
+// Advance a strip's phase by the time elapsed since its last advance
+void effectClockAdvance(EffectTiming& timing, uint32_t nowUs, uint8_t speed);
+
+// Jump to a step (ESP-NOW sync from the group master)
+inline void effectClockSetStep(EffectTiming& timing, uint16_t step) {
+    timing.phase = (uint32_t)step << 16;
+    timing.step = step;
+}
+
+// State layouts for the stateful effects (zeroed when the effect starts)
+struct ScannerColorState {
+    bool initialized;
+    bool lastForward;
+    CRGB color;
+};
+
+struct DualScannerColorState {
+    bool initialized;
+    bool lastForward;
+    bool lastOppositeForward;
+    CRGB primaryColor;
+    CRGB secondaryColor;
+};
+
+// Effect descriptor flags
+#define FX_FLAG_ANIMATED 0x01           // Output changes with timing.step (static effects only depend on their inputs)
+#define FX_FLAG_READS_FRAME 0x02        // Fades/reads the previous frame (trail state lives in the LED buffer)
+
+// Uniform render signature used by the effect table
+typedef void (*EffectRenderFn)(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step, uint8_t* state);
+
+// One entry per FX_* ID - the single source for effect dispatch and metadata
+struct EffectDescriptor {
+    uint8_t id;                 // FX_* ID (table is indexed by it)
+    const char* name;
+    EffectRenderFn render;
+    uint8_t flags;              // FX_FLAG_*
+    uint8_t speedMultiplier;    // Step multiplier for effects that move along the strip
+    uint8_t stateFixed;         // Persistent state in bytes, independent of strip length
+    uint8_t statePerLed;        // Persistent state in bytes per LED
+};
+
+extern const EffectDescriptor effectTable[FX_COUNT];
+
+// Descriptor for an effect ID, or nullptr if the ID is unknown
+inline const EffectDescriptor* getEffectDescriptor(uint8_t effect) {
+    return effect < FX_COUNT ? &effectTable[effect] : nullptr;
+}
+
+// State pool bytes a strip of numLeds needs to run any effect
+uint16_t effectStateBytes(uint16_t numLeds);
+
+// Point a strip's effect state at its region of the state pool
+void effectStateBind(EffectState& state, uint8_t* data, uint16_t capacity);
+
+inline bool effectIsAnimated(uint8_t effect) {
+    const EffectDescriptor* fx = getEffectDescriptor(effect);
+    return fx != nullptr && (fx->flags & FX_FLAG_ANIMATED);
+}
+
+// Background color for the effect currently being rendered
+extern bool effectBackgroundEnabled;
+extern CRGB effectBackgroundColor;
+
+const char* getEffectName(uint8_t effect);
+uint8_t getEffectSpeedMultiplier(uint8_t effect);
+CRGB getEffectBackgroundColor();
+CRGB mixColors(const CRGB& base, const CRGB& added);
+
+// Render one frame of an effect into an LED array.
+// Frames are always plain RGB; strip color order is applied by the LED
+// controller while the frame is written out.
+void applyEffectToArray(CRGB* leds, uint16_t numLeds, uint8_t effect, CRGB color, EffectTiming& timing, CRGB backgroundColor, bool backgroundEnabled);
+
+// Blend two LED arrays with fade progress in 1/256ths (0 = all source1, 256 = all source2)
+void blendLEDArrays(CRGB* target, const CRGB* source1, const CRGB* source2, uint16_t numLeds, uint16_t fade256);
+
+// Effect functions with consistent timing (step-based)
+void effectStaticRainbow(CRGB* leds, uint16_t numLeds);
+void effectBreathImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectRainbowImproved(CRGB* leds, uint16_t numLeds, uint16_t step);
+void effectPulseImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);           // PEV-friendly
+void effectBlinkRainbowImproved(CRGB* leds, uint16_t numLeds, uint16_t step);
+void effectGradientShiftImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);   // PEV-friendly
+void effectFireImproved(CRGB* leds, uint16_t numLeds, uint16_t step, uint8_t* heat);              // heat: one byte per LED
+void effectMeteorImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectWaveImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectCenterBurstImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);     // PEV-friendly
+void effectCandleImproved(CRGB* leds, uint16_t numLeds, uint16_t step);
+void effectKnightRiderImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectPoliceImproved(CRGB* leds, uint16_t numLeds, uint16_t step);
+void effectStrobeImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectLarsonScannerImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectColorWipeImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectRainbowWipeImproved(CRGB* leds, uint16_t numLeds, uint16_t step);
+void effectHazardImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);          // PEV-friendly
+void effectRunningLightsImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectColorSweepImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectRainbowKnightRiderImproved(CRGB* leds, uint16_t numLeds, uint16_t step, ScannerColorState& state);
+void effectDualKnightRiderImproved(CRGB* leds, uint16_t numLeds, CRGB color, uint16_t step);
+void effectDualRainbowKnightRiderImproved(CRGB* leds, uint16_t numLeds, uint16_t step, DualScannerColorState& state);
+
+#endif // ARK_RENDER_H
@@ -0,0 +1,50 @@
+#ifndef ARK_RING_H
+#define ARK_RING_H
+
+// SPSC ring - lock-free single-producer/single-consumer queue of trivially
+// copyable items. The producer only writes head and the consumer only writes
+// tail, so neither ever waits or takes a lock: pushing from a sensor task and
+// popping from loop() on another core costs a copy and two atomic accesses.
+// A full ring rejects the push (the producer counts the drop) rather than
+// overwriting items the consumer may be reading.
+
+#include <atomic>
+#include <stdint.h>
+
+// Size must be a power of two. Head and tail are free-running counters
+// (masked on access), so all Size slots are usable.
+template <typename T, uint32_t Size>
+struct SpscRing {
+    static_assert((Size & (Size - 1)) == 0, "SpscRing size must be a power of two");
+    std::atomic<uint32_t> head{0};  // Next slot to write (producer)
+    std::atomic<uint32_t> tail{0};  // Next slot to read (consumer)
+    T items[Size];
+};
+
+// Producer: false when the ring is full
+template <typename T, uint32_t Size>
+inline bool ringPush(SpscRing<T, Size>& ring, const T& item) {
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= Size) return false;
+    ring.items[head & (Size - 1)] = item;
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer: false when the ring is empty
+template <typename T, uint32_t Size>
+inline bool ringPop(SpscRing<T, Size>& ring, T& item) {
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (ring.head.load(std::memory_order_acquire) == tail) return false;
+    item = ring.items[tail & (Size - 1)];
+    ring.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+// Items queued (exact for either side, a snapshot for anyone else)
+template <typename T, uint32_t Size>
+inline uint32_t ringCount(const SpscRing<T, Size>& ring) {
+    return ring.head.load(std::memory_order_acquire) - ring.tail.load(std::memory_order_acquire);
+}
+
+#endif // ARK_RING_H
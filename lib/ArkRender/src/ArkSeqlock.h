@@ -0,0 +1,48 @@
+#ifndef ARK_SEQLOCK_H
+#define ARK_SEQLOCK_H
+
+// Seqlock - lock-free snapshot of a small trivially copyable struct with a
+// single writer. The writer never waits; a reader that overlaps a write
+// simply copies again, so it always ends up with a value that was published
+// as a whole. The reader spins while a write is in flight, so writer and
+// reader must run on different cores (or the writer must not be preempted
+// by the reader mid-write).
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+template <typename T>
+struct Seqlock {
+    std::atomic<uint32_t> sequence{0};  // Odd while a write is in progress
+    T value;
+};
+
+template <typename T>
+inline void seqlockWrite(Seqlock<T>& lock, const T& value) {
+    uint32_t seq = lock.sequence.load(std::memory_order_relaxed);
+    lock.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&lock.value, &value, sizeof(T));
+    lock.sequence.store(seq + 2, std::memory_order_release);
+}
+
+// Copy the latest published value into out; returns how many times the
+// copy had to be retried because it raced a write
+template <typename T>
+inline uint32_t seqlockRead(const Seqlock<T>& lock, T& out) {
+    uint32_t retries = 0;
+    for (;;) {
+        uint32_t before = lock.sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            memcpy(&out, &lock.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (lock.sequence.load(std::memory_order_relaxed) == before) {
+                return retries;
+            }
+        }
+        retries++;
+    }
+}
+
+#endif // ARK_SEQLOCK_H
@@ -0,0 +1,34 @@
+// Show gate - per-strip dirty tracking for LED output
+
+#include "ArkShowGate.h"
+
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+
+uint32_t frameHash(const CRGB* leds, uint16_t numLeds, uint8_t brightness) {
+    uint32_t hash = FNV_OFFSET_BASIS;
+    hash = (hash ^ brightness) * FNV_PRIME;
+    hash = (hash ^ (numLeds & 0xFF)) * FNV_PRIME;
+    hash = (hash ^ (numLeds >> 8)) * FNV_PRIME;
+
+    const uint8_t* bytes = (const uint8_t*)leds;
+    uint32_t count = (uint32_t)numLeds * sizeof(CRGB);
+    for (uint32_t i = 0; i < count; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool stripFrameChanged(StripFrameState& state, const CRGB* leds, uint16_t numLeds, uint8_t brightness) {
+    uint32_t hash = frameHash(leds, numLeds, brightness);
+    CRGB first = numLeds > 0 ? leds[0] : CRGB(0, 0, 0);
+    CRGB last = numLeds > 0 ? leds[numLeds - 1] : CRGB(0, 0, 0);
+    if (state.valid && state.hash == hash && state.first == first && state.last == last) {
+        return false;
+    }
+    state.hash = hash;
+    state.first = first;
+    state.last = last;
+    state.valid = true;
+    return true;
+}
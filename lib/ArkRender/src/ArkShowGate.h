@@ -0,0 +1,31 @@
+#ifndef ARK_SHOW_GATE_H
+#define ARK_SHOW_GATE_H
+
+// Show gate - per-strip dirty tracking for LED output.
+// Keeps a hash of the last frame pushed to each strip so unchanged frames
+// (static effects, held brake light, effects between steps) are not
+// re-sent over the wire. A changed frame whose hash collides with the last
+// one is skipped; at 2^-32 per frame that is accepted, and the first and
+// last pixels are compared as well so the common end-to-end effects can't
+// hide a change that way.
+
+#include "ArkPixel.h"
+
+struct StripFrameState {
+    uint32_t hash = 0;      // Hash of the pixels + brightness last sent
+    CRGB first, last;       // End pixels last sent (checked alongside the hash)
+    bool valid = false;     // False until the first frame is sent (or after invalidation)
+};
+
+// 32-bit FNV-1a over the pixel bytes, seeded with brightness and length
+uint32_t frameHash(const CRGB* leds, uint16_t numLeds, uint8_t brightness);
+
+// True if the strip differs from what was last sent; records the new hash
+bool stripFrameChanged(StripFrameState& state, const CRGB* leds, uint16_t numLeds, uint8_t brightness);
+
+// Force the next frame out (controller reconfigured, output mode changed, ...)
+inline void stripFrameInvalidate(StripFrameState& state) {
+    state.valid = false;
+}
+
+#endif // ARK_SHOW_GATE_H
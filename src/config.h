@@ -17,32 +17,14 @@
 // MPU6050 Motion Control Settings
 #define MPU_SDA_PIN 5
 #define MPU_SCL_PIN 6
+#define MPU_INT_PIN 7  // Data-ready interrupt (D8)
 
 // WiFi AP Configuration
 #define AP_CHANNEL 1
 #define MAX_CONNECTIONS 4
 
-// Effect IDs
-#define FX_SOLID 0
-#define FX_BREATH 1
-#define FX_RAINBOW 2
-#define FX_CHASE 3
-#define FX_BLINK_RAINBOW 4
-#define FX_TWINKLE 5
-#define FX_FIRE 6
-#define FX_METEOR 7
-#define FX_WAVE 8
-#define FX_COMET 9
-#define FX_CANDLE 10
-#define FX_STATIC_RAINBOW 11
-#define FX_KNIGHT_RIDER 12
-#define FX_POLICE 13
-#define FX_STROBE 14
-#define FX_LARSON_SCANNER 15
-#define FX_COLOR_WIPE 16
-#define FX_THEATER_CHASE 17
-#define FX_RUNNING_LIGHTS 18
-#define FX_COLOR_SWEEP 19
+// Effect IDs - defined once by the render engine (lib/ArkRender)
+#include <ArkRender.h>
 
 // Preset IDs
 #define PRESET_STANDARD 0
@@ -16,6 +16,19 @@
 #include "BLEServer.h"
 #include "BLEUtils.h"
 #include "BLE2902.h"
+#include <ArkRender.h>   // Render engine (effects, blending, color order)
+#include <ArkFrameArena.h> // Preallocated scratch frames for the render path
+#include <ArkShowGate.h>   // Per-strip dirty tracking (skip unchanged frames)
+#include <ArkCompositor.h> // Layer stack: base effect + brake/blinker/impact overlays
+#include <ArkSeqlock.h>    // Lock-free settings snapshot for the render task
+#include <ArkRing.h>       // Lock-free sample ring from the sensor task
+#include <ArkFrameClock.h> // Frame scheduler + frame timing histograms
+#include <ArkPerf.h>       // Per-stage cycle-count profiler
+#include <ArkAttitude.h>   // Gyro + accel fusion for pitch/roll/lean
+#include <ArkMotion.h>     // Direction/brake/blinker/park/impact detectors
+#include <ArkMotionLog.h>  // Ride log format (recorder + host replay)
+#include <esp_timer.h>
+#include <esp_pm.h>
 #include "embedded_ui.h"  // Auto-generated embedded UI files (gzipped)
 
 // CRGBW struct for RGBW LED support
@@ -62,10 +75,17 @@ struct CRGBW {
 #define HEADLIGHT_PIN 4
 #define TAILLIGHT_PIN 3
 #define DEFAULT_BRIGHTNESS 128
+#define MAX_LEDS_PER_STRIP 1000  // Upper bound for headlight/taillight LED counts
+
+// Render scheduler target frame rate (override per build, e.g. -D TARGET_FPS=60).
+// Effects animate on elapsed time, so this only changes smoothness and load.
+#ifndef TARGET_FPS
+#define TARGET_FPS ARKLIGHTS_FPS
+#endif
 
 // LED Configuration (can be changed via web UI)
-uint8_t headlightLedCount = 11;
-uint8_t taillightLedCount = 11;
+uint16_t headlightLedCount = 11;
+uint16_t taillightLedCount = 11;
 uint8_t headlightLedType = 0;  // 0=SK6812 RGBW, 1=SK6812 RGB, 2=WS2812B
 uint8_t taillightLedType = 0;
 uint8_t headlightColorOrder = 1;  // 0=RGB, 1=GRB, 2=BGR - Default to GRB for SK6812 RGBW
@@ -154,6 +174,50 @@ struct ESPNowPeer {
     uint32_t lastSeen;
 };
 
+// Stage profiler - cycle counts per stage, reported by GET /api/perf and the
+// serial "perf" command. Each stage is recorded by the one task that runs it.
+enum PerfStage : uint8_t {
+    PERF_MOTION = 0,        // Motion detectors over one batch of samples (loop)
+    PERF_IMU_READ,          // MPU6050 FIFO burst read (sensor task)
+    PERF_EFFECT,            // One strip's effect render (render task)
+    PERF_BLEND,             // blendLEDArrays direction fades (render task)
+    PERF_SHOW,              // FastLED.show (output or render task)
+    PERF_HTTP,              // server.handleClient, idle polls included (loop)
+    PERF_BLE,               // BLE write: frame extraction and dispatch (BT task)
+    PERF_ESPNOW_SEND,       // esp_now_send (loop)
+    PERF_ESPNOW_RECEIVE,    // ESP-NOW receive callback (Wi-Fi task)
+    PERF_SAVE_SETTINGS,     // saveSettings
+    PERF_STAGE_COUNT
+};
+const char* const perfStageNames[PERF_STAGE_COUNT] = {
+    "motion", "imu_read", "effect", "blend", "show", "http", "ble", "espnow_send", "espnow_receive", "save_settings"
+};
+PerfStats perfStats[PERF_STAGE_COUNT];
+
+// Main loop wake-up - loop() blocks on this event group until a source has
+// work for it (or a timeout for the sources that can only be polled)
+#define LOOP_EVENT_BLE (1 << 0)         // BLE write, connect or disconnect
+#define LOOP_EVENT_ESPNOW (1 << 1)      // ESP-NOW packet received
+#define LOOP_EVENT_MOTION (1 << 2)      // Motion samples queued by the sensor task
+#define LOOP_EVENT_FRAME (1 << 3)       // Frame sent that carried a pending command (latency probe)
+#define LOOP_EVENT_ALL (LOOP_EVENT_BLE | LOOP_EVENT_ESPNOW | LOOP_EVENT_MOTION | LOOP_EVENT_FRAME)
+#define LOOP_IDLE_WAIT_MS 100           // Longest sleep: serial, heartbeats and timeouts are polled at least this often
+#define LOOP_HTTP_POLL_MS 5             // Sleep while a Wi-Fi client is connected (WebServer has no wake-up source)
+EventGroupHandle_t loopEvents = nullptr;
+uint32_t loopWakeups = 0;
+
+inline void wakeLoop(EventBits_t bits) {
+    if (loopEvents != nullptr) xEventGroupSetBits(loopEvents, bits);
+}
+
+// Command-to-light latency: a command's arrival time (micros) travels with
+// the settings snapshot to the first frame rendered from it, and the latency
+// is recorded once that frame has been sent to the strips
+volatile uint32_t bleCommandArrivalUs = 0;     // Set with blePendingJson
+volatile uint32_t espNowCommandArrivalUs = 0;  // Set with espNowPendingData
+uint32_t commandArrivalUs = 0;                 // Command applied by loop(), published with the next snapshot
+uint32_t publishedCommandUs = 0;
+
 // Forward declarations
 bool deviceConnected = false;
 bool oldDeviceConnected = false;
@@ -223,16 +287,19 @@ class MyServerCallbacks: public BLEServerCallbacks {
     void onConnect(BLEServer* pServer) {
       deviceConnected = true;
       Serial.println("BLE: Client connected");
+      wakeLoop(LOOP_EVENT_BLE);
     };
 
     void onDisconnect(BLEServer* pServer) {
       deviceConnected = false;
       Serial.println("BLE: Client disconnected");
+      wakeLoop(LOOP_EVENT_BLE);
     }
 };
 
 class MyCallbacks: public BLECharacteristicCallbacks {
     void onWrite(BLECharacteristic *pCharacteristic) {
+      PerfScope perf(perfStats[PERF_BLE]);
       std::string rxValue = pCharacteristic->getValue();
       
       if (rxValue.length() > 0) {
@@ -253,6 +320,7 @@ class MyCallbacks: public BLECharacteristicCallbacks {
                   reinterpret_cast<const char*>(frame.payload.data()),
                   frame.payload.length()
               );
+              bleCommandArrivalUs = micros();
               canApply = true;
             }
             portEXIT_CRITICAL(&blePendingMutex);
@@ -297,6 +365,7 @@ class MyCallbacks: public BLECharacteristicCallbacks {
             sendBleError(frame.seq, "Unknown message");
           }
         }
+        wakeLoop(LOOP_EVENT_BLE);
       }
     }
 };
@@ -310,32 +379,6 @@ BLECharacteristic* pCharacteristic = nullptr;
 bool bluetoothEnabled = true;
 String bluetoothDeviceName = "ARKLIGHTS-AP";
 
-// Effect IDs
-#define FX_SOLID 0
-#define FX_BREATH 1
-#define FX_RAINBOW 2
-#define FX_PULSE 3              // Replaced FX_CHASE - smooth rhythmic pulsing
-#define FX_BLINK_RAINBOW 4
-#define FX_GRADIENT_SHIFT 5     // Replaced FX_TWINKLE - color gradient that moves
-#define FX_FIRE 6
-#define FX_METEOR 7
-#define FX_WAVE 8
-#define FX_CENTER_BURST 9       // Replaced FX_COMET - expands from center outward
-#define FX_CANDLE 10
-#define FX_STATIC_RAINBOW 11
-#define FX_KNIGHT_RIDER 12
-#define FX_POLICE 13
-#define FX_STROBE 14
-#define FX_LARSON_SCANNER 15
-#define FX_COLOR_WIPE 16
-#define FX_RAINBOW_WIPE 23
-#define FX_HAZARD 17            // Replaced FX_THEATER_CHASE - alternating halves flash
-#define FX_RUNNING_LIGHTS 18
-#define FX_COLOR_SWEEP 19
-#define FX_RAINBOW_KNIGHT_RIDER 20
-#define FX_DUAL_KNIGHT_RIDER 21
-#define FX_DUAL_RAINBOW_KNIGHT_RIDER 22
-
 // Preset IDs
 #define PRESET_STANDARD 0
 #define PRESET_NIGHT 1
@@ -354,9 +397,176 @@ String bluetoothDeviceName = "ARKLIGHTS-AP";
 // LED strips (dynamic size) - Use CRGB for all LED types
 CRGB* headlight;
 CRGB* taillight;
+FrameArena frameArena;  // Scratch frames (fade snapshots, temp renders) + effect state pool - sized in initializeLEDs
 CLEDController* headlightController = nullptr;
 CLEDController* taillightController = nullptr;
 
+// Output dirty tracking - showLEDs() only pushes frames that changed
+StripFrameState headlightShown;
+StripFrameState taillightShown;
+uint32_t framesSent = 0;
+uint32_t framesSkipped = 0;
+
+// Layer stacks - base effect plus brake/blinker/impact overlays per strip,
+// flattened into headlight/taillight by compositeLayers() every frame
+LayerStack headlightLayers;
+LayerStack taillightLayers;
+CRGB* headlightBase = nullptr;  // Base effect frames (arena slots, or the output arrays without an arena)
+CRGB* taillightBase = nullptr;
+CRGB* brakeFrame = nullptr;     // Brake overlay pixels (arena slot, nullptr = plain red brake light)
+
+// Double-buffered output: headlight/taillight are the front frames registered
+// with the LED controllers, the render task composites into the back frames
+// and swaps them in before showing. Both point at the same array if the back
+// frames could not be allocated.
+CRGB* headlightBack = nullptr;
+CRGB* taillightBack = nullptr;
+
+// Render task - effects, overlays and FastLED.show() run on their own core so
+// HTTP, BLE, ESP-NOW and serial work in loop() can't stall the animation
+#define RENDER_TASK_CORE 0              // loop() and its networking stay on ARDUINO_RUNNING_CORE (1)
+#define RENDER_TASK_PRIORITY 2          // Above loop() (1)
+#define RENDER_TASK_STACK_SIZE 4096
+TaskHandle_t renderTaskHandle = nullptr;
+SemaphoreHandle_t ledMutex = nullptr;   // Recursive; held by the render task per frame and by loop() for direct LED writes
+uint32_t renderFrames = 0;
+
+// Boot timing (ms since boot, 0 = not reached yet)
+uint32_t bootFirstFrameMs = 0;          // First frame rendered
+uint32_t bootSetupMs = 0;               // setup() finished - loop() starts serving requests
+uint32_t bootFirstApiMs = 0;            // First API response sent (HTTP or BLE)
+uint32_t renderSnapshotRetries = 0;
+uint32_t renderSnapshotSequence = 0;    // Seqlock sequence the current snapshot was read at
+uint32_t motionSnapshotSequence = 0;    // Same for the motion state snapshot
+uint16_t renderStaticFrames = 0;        // Consecutive static frames that came out unchanged
+bool frameClockResync = false;          // Next frame interval spans an idle park - not recorded
+
+// Asynchronous output - the render task hands a finished frame to the output
+// task and goes on rendering the next one into the back frames while the
+// strips are clocked out. The fence is taken before a frame is queued and
+// given back once FastLED.show() has finished reading the front frames.
+#define LED_OUTPUT_TASK_PRIORITY 3      // Above the render task so a queued frame starts right away
+#define LED_OUTPUT_TASK_STACK_SIZE 3072
+bool asyncLedOutput = true;             // false = render task calls FastLED.show() itself
+TaskHandle_t ledOutputTaskHandle = nullptr;
+SemaphoreHandle_t ledOutputFence = nullptr;  // Binary; available while no frame is being sent
+uint8_t ledOutputBrightness = 0;        // Brightness captured with the queued frame
+uint32_t ledOutputShowUs = 0;           // Duration of the last show on the output task
+uint32_t ledOutputFenceWaits = 0;       // Frames that had to wait for the previous one to finish sending
+
+// Frame scheduler - one clock for the whole frame (effects, overlays, show).
+// The render task sleeps on a one-shot esp_timer armed for the next deadline.
+FrameClock frameClock;
+esp_timer_handle_t frameTimer = nullptr;
+uint16_t targetFps = TARGET_FPS;        // Requested by the API/serial, applied by the render task
+FrameHistogram frameIntervalHistogram;  // Frame start to frame start
+FrameHistogram renderTimeHistogram;     // Effects, overlays and composite
+FrameHistogram showTimeHistogram;       // FastLED.show() for frames that were sent
+volatile bool frameStatsResetPending = false;
+FrameHistogram commandLatencyHistogram; // Command arrival to its first frame on the strips
+uint32_t lastCommandLatencyUs = 0;
+uint32_t ledOutputCommandUs = 0;        // Command carried by the queued frame (0 = none)
+bool commandLatencyReport = false;      // Serial "latency": log each command-to-light time
+
+// Idle power mode - once the frame is static (no animated effect, overlay or
+// fade) and no client is connected, the render task stops waking every frame
+// and parks until loop() publishes different settings. With CONFIG_PM_ENABLE
+// the render task's PM locks are released while it is parked, so the power
+// manager can lower the CPU clock and, with tickless idle, light-sleep between
+// Wi-Fi beacons and BLE advertising events. The Arduino build links the
+// prebuilt SDK with CONFIG_PM_ENABLE off, so there it only parks the render
+// task - render_parked_ms is time parked, not time asleep.
+#define POWER_IDLE_STATIC_FRAMES 30     // Unchanged static frames before the render task parks
+#define POWER_IDLE_REFRESH_MS 1000      // A parked render task still redraws this often
+#define POWER_MIN_FREQ_MHZ 40           // XTAL - lowest clock the radios allow
+bool powerSaveEnabled = true;
+volatile bool renderIdle = false;       // Render task is in idle mode (parked or on a refresh frame)
+uint32_t powerIdleEntries = 0;          // Times the render task went idle
+uint32_t renderParkedMs = 0;            // Time the render task spent parked (updated on each wake)
+bool powerLightSleep = false;           // Automatic light sleep configured
+#if CONFIG_PM_ENABLE
+esp_pm_lock_handle_t renderCpuLock = nullptr;    // ESP_PM_CPU_FREQ_MAX while rendering
+esp_pm_lock_handle_t renderSleepLock = nullptr;  // ESP_PM_NO_LIGHT_SLEEP while rendering
+#endif
+
+// Everything the render path reads from the rest of the firmware. loop()
+// publishes a copy once per pass; the render task takes a consistent snapshot
+// at the start of each frame (seqlock - neither side ever blocks).
+struct RenderSettings {
+    uint8_t brightness;
+    uint8_t effectSpeed;
+    uint8_t headlightEffect;
+    uint8_t taillightEffect;
+    CRGB headlightColor;
+    CRGB taillightColor;
+    bool headlightBackgroundEnabled;
+    bool taillightBackgroundEnabled;
+    CRGB headlightBackgroundColor;
+    CRGB taillightBackgroundColor;
+    uint8_t headlightMode;
+    bool directionBasedLighting;
+    uint8_t parkEffect;
+    uint8_t parkEffectSpeed;
+    uint8_t parkBrightness;
+    CRGB parkHeadlightColor;
+    CRGB parkTaillightColor;
+    uint8_t brakingEffect;
+    uint8_t brakingBrightness;
+    uint32_t stepSyncCount;     // Bumped per ESP-NOW step sync
+    uint16_t stepSyncStep;
+    bool startupActive;
+    uint8_t startupSequence;
+    uint16_t startupDuration;
+    unsigned long startupStartTime;
+    bool outputHeld;            // OTA owns the LEDs - render task idles
+    uint16_t targetFps;
+    uint32_t commandUs;         // Arrival time of the last command applied (latency probe)
+    bool powerSave;
+    bool clientConnected;       // BLE central or Wi-Fi station connected (keeps the render task awake)
+};
+Seqlock<RenderSettings> renderSettingsLock;
+RenderSettings renderSettings;  // Render task's snapshot for the current frame
+
+// Motion detector results the render path reads. Published through their own
+// seqlock after every sensor sample (and after API overrides), so detection
+// runs at the sensor rate, rendering at the frame rate, and a frame never
+// sees half an update.
+struct MotionState {
+    bool isMovingForward;
+    bool directionChangePending;
+    float directionFadeProgress;
+    bool parkModeActive;
+    bool brakingActive;
+    unsigned long brakingStartTime;
+    bool blinkerActive;
+    int8_t blinkerDirection;
+    uint32_t impactCount;       // Bumped per detected impact; the render task flashes on change
+};
+Seqlock<MotionState> motionStateLock;
+MotionState motionState;        // Render task's snapshot for the current frame
+
+// Block until no frame is being sent. The fence stays free afterwards while
+// the LED lock is held, because only the render path queues frames.
+inline void waitLEDOutput() {
+    if (ledOutputFence == nullptr) return;
+    xSemaphoreTake(ledOutputFence, portMAX_DELAY);
+    xSemaphoreGive(ledOutputFence);
+}
+
+// Holds the LED arrays and controllers for the current scope, once any frame
+// still being sent has gone out. The render task takes it for every frame
+// (without waiting for output, so rendering overlaps the send); loop() takes
+// it around direct writes (startup, OTA progress) and reconfiguration.
+struct LEDLock {
+    explicit LEDLock(bool waitForOutput = true) {
+        if (ledMutex != nullptr) xSemaphoreTakeRecursive(ledMutex, portMAX_DELAY);
+        if (waitForOutput) waitLEDOutput();  // Front frames may still be going out
+    }
+    ~LEDLock() {
+        if (ledMutex != nullptr) xSemaphoreGiveRecursive(ledMutex);
+    }
+};
+
 // System state
 uint8_t globalBrightness = DEFAULT_BRIGHTNESS;
 uint8_t currentPreset = PRESET_STANDARD;
@@ -385,8 +595,6 @@ bool headlightBackgroundEnabled = false;
 bool taillightBackgroundEnabled = false;
 CRGB headlightBackgroundColor = CRGB::Black;
 CRGB taillightBackgroundColor = CRGB::Black;
-bool effectBackgroundEnabled = false;
-CRGB effectBackgroundColor = CRGB::Black;
 uint8_t effectSpeed = 64; // Speed control (0-255, higher = faster) - Default to slower speed
 
 // RGBW white channel control (for SK6812 RGBW strips)
@@ -402,8 +610,97 @@ uint16_t startupDuration = 3000; // Duration in milliseconds
 // MPU6050 Motion Control Settings
 #define MPU_SDA_PIN 5
 #define MPU_SCL_PIN 6
+#ifndef MPU_INT_PIN
+#define MPU_INT_PIN 7                   // MPU6050 INT (D8) - optional, the sensor task polls without it
+#endif
 MPU6050 mpu;
 
+// MPU6050 sampling - the sample-rate divider paces the sensor, every sample
+// goes through its FIFO, and a sensor task burst-reads the FIFO on the
+// data-ready interrupt and queues the samples for the detectors in loop()
+#define MOTION_SAMPLE_RATE_HZ 200
+#define MOTION_SAMPLE_PERIOD_US (1000000UL / MOTION_SAMPLE_RATE_HZ)
+#define MOTION_SAMPLE_BYTES 12          // FIFO record: accel XYZ, gyro XYZ (big-endian int16)
+#define MOTION_FIFO_BYTES 1024          // MPU6050 FIFO size
+#define MOTION_FIFO_BATCH 2             // Samples per burst read (10ms at 200Hz)
+#define MOTION_FIFO_READ_SAMPLES 10     // Samples per I2C transfer (Wire buffer is 128 bytes)
+#define MOTION_FIFO_POLL_MS 20          // Sensor task wait when the interrupt never fires
+#define MOTION_RING_SIZE 64             // 320ms of samples between sensor task and loop() (power of two)
+#define SENSOR_TASK_CORE 1              // Next to loop(); the render task has core 0
+#define SENSOR_TASK_PRIORITY 3          // Above loop() (1) so I2C reads keep up with the FIFO
+#define SENSOR_TASK_STACK_SIZE 3072
+
+// Wake on motion - while park mode holds, the MPU6050 drops to accel-only
+// cycle mode (gyros in standby) and raises its motion interrupt instead of
+// streaming samples, so the sensor task, I2C bus and detectors all sleep
+#define MOTION_WAKE_FREQ MPU6050_WAKE_FREQ_20  // Accel samples/s while parked (~50ms to react)
+#define MOTION_WAKE_MG_PER_LSB 2        // MOT_THR scale
+#define MOTION_WAKE_DURATION 1          // Samples over the threshold before the interrupt
+#define MOTION_STANDBY_POLL_MS 500      // Motion status check when the INT pin isn't wired
+
+TaskHandle_t sensorTaskHandle = nullptr;
+SpscRing<MotionSample, MOTION_RING_SIZE> motionRing;  // Sensor task -> loop()
+volatile uint32_t motionInterrupts = 0;
+uint32_t motionSamplesRead = 0;         // Sensor task
+uint32_t motionSamplesDropped = 0;      // Queue full (sensor task)
+uint32_t motionFifoOverflows = 0;       // FIFO reset after filling up (sensor task)
+uint32_t motionSamplesProcessed = 0;    // loop()
+uint16_t motionSampleRateHz = 0;        // Measured over the last second (loop)
+volatile bool motionStandbyRequested = false;  // loop(): park mode wants the sensor parked
+volatile bool motionStandby = false;    // Sensor task: MPU6050 is in wake-on-motion mode
+volatile bool motionWoke = false;       // Sensor task woke on motion; loop() hasn't ended park mode yet
+volatile uint8_t motionWakeThreshold = 25;  // MOT_THR (loop, from the park noise threshold)
+uint32_t motionWakes = 0;               // Sensor task
+uint32_t motionStandbyEntries = 0;      // Sensor task
+
+// Ride recorder - loop() appends raw samples to chunks in PSRAM and a
+// low-priority writer task on the other core moves full chunks to SPIFFS, so
+// flash erase/write stalls (tens of ms) never hold up the detectors. The log
+// replays on the host through the same detector code (bench "replay" suite).
+#define RECORDER_PATH "/imu.bin"
+#define RECORDER_CHUNK_BYTES 4096
+#define RECORDER_CHUNKS 16              // 64KB of PSRAM = ~23s of samples queued behind the flash
+#define RECORDER_MAX_BYTES (1024UL * 1024UL)  // ~6 minutes at 200Hz (14 bytes per sample)
+#define RECORDER_FS_MARGIN (64UL * 1024UL)    // SPIFFS space left for settings and UI files
+#define RECORDER_TASK_CORE 0
+#define RECORDER_TASK_PRIORITY 1        // Below the render task; flash writes can wait
+#define RECORDER_TASK_STACK_SIZE 4096
+
+// Impact capture - the samples around every impact go through the same
+// writer to their own log, which replays like a ride
+#define IMPACT_CAPTURE_PATH "/impact.bin"
+#define IMPACT_PRE_SAMPLES 128          // 640ms before the trigger (power of two)
+#define IMPACT_POST_SAMPLES 200         // 1s after
+
+struct RecorderChunk {
+    uint16_t bytes;
+    const char* path;   // Log file (set on the first chunk)
+    bool first;     // Writer opens (truncates) the log before writing this chunk
+    bool last;      // Writer closes the log after writing this chunk
+    uint8_t data[RECORDER_CHUNK_BYTES];
+};
+
+RecorderChunk* recorderChunks = nullptr;        // PSRAM, allocated on first recording
+SpscRing<uint8_t, RECORDER_CHUNKS> recorderFull;  // loop() -> writer: chunks to write
+SpscRing<uint8_t, RECORDER_CHUNKS> recorderFree;  // Writer -> loop(): chunks to refill
+TaskHandle_t recorderTaskHandle = nullptr;
+bool recording = false;
+bool recorderClosePending = false;      // Stopped while every chunk was queued (loop)
+volatile bool recorderFileOpen = false; // Set by loop() on start, cleared by the writer on close
+RecorderChunk* recorderChunk = nullptr; // Being filled (loop)
+uint8_t recorderChunkIndex = 0;
+uint32_t recorderPreviousUs = 0;
+uint32_t recorderLimitBytes = 0;
+uint32_t recorderBytesQueued = 0;       // loop()
+uint32_t recordingSamples = 0;          // loop()
+uint32_t recordingDropped = 0;          // No free chunk - writer fell behind (loop)
+volatile uint32_t recordingBytesWritten = 0;  // Writer
+volatile uint32_t recordingWriteErrors = 0;   // Writer
+MotionSample impactHistory[IMPACT_PRE_SAMPLES]; // Latest samples, oldest overwritten (loop)
+uint32_t impactHistoryCount = 0;
+uint16_t impactCaptureRemaining = 0;    // Samples still to capture after an impact (loop)
+uint32_t impactCaptures = 0;
+
 // NVS for persistent settings storage (survives OTA filesystem updates)
 // ESP32 NVS has a 508-byte limit per key; we chunk the settings JSON into NVS_CHUNK_SIZE pieces.
 constexpr size_t NVS_CHUNK_SIZE = 500;
@@ -412,12 +709,26 @@ Preferences nvs;
 const char* NVS_NAMESPACE = "arklights";
 bool nvsMigrationPending = false; // Track if NVS migration needs to happen
 
+// Write-behind settings - saveSettings() only marks the settings dirty;
+// loop() commits them to NVS and SPIFFS once changes have been quiet for
+// SETTINGS_QUIET_MS (or SETTINGS_MAX_DELAY_MS after the first unsaved change,
+// so a slider held for a long time still gets saved). flushSettings() commits
+// right away and runs before every restart and OTA update.
+#define SETTINGS_QUIET_MS 1500
+#define SETTINGS_MAX_DELAY_MS 10000
+bool settingsDirty = false;
+uint32_t settingsFirstChangeMs = 0;     // First change since the last commit
+uint32_t settingsLastChangeMs = 0;
+uint32_t settingsCommits = 0;           // Flash writes performed
+uint32_t settingsCommitFailures = 0;    // Commits neither NVS nor SPIFFS took (retried)
+uint32_t settingsWritesAvoided = 0;     // saveSettings() calls coalesced into a pending commit
+
 // Motion control settings
 bool motionEnabled = true;
 bool blinkerEnabled = true;
 bool parkModeEnabled = true;
 bool impactDetectionEnabled = true;
-float motionSensitivity = 1.0; // 0.5 to 2.0
+float motionSensitivity = 1.0; // 0.5 to 2.0 - blinker lean threshold multiplier (15 deg x this; was 1.5G lateral accel x this)
 uint16_t blinkerDelay = 300; // ms before triggering blinker
 uint16_t blinkerTimeout = 2000; // ms before turning off blinker
 uint8_t parkDetectionAngle = 15; // degrees of tilt for park mode
@@ -445,36 +756,29 @@ unsigned long otaStartTime = 0;
 String otaFileName = "";
 size_t otaFileSize = 0;
 
-// Motion state
-bool blinkerActive = false;
-int8_t blinkerDirection = 0; // -1 = left, 1 = right, 0 = none
-bool parkModeActive = false;
-unsigned long lastMotionUpdate = 0;
-unsigned long blinkerStartTime = 0;
-unsigned long parkStartTime = 0;
-unsigned long lastImpactTime = 0;
-bool manualBlinkerActive = false;
-
-// Direction detection state
+// Motion state - detector results and their timers (direction, braking,
+// blinkers, park, impacts). Written by loop() only; the render task reads
+// the published MotionState snapshot.
+MotionDetectors motion;
+const uint8_t BLINKER_FADE_RATE = 85;  // Blinker opacity change per frame (~3 frames on/off)
+
+// Impact flash (impact overlay layer)
+volatile uint16_t stepSyncStep = 0;   // Last ESP-NOW master step (applied by loop())
+volatile uint32_t stepSyncCount = 0;
+bool impactFlashActive = false;
+unsigned long impactFlashStart = 0;
+const unsigned long IMPACT_FLASH_DURATION = 200;  // ms at full white before fading out
+const uint8_t IMPACT_FADE_RATE = 24;  // Impact opacity change per frame while fading out
+
+// Direction detection settings
 bool directionBasedLighting = false;
-bool isMovingForward = true;  // true = forward, false = backward
-bool directionChangePending = false;  // Direction change detected but not yet applied
 float forwardAccelThreshold = 0.3;  // G-force threshold for direction change
-unsigned long directionChangeDetectedTime = 0;
-unsigned long directionFadeStartTime = 0;
-const unsigned long DIRECTION_SUSTAIN_TIME = 500;  // ms direction must be sustained before switching
-const unsigned long DIRECTION_FADE_DURATION = 1500;  // ms for smooth fade transition (needs to be visible)
 uint8_t headlightMode = 0;  // 0 = solid white, 1 = headlight effect
-float directionFadeProgress = 0.0;  // 0.0 to 1.0 for fade transition
 
 // Braking detection state
 bool brakingEnabled = false;  // Default to disabled - user must enable via UI
-bool brakingActive = false;
-bool manualBrakeActive = false;
 float brakingThreshold = -0.5;  // G-force deceleration threshold (negative = deceleration)
-const unsigned long BRAKING_SUSTAIN_TIME = 200;  // ms deceleration must be sustained before triggering
-unsigned long brakingDetectedTime = 0;
-unsigned long brakingStartTime = 0;
+uint16_t brakingLatency = BRAKING_DEFAULT_LATENCY_MS;  // Most ms from the deceleration reaching the threshold to the brake light
 uint8_t brakingEffect = 0;  // 0 = flash, 1 = pulse
 uint8_t brakingBrightness = 255;  // Brightness during braking
 uint8_t brakingFlashCount = 0;  // Number of flashes completed (0-3)
@@ -484,10 +788,7 @@ unsigned long lastBrakingPulse = 0;
 const unsigned long BRAKING_FLASH_INTERVAL = 200;  // ms between flashes
 const unsigned long BRAKING_PULSE_DURATION = 300;  // ms per pulse cycle
 const uint8_t BRAKING_CYCLE_COUNT = 3;  // Number of flash/pulse cycles before going solid
-
-// Filtering for direction detection (to reduce noise)
-float filteredForwardAccel = 0.0;
-const float FILTER_ALPHA = 0.7;  // Low-pass filter coefficient (0.0-1.0, higher = less filtering)
+const uint8_t BRAKE_RELEASE_FADE_RATE = 32;  // Brake opacity change per frame on release (~200ms fade out)
 
 // Calibration system
 bool calibrationMode = false;
@@ -496,25 +797,9 @@ uint8_t calibrationStep = 0;
 unsigned long calibrationStartTime = 0;
 const unsigned long calibrationTimeout = 30000; // 30 seconds per step
 
-struct CalibrationData {
-    float levelAccelX, levelAccelY, levelAccelZ;
-    float forwardAccelX, forwardAccelY, forwardAccelZ;
-    float backwardAccelX, backwardAccelY, backwardAccelZ;
-    float leftAccelX, leftAccelY, leftAccelZ;
-    float rightAccelX, rightAccelY, rightAccelZ;
-    char forwardAxis = 'X';
-    char leftRightAxis = 'Y';
-    int forwardSign = 1;
-    int leftRightSign = 1;
-    bool valid = false;
-} calibration;
-
-// Motion data structure
-struct MotionData {
-    float pitch, roll, yaw;
-    float accelX, accelY, accelZ;
-    float gyroX, gyroY, gyroZ;
-};
+CalibrationData calibration;
+
+MotionData latestMotionData = {};       // Last sample the detectors saw (loop)
 
 // ESPNow Peer Management
 ESPNowPeer espNowPeers[10]; // Max 10 peers
@@ -564,23 +849,6 @@ void espNowSendCallback(const uint8_t *mac_addr, esp_now_send_status_t status) {
     }
 }
 
-// Speed normalization for consistent effect timing
-#define ARKLIGHTS_FPS 42
-#define FRAMETIME_FIXED (1000/ARKLIGHTS_FPS)
-#define MIN_FRAME_DELAY 2
-
-// Speed formula for length-normalized effects
-#define SPEED_FORMULA_L(speed, length) (5U + (50U*(255U - speed))/length)
-
-// Effect timing system
-struct EffectTiming {
-    unsigned long lastFrame = 0;
-    uint16_t frameTime = FRAMETIME_FIXED;
-    uint16_t step = 0;
-    uint16_t stepAccumulator = 0; // For fractional step increments
-    bool needsUpdate = false;
-};
-
 // Global timing variables (declared before ESP-NOW callbacks)
 EffectTiming headlightTiming;
 EffectTiming taillightTiming;
@@ -601,9 +869,16 @@ String formatMacAddress(const uint8_t* mac);
 bool parseMacAddress(const String& macStr, uint8_t* outMac);
 String formatColorHex(const CRGB& color);
 
+// ESP-NOW LED sync handed from the receive callback (Wi-Fi task) to loop(),
+// which owns the render settings. A newer packet replaces one not yet applied.
+ESPNowLEDData espNowPendingData;
+bool espNowPendingApply = false;
+portMUX_TYPE espNowPendingMutex = portMUX_INITIALIZER_UNLOCKED;
+
 void espNowReceiveCallback(const uint8_t *mac_addr, const uint8_t *data, int len) {
     // Only process if ESPNow is enabled
     if (!enableESPNow) return;
+    PerfScope perf(perfStats[PERF_ESPNOW_RECEIVE]);
     
     // Check if it's a group management packet
     if (data[0] == 'G') {
@@ -612,6 +887,7 @@ void espNowReceiveCallback(const uint8_t *mac_addr, const uint8_t *data, int len
             return;
         }
         handleGroupMessage(mac_addr, data, len);
+        wakeLoop(LOOP_EVENT_ESPNOW);
         return;
     }
     
@@ -658,53 +934,77 @@ void espNowReceiveCallback(const uint8_t *mac_addr, const uint8_t *data, int len
         }
     }
     
-    // Apply the received LED settings (but NOT motion-based effects)
+    // Applied by loop() on its next pass
+    portENTER_CRITICAL(&espNowPendingMutex);
+    espNowPendingData = *receivedData;
+    espNowPendingApply = true;
+    espNowCommandArrivalUs = micros();
+    portEXIT_CRITICAL(&espNowPendingMutex);
+    wakeLoop(LOOP_EVENT_ESPNOW);
+}
+
+// Apply the LED settings from the last ESP-NOW packet (but NOT motion-based effects).
+// Called by loop(); the render task picks them up from the next published snapshot.
+void applyPendingEspNowSync() {
+    ESPNowLEDData received;
+    uint32_t arrivalUs = 0;
+    bool shouldApply = false;
+    portENTER_CRITICAL(&espNowPendingMutex);
+    if (espNowPendingApply) {
+        espNowPendingApply = false;
+        received = espNowPendingData;
+        arrivalUs = espNowCommandArrivalUs;
+        espNowCommandArrivalUs = 0;
+        shouldApply = true;
+    }
+    portEXIT_CRITICAL(&espNowPendingMutex);
+    if (!shouldApply) return;
+    
     // Only sync main LED effects, not MPU-driven effects like blinkers or park mode
-    if (!blinkerActive && !parkModeActive) {
-        globalBrightness = receivedData->brightness;
-        headlightEffect = receivedData->headlightEffect;
-        taillightEffect = receivedData->taillightEffect;
-        effectSpeed = receivedData->effectSpeed;
-        headlightColor = CRGB(receivedData->headlightColor[0], receivedData->headlightColor[1], receivedData->headlightColor[2]);
-        taillightColor = CRGB(receivedData->taillightColor[0], receivedData->taillightColor[1], receivedData->taillightColor[2]);
-        headlightBackgroundEnabled = receivedData->headlightBackgroundEnabled;
-        taillightBackgroundEnabled = receivedData->taillightBackgroundEnabled;
-        headlightBackgroundColor = CRGB(receivedData->headlightBackgroundColor[0], receivedData->headlightBackgroundColor[1], receivedData->headlightBackgroundColor[2]);
-        taillightBackgroundColor = CRGB(receivedData->taillightBackgroundColor[0], receivedData->taillightBackgroundColor[1], receivedData->taillightBackgroundColor[2]);
-        currentPreset = receivedData->preset;
-        
-        // Sync timing for coordinated effects (ignore timestamps)
-        if (receivedData->masterStep > 0) {
-            headlightTiming.step = receivedData->masterStep;
-            taillightTiming.step = receivedData->masterStep;
-        }
-        
-        // Adjust speed for different strip lengths
-        if (receivedData->stripLength > 0) {
-            // Normalize speed based on strip length difference
-            uint8_t maxLength = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
-            uint8_t lengthRatio = (maxLength * 100) / receivedData->stripLength;
-            effectSpeed = constrain(effectSpeed * lengthRatio / 100, 0, 255);
-        }
-        
-        // Update LED strips
-        FastLED.setBrightness(globalBrightness);
-        
-        Serial.println("ESPNow: Applied LED settings from peer");
-    } else {
+    if (motion.blinkerActive || motion.parkModeActive) {
         Serial.println("ESPNow: Ignored sync due to active motion effects");
+        return;
+    }
+    
+    globalBrightness = received.brightness;
+    headlightEffect = received.headlightEffect;
+    taillightEffect = received.taillightEffect;
+    effectSpeed = received.effectSpeed;
+    headlightColor = CRGB(received.headlightColor[0], received.headlightColor[1], received.headlightColor[2]);
+    taillightColor = CRGB(received.taillightColor[0], received.taillightColor[1], received.taillightColor[2]);
+    headlightBackgroundEnabled = received.headlightBackgroundEnabled;
+    taillightBackgroundEnabled = received.taillightBackgroundEnabled;
+    headlightBackgroundColor = CRGB(received.headlightBackgroundColor[0], received.headlightBackgroundColor[1], received.headlightBackgroundColor[2]);
+    taillightBackgroundColor = CRGB(received.taillightBackgroundColor[0], received.taillightBackgroundColor[1], received.taillightBackgroundColor[2]);
+    currentPreset = received.preset;
+    commandArrivalUs = arrivalUs;
+    
+    // Sync timing for coordinated effects (ignore timestamps)
+    if (received.masterStep > 0) {
+        // Applied by the render task (it owns the effect clocks)
+        stepSyncStep = received.masterStep;
+        stepSyncCount++;
+    }
+    
+    // Adjust speed for different strip lengths
+    if (received.stripLength > 0) {
+        // Normalize speed based on strip length difference
+        uint16_t maxLength = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
+        uint32_t lengthRatio = (maxLength * 100) / received.stripLength;
+        effectSpeed = constrain(effectSpeed * lengthRatio / 100, 0, 255);
     }
+    
+    Serial.println("ESPNow: Applied LED settings from peer");
 }
 
 // Effect state
-unsigned long lastUpdate = 0;
-uint16_t effectStep = 0;
+unsigned long bleReadvertiseAt = 0;  // When the BLE client dropped (0 = not waiting to re-advertise)
 unsigned long lastEffectUpdate = 0;
 
 // Startup sequence state
 bool startupActive = false;
 unsigned long startupStartTime = 0;
-uint16_t startupStep = 0;
+uint16_t startupStep = 0;  // Render task's frame position in the startup sequence
 
 // WiFi AP Configuration
 String apName = "ARKLIGHTS-AP";
@@ -714,61 +1014,32 @@ String apPassword = "float420";
 
 // Function declarations
 void updateEffects();
-bool shouldUpdateEffect(EffectTiming& timing, uint8_t speed, uint8_t length);
-void processDirectionDetection(MotionData& data);
-void processBrakingDetection(MotionData& data);
+void startLoopEvents();
+EventBits_t waitForLoopWork();
+void swapLEDBuffers();
+void renderFrame();
+void runScheduledFrame();
+void onFrameTimer(void* arg);
+void waitForNextFrame();
+void queueLEDOutput(uint32_t commandUs);
+void recordCommandLatency(uint32_t commandUs);
+void ledOutputTask(void* parameter);
+void renderTask(void* parameter);
+void publishRenderSettings();
+void startRenderTask();
+void startPowerManagement();
+bool renderFrameIsStatic();
+bool renderIdleDue();
+void renderIdleWait();
+void renderPowerLocks(bool acquire);
+void renderBaseEffects();
 void showBrakingEffect();
-void blendLEDArrays(CRGB* target, CRGB* source1, CRGB* source2, uint8_t numLeds, float fadeProgress);
-void applyEffectToArray(CRGB* leds, uint8_t numLeds, uint8_t effect, CRGB color, EffectTiming& timing, uint8_t ledType, uint8_t colorOrder, CRGB backgroundColor, bool backgroundEnabled);
 void updateSoftAPChannel();
 
-// Original effect functions (kept for compatibility)
-void effectBreath(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectRainbow(CRGB* leds, uint8_t numLeds);
-void effectPulse(CRGB* leds, uint8_t numLeds, CRGB color);           // PEV-friendly: smooth rhythmic pulsing
-void effectBlinkRainbow(CRGB* leds, uint8_t numLeds);
-void effectGradientShift(CRGB* leds, uint8_t numLeds, CRGB color);   // PEV-friendly: moving color gradient
-void effectFire(CRGB* leds, uint8_t numLeds);
-void effectMeteor(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectWave(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectCenterBurst(CRGB* leds, uint8_t numLeds, CRGB color);     // PEV-friendly: center expansion
-void effectCandle(CRGB* leds, uint8_t numLeds);
-void effectStaticRainbow(CRGB* leds, uint8_t numLeds);
-void effectKnightRider(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectPolice(CRGB* leds, uint8_t numLeds);
-void effectStrobe(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectLarsonScanner(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectColorWipe(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectHazard(CRGB* leds, uint8_t numLeds, CRGB color);          // PEV-friendly: alternating halves
-void effectRunningLights(CRGB* leds, uint8_t numLeds, CRGB color);
-void effectColorSweep(CRGB* leds, uint8_t numLeds, CRGB color);
-
-// Improved effect functions with consistent timing
-void effectBreathImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectRainbowImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectPulseImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);           // PEV-friendly
-void effectBlinkRainbowImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectGradientShiftImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);   // PEV-friendly
-void effectFireImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectMeteorImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectWaveImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectCenterBurstImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);     // PEV-friendly
-void effectCandleImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectKnightRiderImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectPoliceImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectStrobeImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectLarsonScannerImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectColorWipeImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectRainbowWipeImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectHazardImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);          // PEV-friendly
-void effectRunningLightsImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectColorSweepImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectRainbowKnightRiderImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
-void effectDualKnightRiderImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step);
-void effectDualRainbowKnightRiderImproved(CRGB* leds, uint8_t numLeds, uint16_t step);
 void setPreset(uint8_t preset);
 void handleSerialCommands();
 void printStatus();
+void printFrameStats();
 void initDefaultPresets();
 void captureCurrentPreset(PresetConfig& preset);
 bool addPreset(const String& name);
@@ -784,6 +1055,7 @@ void cleanDuplicateFiles();
 // Startup sequence functions
 void startStartupSequence();
 void updateStartupSequence();
+void renderStartupSequence();
 void startupPowerOn();
 void startupScan();
 void startupWave();
@@ -793,20 +1065,26 @@ String getStartupSequenceName(uint8_t sequence);
 
 // Motion control functions
 void initMotionControl();
+void startMotionSampling();
 MotionData getMotionData();
-void updateMotionControl();
-void processBlinkers(MotionData& data);
-void processParkMode(MotionData& data);
-void processImpactDetection(MotionData& data);
+void buildMotionConfig(MotionConfig& config);
+void updateMotionControl(const MotionConfig& config, MotionData& data, uint32_t nowMs);
+void processMotionSamples();
+void serviceMotionStandby();
+bool startRecording();
+void startImpactCapture();
+void stopRecording();
+void serviceRecorder();
+void recordMotionSample(const MotionSample& sample);
+void handleRecordingDownload();
 void startCalibration();
 void captureCalibrationStep(MotionData& data);
 void resetCalibration();
 void completeCalibration();
-float getCalibratedForwardAccel(MotionData& data);
-float getCalibratedLeftRightAccel(MotionData& data);
 void showBlinkerEffect(int direction);
 void showParkEffect();
-void showImpactEffect();
+void updateImpactLayer();
+void bindLayerStacks();
 void resetToNormalEffects();
 
 // OTA Update functions
@@ -820,19 +1098,22 @@ void handleOTAError(int error);
 
 // LED Configuration functions
 void initializeLEDs();
+uint16_t clampLedCount(long count);
 void applyRgbwWhiteChannelMode();
+void showLEDs();
+bool ledFramesDirty();
+void invalidateShownFrames();
 void setRgbwWhiteMode(uint8_t mode);
 void testLEDConfiguration();
 String getLEDTypeName(uint8_t type);
 String getColorOrderName(uint8_t order);
-CRGB convertColorOrder(CRGB color, uint8_t colorOrder);
-void setLEDColor(CRGB* leds, uint8_t index, CRGB color, uint8_t ledType, uint8_t colorOrder);
-void fillSolidWithColorOrder(CRGB* leds, uint8_t numLeds, CRGB color, uint8_t ledType, uint8_t colorOrder);
-void applyColorOrderToArray(CRGB* leds, uint8_t numLeds, uint8_t ledType, uint8_t colorOrder);
-void fillRainbowWithColorOrder(CRGB* leds, uint8_t numLeds, uint8_t initialHue, uint8_t deltaHue, uint8_t ledType, uint8_t colorOrder);
 // Filesystem functions
 void initFilesystem();
 bool saveSettings();
+bool commitSettings();
+bool writeSettings();
+bool flushSettings();
+void serviceSettingsCache();
 bool loadSettings();
 bool saveSettingsToNVS();
 bool loadSettingsFromNVS();
@@ -846,6 +1127,7 @@ void addESPNowPeer(uint8_t* macAddress);
 void deinitESPNow();
 bool ensureESPNowActive(const char* context);
 const char* espNowErrorName(esp_err_t error);
+esp_err_t espNowSend(const uint8_t* peer, const uint8_t* data, size_t len);
 
 // Group Management functions
 void handleGroupMessage(const uint8_t* mac_addr, const uint8_t* data, int len);
@@ -888,10 +1170,16 @@ void handleAPI();
 void handleStatus();
 String getStatusJSON();
 void buildStatusDocument(DynamicJsonDocument& doc);
+void handleFrameStats();
+void handlePerf();
+void printPerfStats();
+void resetPerfStats();
+void buildFrameStatsDocument(DynamicJsonDocument& doc);
 void handleLEDConfig();
 void handleLEDTest();
 void handleGetSettings();
 void sendJSONResponse(DynamicJsonDocument& doc);
+void noteApiResponse(const char* transport);
 void restoreDefaultsToStock();
 String getDefaultApName();
 
@@ -900,15 +1188,23 @@ void setup() {
     Serial.println("ArkLights PEV Lighting System");
     Serial.println("==============================");
     
+    // loop() wakes on these (BLE, ESP-NOW and motion timer); create before any source starts
+    startLoopEvents();
+    
+    // Serializes the render task with code that writes the LEDs directly
+    ledMutex = xSemaphoreCreateRecursiveMutex();
+    ledOutputFence = xSemaphoreCreateBinary();
+    xSemaphoreGive(ledOutputFence);  // Nothing is being sent yet
+    
     // ⚡ FAST BOOT: Initialize LEDs FIRST for immediate visual feedback
     // Use default values if settings not loaded yet
     initializeLEDs();
     
     // Show a simple "booting" pattern immediately
-    fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::Blue, headlightLedType, headlightColorOrder);
-    fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::Blue, taillightLedType, taillightColorOrder);
+    fill_solid(headlight, headlightLedCount, CRGB::Blue);
+    fill_solid(taillight, taillightLedCount, CRGB::Blue);
     FastLED.setBrightness(64); // Low brightness for boot indicator
-    FastLED.show();
+    showLEDs();
     
     // Initialize filesystem (can be slow)
     initFilesystem();
@@ -942,12 +1238,18 @@ void setup() {
     } else {
         // Show loaded colors immediately
         Serial.println("⚡ Skipping startup sequence, showing loaded colors");
-        fillSolidWithColorOrder(headlight, headlightLedCount, headlightColor, headlightLedType, headlightColorOrder);
-        fillSolidWithColorOrder(taillight, taillightLedCount, taillightColor, taillightLedType, taillightColorOrder);
-        FastLED.show();
+        fill_solid(headlight, headlightLedCount, headlightColor);
+        fill_solid(taillight, taillightLedCount, taillightColor);
+        showLEDs();
         // Removed delay(1000) - no need to wait
     }
     
+    // Start rendering now so the startup sequence plays while the radios come up
+    perfEffectStats = &perfStats[PERF_EFFECT];
+    perfBlendStats = &perfStats[PERF_BLEND];
+    startPowerManagement();
+    startRenderTask();
+    
     Serial.printf("Headlight: %d LEDs on GPIO %d (Type: %s, Order: %s)\n", 
                   headlightLedCount, HEADLIGHT_PIN, 
                   getLEDTypeName(headlightLedType).c_str(),
@@ -981,9 +1283,22 @@ void setup() {
                   taillightColor.r, taillightColor.g, taillightColor.b);
     
     printHelp();
+    
+    bootSetupMs = millis();
+    Serial.printf("⏱️ Setup finished %lums after boot\n", (unsigned long)bootSetupMs);
 }
 
 void loop() {
+    // Sleep until a BLE/ESP-NOW/motion event (or the poll timeout) brings work
+    EventBits_t events = waitForLoopWork();
+    
+    // ESP-NOW sync packets are queued by the receive callback and applied here
+    applyPendingEspNowSync();
+    
+    if ((events & LOOP_EVENT_FRAME) && commandLatencyReport) {
+        Serial.printf("⏱️ Command-to-light: %luus\n", (unsigned long)lastCommandLatencyUs);
+    }
+    
     // Handle deferred NVS migration (non-blocking, happens once after boot)
     if (nvsMigrationPending) {
         Serial.println("🔄 Performing NVS migration in background...");
@@ -995,33 +1310,36 @@ void loop() {
         nvsMigrationPending = false;
     }
     
-    // Update startup sequence if active
-    if (startupActive) {
-        updateStartupSequence();
-        FastLED.show();
-        delay(50); // Slower update for startup sequences
-        return;
-    }
+    // Write settings out once the API has stopped changing them
+    serviceSettingsCache();
+    
+    // Startup sequence is drawn by the render task; loop() only ends it
+    updateStartupSequence();
     
-    // Update motion control at 20Hz
-    if (motionEnabled && millis() - lastMotionUpdate >= 50) {
-        updateMotionControl();
-        lastMotionUpdate = millis();
+    // Run the motion detectors over every sample the sensor task has queued
+    if (events & LOOP_EVENT_MOTION) {
+        PerfScope perf(perfStats[PERF_MOTION]);
+        processMotionSamples();
     }
+    serviceRecorder();
+    serviceMotionStandby();
     
-    // Update effects at 50 FPS
-    if (millis() - lastUpdate >= 20) {
-        updateEffects();
-        FastLED.show();
-        lastUpdate = millis();
+    // Effects are rendered by the render task; only fall back to loop() if it never started
+    if (renderTaskHandle == nullptr && frameClockWaitUs(frameClock, micros()) == 0) {
+        publishRenderSettings();
+        runScheduledFrame();
     }
     
-    // Handle BLE reconnection
+    // Handle BLE reconnection (give the bluetooth stack 500ms to get things ready)
     if (!deviceConnected && oldDeviceConnected) {
-        delay(500); // give the bluetooth stack the chance to get things ready
-        pBLEServer->startAdvertising(); // restart advertising
-        Serial.println("BLE: Start advertising");
-        oldDeviceConnected = deviceConnected;
+        if (bleReadvertiseAt == 0) {
+            bleReadvertiseAt = millis();
+        } else if (millis() - bleReadvertiseAt >= 500) {
+            pBLEServer->startAdvertising(); // restart advertising
+            Serial.println("BLE: Start advertising");
+            oldDeviceConnected = deviceConnected;
+            bleReadvertiseAt = 0;
+        }
     }
     
     // Check if a new client connected
@@ -1046,7 +1364,10 @@ void loop() {
     handleSerialCommands();
     
     // Handle web server requests
-    server.handleClient();
+    {
+        PerfScope perf(perfStats[PERF_HTTP]);
+        server.handleClient();
+    }
 
     // Process queued BLE requests outside BT task
     String pendingBleRequest = "";
@@ -1066,12 +1387,14 @@ void loop() {
     // Apply deferred BLE API updates outside BT task
     String pendingJsonCopy = "";
     bool shouldApplyPending = false;
+    uint32_t pendingArrivalUs = 0;
     portENTER_CRITICAL(&blePendingMutex);
     if (blePendingApply) {
         shouldApplyPending = true;
         blePendingApply = false;
         pendingJsonCopy = blePendingJson;
         blePendingJson = "";
+        pendingArrivalUs = bleCommandArrivalUs;
     }
     portEXIT_CRITICAL(&blePendingMutex);
 
@@ -1083,8 +1406,10 @@ void loop() {
         } else {
             bool shouldRestart = false;
             applyApiJson(doc, true, shouldRestart);
+            commandArrivalUs = pendingArrivalUs;
             if (shouldRestart) {
                 delay(1000);
+                flushSettings();
                 ESP.restart();
             }
         }
@@ -1118,267 +1443,504 @@ void loop() {
         );
     }
     
-    delay(10);
-}
-
-// Helper function to get effect-specific speed multiplier
-// With the new consistent frame rate system, multipliers are reduced since speed control works better
-uint8_t getEffectSpeedMultiplier(uint8_t effect) {
-    switch (effect) {
-        case FX_RAINBOW:
-        case FX_BLINK_RAINBOW:
-            return 2; // Rainbow effects: slight boost for visibility (reduced from 8x)
-        case FX_PULSE:
-        case FX_METEOR:
-        case FX_CENTER_BURST:
-            return 1; // Movement effects: normal speed (removed multiplier)
-        case FX_WAVE:
-        case FX_COLOR_WIPE:
-        case FX_RAINBOW_WIPE:
-        case FX_HAZARD:
-        case FX_RUNNING_LIGHTS:
-        case FX_COLOR_SWEEP:
-        case FX_RAINBOW_KNIGHT_RIDER:
-        case FX_DUAL_KNIGHT_RIDER:
-        case FX_DUAL_RAINBOW_KNIGHT_RIDER:
-            return 1; // Sweep effects: normal speed (removed multiplier)
-        default:
-            return 1; // Other effects: normal speed
+    // Hand this pass's settings and motion state to the render task
+    publishRenderSettings();
+}
+
+// Create the loop() event group
+void startLoopEvents() {
+    loopEvents = xEventGroupCreate();
+}
+
+// Block until an event source has work for loop(). HTTP (synchronous
+// WebServer) and serial have no wake-up source, so they bound the sleep.
+EventBits_t waitForLoopWork() {
+    if (loopEvents == nullptr) {
+        delay(10);
+        return LOOP_EVENT_ALL;
     }
+    
+    uint32_t waitMs = WiFi.softAPgetStationNum() > 0 ? LOOP_HTTP_POLL_MS : LOOP_IDLE_WAIT_MS;
+    if (renderTaskHandle == nullptr) {
+        // loop() renders itself - wake for the next frame deadline
+        uint32_t frameWaitMs = frameClockWaitUs(frameClock, micros()) / 1000;
+        if (frameWaitMs < waitMs) waitMs = frameWaitMs;
+    }
+    
+    // At least one tick: with a 100Hz tick the 5ms HTTP poll would round to 0 and spin
+    TickType_t waitTicks = pdMS_TO_TICKS(waitMs);
+    if (waitTicks == 0) waitTicks = 1;
+    EventBits_t events = xEventGroupWaitBits(loopEvents, LOOP_EVENT_ALL, pdTRUE, pdFALSE, waitTicks);
+    loopWakeups++;
+    return events;
 }
 
-// Improved timing system: Keep frame rate high, control speed via step increment
-// This prevents stuttering while still allowing speed control
-bool shouldUpdateEffect(EffectTiming& timing, uint8_t speed, uint8_t length) {
-    unsigned long now = millis();
+// Render one frame into the back frames. Every scheduled frame renders; the
+// show gate drops frames that come out unchanged.
+void updateEffects() {
+    const RenderSettings& rs = renderSettings;
+    
+    // Effect clocks belong to the render task - apply ESP-NOW step syncs here
+    static uint32_t appliedStepSync = 0;
+    if (rs.stepSyncCount != appliedStepSync) {
+        appliedStepSync = rs.stepSyncCount;
+        effectClockSetStep(headlightTiming, rs.stepSyncStep);
+        effectClockSetStep(taillightTiming, rs.stepSyncStep);
+    }
+    
+    // Effects advance by the real time since the last frame (park effect runs at its own speed)
+    uint8_t speed = motionState.parkModeActive ? rs.parkEffectSpeed : rs.effectSpeed;
+    uint32_t nowUs = micros();
+    effectClockAdvance(headlightTiming, nowUs, speed);
+    effectClockAdvance(taillightTiming, nowUs, speed);
+    updateImpactLayer();
+    
+    // Base layer: effects render into the base frames, overlays are stacked on top below
+    if (rs.startupActive) {
+        // Priority 0: Startup sequence (runs until loop() ends it)
+        renderStartupSequence();
+    } else if (motionState.parkModeActive) {
+        // Priority 1: Park mode (replaces the normal effects, brake and blinker overlays stay off)
+        showParkEffect();
+    } else {
+        renderBaseEffects();
+    }
     
-    // Always use a consistent, high frame rate (~24ms = ~42 FPS)
-    // This keeps effects smooth and prevents stuttering
-    timing.frameTime = FRAMETIME_FIXED;
+    // Overlay layers (brake, blinker, impact) - fades advance once per frame
+    showBrakingEffect();
+    showBlinkerEffect(motionState.blinkerDirection);
+    layerStackStep(headlightLayers);
+    layerStackStep(taillightLayers);
     
-    if (now - timing.lastFrame >= timing.frameTime) {
-        timing.lastFrame = now;
-        
-        // Control speed by adjusting step increment instead of frame rate
-        // Speed 0 = very slow (step increments by 0.1 per frame)
-        // Speed 255 = very fast (step increments by 8.0 per frame)
-        // Map speed to step increment: 0-255 -> 10 to 800 (scaled by 100 for fractional steps)
-        uint16_t stepIncrement = map(speed, 0, 255, 10, 800); // 0.1 to 8.0 steps per frame (scaled by 100)
-        
-        // Apply step increment with fractional precision
-        // This allows smooth speed control without stuttering
-        timing.stepAccumulator += stepIncrement;
-        if (timing.stepAccumulator >= 100) {
-            timing.step += (timing.stepAccumulator / 100);
-            timing.stepAccumulator = timing.stepAccumulator % 100;
+    // Flatten each strip's stack into its back frame in a single pass
+    compositeLayers(headlightBack, headlightLedCount, headlightLayers);
+    compositeLayers(taillightBack, taillightLedCount, taillightLayers);
+}
+
+// Make the freshly composited back frames the ones the controllers send
+void swapLEDBuffers() {
+    if (headlightBack != headlight) {
+        CRGB* front = headlightBack;
+        headlightBack = headlight;
+        headlight = front;
+        if (headlightController != nullptr) headlightController->setLeds(headlight, headlightLedCount);
+    }
+    if (taillightBack != taillight) {
+        CRGB* front = taillightBack;
+        taillightBack = taillight;
+        taillight = front;
+        if (taillightController != nullptr) taillightController->setLeds(taillight, taillightLedCount);
+    }
+}
+
+// One render frame: snapshot the settings, render into the back frames, swap
+// them to the front and push them out. Runs on the render task (or in loop()
+// if the task could not be started).
+void renderFrame() {
+    // Snapshot under the LED lock so a direct writer that publishes
+    // outputHeld before drawing is never painted over
+    LEDLock lock(false);
+    renderSnapshotSequence = renderSettingsLock.sequence.load(std::memory_order_acquire);
+    renderSnapshotRetries += seqlockRead(renderSettingsLock, renderSettings);
+    motionSnapshotSequence = motionStateLock.sequence.load(std::memory_order_acquire);
+    renderSnapshotRetries += seqlockRead(motionStateLock, motionState);
+    if (renderSettings.outputHeld) return;  // OTA progress owns the LEDs
+    
+    // First frame rendered from a new command carries its arrival time to the output
+    static uint32_t lastCommandUs = 0;
+    uint32_t frameCommandUs = 0;
+    if (renderSettings.commandUs != lastCommandUs) {
+        lastCommandUs = renderSettings.commandUs;
+        frameCommandUs = renderSettings.commandUs;
+    }
+    
+    // Without back frames the effects render straight into the frames being sent
+    if (headlightBack == headlight || taillightBack == taillight) {
+        waitLEDOutput();
+    }
+    
+    uint32_t renderStart = micros();
+    updateEffects();
+    uint32_t renderUs = micros() - renderStart;
+    
+    // Fence: the previous frame must be fully sent before its buffers become the back frames
+    if (xSemaphoreTake(ledOutputFence, 0) != pdTRUE) {
+        ledOutputFenceWaits++;
+        xSemaphoreTake(ledOutputFence, portMAX_DELAY);
+    }
+    // The output task is idle while the fence is held - safe to clear its histogram too
+    if (frameStatsResetPending) {
+        frameHistogramReset(frameIntervalHistogram);
+        frameHistogramReset(renderTimeHistogram);
+        frameHistogramReset(showTimeHistogram);
+        frameHistogramReset(commandLatencyHistogram);
+        frameClock.dropped = 0;
+        frameStatsResetPending = false;
+    }
+    frameHistogramRecord(renderTimeHistogram, renderUs);
+    
+    swapLEDBuffers();
+    if (asyncLedOutput && ledOutputTaskHandle != nullptr) {
+        queueLEDOutput(frameCommandUs);  // Gives the fence back once sent (or right away if unchanged)
+    } else {
+        uint32_t sentBefore = framesSent;
+        uint32_t showStart = micros();
+        showLEDs();
+        if (framesSent != sentBefore) {
+            frameHistogramRecord(showTimeHistogram, micros() - showStart);
         }
-        
-        return true;
+        if (frameCommandUs != 0) recordCommandLatency(frameCommandUs);
+        xSemaphoreGive(ledOutputFence);
+    }
+    if (renderFrames++ == 0) {
+        bootFirstFrameMs = millis();
     }
-    return false;
 }
 
-// Helper function to blend two LED arrays with fade progress
-void blendLEDArrays(CRGB* target, CRGB* source1, CRGB* source2, uint8_t numLeds, float fadeProgress) {
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Blend between source1 (old) and source2 (new) based on fadeProgress
-        // fadeProgress 0.0 = all source1, 1.0 = all source2
-        float r = source1[i].r + (source2[i].r - source1[i].r) * fadeProgress;
-        float g = source1[i].g + (source2[i].g - source1[i].g) * fadeProgress;
-        float b = source1[i].b + (source2[i].b - source1[i].b) * fadeProgress;
-        target[i].r = (uint8_t)constrain(r, 0, 255);
-        target[i].g = (uint8_t)constrain(g, 0, 255);
-        target[i].b = (uint8_t)constrain(b, 0, 255);
+// Start a frame on the frame clock's schedule and render it
+void runScheduledFrame() {
+    uint32_t intervalUs = frameClockBegin(frameClock, micros());
+    if (intervalUs > 0 && !frameClockResync) {
+        frameHistogramRecord(frameIntervalHistogram, intervalUs);
+    }
+    frameClockResync = false;
+    uint32_t sentBefore = framesSent;
+    renderFrame();
+    if (framesSent == sentBefore && renderFrameIsStatic()) {
+        if (renderStaticFrames < POWER_IDLE_STATIC_FRAMES) renderStaticFrames++;
+    } else {
+        renderStaticFrames = 0;
+    }
+    
+    if (renderSettings.targetFps != frameClockFps(frameClock)) {
+        frameClockSetFps(frameClock, renderSettings.targetFps);
     }
 }
 
-// Helper function to apply effect to LED array
-void applyEffectToArray(CRGB* leds, uint8_t numLeds, uint8_t effect, CRGB color, EffectTiming& timing, uint8_t ledType, uint8_t colorOrder, CRGB backgroundColor, bool backgroundEnabled) {
-    effectBackgroundEnabled = backgroundEnabled;
-    effectBackgroundColor = backgroundColor;
-    switch (effect) {
-        case FX_SOLID:
-            fillSolidWithColorOrder(leds, numLeds, color, ledType, colorOrder);
-            break;
-        case FX_BREATH:
-            effectBreathImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_RAINBOW:
-            effectRainbowImproved(leds, numLeds, timing.step);
-            break;
-        case FX_PULSE:
-            effectPulseImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_BLINK_RAINBOW:
-            effectBlinkRainbowImproved(leds, numLeds, timing.step);
-            break;
-        case FX_GRADIENT_SHIFT:
-            effectGradientShiftImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_FIRE:
-            effectFireImproved(leds, numLeds, timing.step);
-            break;
-        case FX_METEOR:
-            effectMeteorImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_WAVE:
-            effectWaveImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_CENTER_BURST:
-            effectCenterBurstImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_CANDLE:
-            effectCandleImproved(leds, numLeds, timing.step);
-            break;
-        case FX_STATIC_RAINBOW:
-            effectStaticRainbow(leds, numLeds);
-            break;
-        case FX_KNIGHT_RIDER:
-            effectKnightRiderImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_POLICE:
-            effectPoliceImproved(leds, numLeds, timing.step);
-            break;
-        case FX_STROBE:
-            effectStrobeImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_LARSON_SCANNER:
-            effectLarsonScannerImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_COLOR_WIPE:
-            effectColorWipeImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_RAINBOW_WIPE:
-            effectRainbowWipeImproved(leds, numLeds, timing.step);
-            break;
-        case FX_HAZARD:
-            effectHazardImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_RUNNING_LIGHTS:
-            effectRunningLightsImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_COLOR_SWEEP:
-            effectColorSweepImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_RAINBOW_KNIGHT_RIDER:
-            effectRainbowKnightRiderImproved(leds, numLeds, timing.step);
-            break;
-        case FX_DUAL_KNIGHT_RIDER:
-            effectDualKnightRiderImproved(leds, numLeds, color, timing.step);
-            break;
-        case FX_DUAL_RAINBOW_KNIGHT_RIDER:
-            effectDualRainbowKnightRiderImproved(leds, numLeds, timing.step);
-            break;
+void onFrameTimer(void* arg) {
+    xTaskNotifyGive(renderTaskHandle);
+}
+
+// Sleep until the next frame deadline. A frame that overran its deadline
+// still yields for a tick so the idle task on this core keeps running.
+void waitForNextFrame() {
+    uint32_t waitUs = frameClockWaitUs(frameClock, micros());
+    if (waitUs == 0) {
+        vTaskDelay(1);
+    } else if (frameTimer != nullptr && esp_timer_start_once(frameTimer, waitUs) == ESP_OK) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    } else {
+        // Round up to whole ticks (10ms at the board's 100Hz tick) so the deadline is never early
+        uint32_t tickUs = portTICK_PERIOD_MS * 1000;
+        vTaskDelay((waitUs + tickUs - 1) / tickUs);
     }
-    // Apply color order conversion for RGBW LEDs (FX_SOLID already handles this)
-    if (effect != FX_SOLID) {
-        applyColorOrderToArray(leds, numLeds, ledType, colorOrder);
+}
+
+// Hand the front frames to the output task. Called with the fence taken.
+// commandUs is the arrival time of a command first shown in this frame (0 = none).
+void queueLEDOutput(uint32_t commandUs) {
+    if (!ledFramesDirty()) {
+        // Strips already show this frame - the command is on the lights now
+        if (commandUs != 0) recordCommandLatency(commandUs);
+        framesSkipped++;
+        xSemaphoreGive(ledOutputFence);
+        return;
     }
+    ledOutputBrightness = FastLED.getBrightness();
+    ledOutputCommandUs = commandUs;
+    framesSent++;
+    xTaskNotifyGive(ledOutputTaskHandle);
 }
 
-void updateEffects() {
-    // Use timing system for consistent effect speeds
-    bool headlightUpdate = shouldUpdateEffect(headlightTiming, effectSpeed, headlightLedCount);
-    bool taillightUpdate = shouldUpdateEffect(taillightTiming, effectSpeed, taillightLedCount);
-    
-    // Only update if timing allows it, UNLESS we're in a fade or manual effects are active
-    if (!headlightUpdate && !taillightUpdate && !directionChangePending && !blinkerActive && !brakingActive) {
+// End of a command-to-light measurement: the frame is on the strips
+void recordCommandLatency(uint32_t commandUs) {
+    lastCommandLatencyUs = micros() - commandUs;
+    frameHistogramRecord(commandLatencyHistogram, lastCommandLatencyUs);
+    wakeLoop(LOOP_EVENT_FRAME);
+}
+
+// Sends queued frames. FastLED.show() blocks until the RMT has clocked both
+// strips out; the render task is already working on the next frame meanwhile.
+void ledOutputTask(void* parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t start = micros();
+        {
+            PerfScope perf(perfStats[PERF_SHOW]);
+            FastLED.show(ledOutputBrightness);
+        }
+        ledOutputShowUs = micros() - start;
+        frameHistogramRecord(showTimeHistogram, ledOutputShowUs);
+        if (ledOutputCommandUs != 0) {
+            recordCommandLatency(ledOutputCommandUs);
+            ledOutputCommandUs = 0;
+        }
+        xSemaphoreGive(ledOutputFence);
+    }
+}
+
+void renderTask(void* parameter) {
+    for (;;) {
+        runScheduledFrame();
+        if (renderIdleDue()) {
+            renderIdleWait();
+        } else {
+            renderIdle = false;
+            waitForNextFrame();
+        }
+    }
+}
+
+// True when the frame only depends on the published settings: no animated
+// effect, overlay, startup sequence or direction fade
+bool renderFrameIsStatic() {
+    const RenderSettings& rs = renderSettings;
+    if (rs.outputHeld || rs.startupActive || motionState.brakingActive || motionState.blinkerActive || motionState.directionChangePending) {
+        return false;
+    }
+    if (motionState.parkModeActive) return !effectIsAnimated(rs.parkEffect);
+    return !effectIsAnimated(rs.headlightEffect) && !effectIsAnimated(rs.taillightEffect);
+}
+
+// Park once a static frame has gone out unchanged for a while (overlay and
+// impact fades still change the frame, so they keep the render task awake)
+bool renderIdleDue() {
+    return renderSettings.powerSave && !renderSettings.clientConnected &&
+           renderStaticFrames >= POWER_IDLE_STATIC_FRAMES;
+}
+
+void renderPowerLocks(bool acquire) {
+#if CONFIG_PM_ENABLE
+    if (renderCpuLock == nullptr || renderSleepLock == nullptr) return;
+    if (acquire) {
+        esp_pm_lock_acquire(renderCpuLock);
+        esp_pm_lock_acquire(renderSleepLock);
+    } else {
+        esp_pm_lock_release(renderSleepLock);
+        esp_pm_lock_release(renderCpuLock);
+    }
+#endif
+}
+
+// Sleep until loop() publishes different settings, redrawing every
+// POWER_IDLE_REFRESH_MS. The frame clock restarts on wake so the idle gap
+// isn't counted as dropped frames.
+void renderIdleWait() {
+    waitLEDOutput();  // Last frame fully sent before the clocks may drop
+    if (!renderIdle) {
+        renderIdle = true;
+        powerIdleEntries++;
+    }
+    // A wake sent before this frame was rendered is stale - drop it so it can't end the park
+    ulTaskNotifyValueClear(nullptr, UINT32_MAX);
+    // Settings or motion state published since this frame's snapshot: render them right away
+    if (renderSettingsLock.sequence.load(std::memory_order_acquire) != renderSnapshotSequence ||
+        motionStateLock.sequence.load(std::memory_order_acquire) != motionSnapshotSequence) {
         return;
     }
     
-    // Priority 1: Park mode (highest priority - overrides everything)
-    if (parkModeActive) {
-        showParkEffect();
-        return; // Skip normal effects when in park mode
+    uint32_t parkedAt = millis();
+    renderPowerLocks(false);
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_IDLE_REFRESH_MS));
+    renderPowerLocks(true);
+    renderParkedMs += millis() - parkedAt;
+    frameClock.running = false;
+    frameClockResync = true;
+}
+
+// Wake the render task if it is parked in renderIdleWait()
+inline void wakeIdleRenderTask() {
+    if (renderIdle && renderTaskHandle != nullptr) {
+        xTaskNotifyGive(renderTaskHandle);
+    }
+}
+
+// Publish the detector results the render path reads (loop() only, after
+// every motion sample and once per pass for API overrides). Unchanged state
+// is not re-published.
+void publishMotionState() {
+    static MotionState published;
+    MotionState state;
+    memset(&state, 0, sizeof(state));  // Padding too - compared with memcmp
+    state.isMovingForward = motion.isMovingForward;
+    state.directionChangePending = motion.directionChangePending;
+    state.directionFadeProgress = motion.directionFadeProgress;
+    state.parkModeActive = motion.parkModeActive;
+    state.brakingActive = motion.brakingActive;
+    state.brakingStartTime = motion.brakingStartTime;
+    state.blinkerActive = motion.blinkerActive;
+    state.blinkerDirection = motion.blinkerDirection;
+    state.impactCount = motion.impactCount;
+    if (memcmp(&state, &published, sizeof(state)) == 0) return;
+    published = state;
+    seqlockWrite(motionStateLock, state);
+    wakeIdleRenderTask();
+}
+
+// Publish the settings and motion state the render path reads (called by loop()
+// once per pass). Unchanged settings are not re-published, so an idle render
+// task is only woken by a real change.
+void publishRenderSettings() {
+    publishMotionState();
+    
+    static RenderSettings published;
+    RenderSettings settings;
+    memset(&settings, 0, sizeof(settings));  // Padding too - compared with memcmp
+    settings.brightness = globalBrightness;
+    settings.effectSpeed = effectSpeed;
+    settings.headlightEffect = headlightEffect;
+    settings.taillightEffect = taillightEffect;
+    settings.headlightColor = headlightColor;
+    settings.taillightColor = taillightColor;
+    settings.headlightBackgroundEnabled = headlightBackgroundEnabled;
+    settings.taillightBackgroundEnabled = taillightBackgroundEnabled;
+    settings.headlightBackgroundColor = headlightBackgroundColor;
+    settings.taillightBackgroundColor = taillightBackgroundColor;
+    settings.headlightMode = headlightMode;
+    settings.directionBasedLighting = directionBasedLighting;
+    settings.parkEffect = parkEffect;
+    settings.parkEffectSpeed = parkEffectSpeed;
+    settings.parkBrightness = parkBrightness;
+    settings.parkHeadlightColor = parkHeadlightColor;
+    settings.parkTaillightColor = parkTaillightColor;
+    settings.brakingEffect = brakingEffect;
+    settings.brakingBrightness = brakingBrightness;
+    settings.stepSyncStep = stepSyncStep;
+    settings.stepSyncCount = stepSyncCount;
+    settings.startupActive = startupActive;
+    settings.startupSequence = startupSequence;
+    settings.startupDuration = startupDuration;
+    settings.startupStartTime = startupStartTime;
+    settings.outputHeld = otaInProgress;
+    settings.targetFps = targetFps;
+    if (commandArrivalUs != 0) {
+        publishedCommandUs = commandArrivalUs;
+        commandArrivalUs = 0;
+    }
+    settings.commandUs = publishedCommandUs;
+    settings.powerSave = powerSaveEnabled;
+    settings.clientConnected = deviceConnected || WiFi.softAPgetStationNum() > 0;
+    if (memcmp(&settings, &published, sizeof(settings)) == 0) return;
+    published = settings;
+    seqlockWrite(renderSettingsLock, settings);
+    wakeIdleRenderTask();
+}
+
+// Dynamic frequency scaling and automatic light sleep for the idle power mode.
+// The render task holds its PM locks except while it is parked.
+void startPowerManagement() {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32s3_t config = {};
+    config.max_freq_mhz = getCpuFrequencyMhz();
+    config.min_freq_mhz = POWER_MIN_FREQ_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    config.light_sleep_enable = true;
+#endif
+    esp_err_t err = esp_pm_configure(&config);
+    if (err != ESP_OK) {
+        Serial.printf("⚠️ Power management unavailable (%s) - idle mode only parks the render task\n", esp_err_to_name(err));
+        return;
     }
-    
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "render", &renderCpuLock) != ESP_OK ||
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "render", &renderSleepLock) != ESP_OK) {
+        renderCpuLock = nullptr;
+        renderSleepLock = nullptr;
+        Serial.println("⚠️ Render PM locks unavailable - idle mode only parks the render task");
+        return;
+    }
+    renderPowerLocks(true);  // Released only while the render task is parked
+    powerLightSleep = config.light_sleep_enable;
+    Serial.printf("🔋 Power management: %d-%d MHz, light sleep %s\n", config.min_freq_mhz, config.max_freq_mhz,
+                  powerLightSleep ? "on" : "off (no tickless idle)");
+#else
+    Serial.println("🔋 Power management not built in (CONFIG_PM_ENABLE) - idle mode only parks the render task");
+#endif
+}
+
+void startRenderTask() {
+    publishRenderSettings();
+    frameClockSetFps(frameClock, targetFps);
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onFrameTimer;
+    timerArgs.name = "frame";
+    if (esp_timer_create(&timerArgs, &frameTimer) != ESP_OK) {
+        frameTimer = nullptr;
+        Serial.println("⚠️ Frame timer unavailable - frame deadlines rounded to the tick");
+    }
+    BaseType_t outputCreated = xTaskCreatePinnedToCore(ledOutputTask, "ledout", LED_OUTPUT_TASK_STACK_SIZE, nullptr,
+                                                       LED_OUTPUT_TASK_PRIORITY, &ledOutputTaskHandle, RENDER_TASK_CORE);
+    if (outputCreated != pdPASS) {
+        ledOutputTaskHandle = nullptr;
+        Serial.println("⚠️ LED output task failed to start - frames are sent synchronously");
+    }
+    
+    BaseType_t created = xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK_SIZE, nullptr,
+                                                 RENDER_TASK_PRIORITY, &renderTaskHandle, RENDER_TASK_CORE);
+    if (created != pdPASS) {
+        renderTaskHandle = nullptr;
+        Serial.println("❌ Render task failed to start - rendering from loop()");
+        return;
+    }
+    Serial.printf("🎨 Render task running on core %d at %d fps (loop() on core %d)\n", RENDER_TASK_CORE, frameClockFps(frameClock), xPortGetCoreID());
+}
+
+// Render the normal (or direction-based) effects into the base frames
+void renderBaseEffects() {
+    const RenderSettings& rs = renderSettings;
     // Priority 3: Normal effects (lowest priority - default behavior)
     // Restore normal brightness
-    FastLED.setBrightness(globalBrightness);
+    FastLED.setBrightness(rs.brightness);
     
     // Direction-based lighting mode
-    if (directionBasedLighting) {
+    if (rs.directionBasedLighting) {
         // Determine which lights are "front" (headlight) and "back" (taillight) based on direction
-        CRGB* frontLights = isMovingForward ? headlight : taillight;
-        CRGB* backLights = isMovingForward ? taillight : headlight;
-        uint8_t frontCount = isMovingForward ? headlightLedCount : taillightLedCount;
-        uint8_t backCount = isMovingForward ? taillightLedCount : headlightLedCount;
-        uint8_t frontLedType = isMovingForward ? headlightLedType : taillightLedType;
-        uint8_t backLedType = isMovingForward ? taillightLedType : headlightLedType;
-        uint8_t frontColorOrder = isMovingForward ? headlightColorOrder : taillightColorOrder;
-        uint8_t backColorOrder = isMovingForward ? taillightColorOrder : headlightColorOrder;
-        EffectTiming& frontTiming = isMovingForward ? headlightTiming : taillightTiming;
-        EffectTiming& backTiming = isMovingForward ? taillightTiming : headlightTiming;
-        bool frontUpdate = isMovingForward ? headlightUpdate : taillightUpdate;
-        bool backUpdate = isMovingForward ? taillightUpdate : headlightUpdate;
+        CRGB* frontLights = motionState.isMovingForward ? headlightBase : taillightBase;
+        CRGB* backLights = motionState.isMovingForward ? taillightBase : headlightBase;
+        uint16_t frontCount = motionState.isMovingForward ? headlightLedCount : taillightLedCount;
+        uint16_t backCount = motionState.isMovingForward ? taillightLedCount : headlightLedCount;
+        EffectTiming& frontTiming = motionState.isMovingForward ? headlightTiming : taillightTiming;
+        EffectTiming& backTiming = motionState.isMovingForward ? taillightTiming : headlightTiming;
         
-        // Static arrays for fade blending (sized to maximum possible)
-        static CRGB* headlightOld = nullptr;
-        static CRGB* taillightOld = nullptr;
-        static bool arraysInitialized = false;
+        // Fade snapshots live in the frame arena (sized for the current LED config)
+        CRGB* headlightOld = frameArena.slot(FRAME_HEADLIGHT_OLD);
+        CRGB* taillightOld = frameArena.slot(FRAME_TAILLIGHT_OLD);
         static bool fadeStateSaved = false;  // Track if we've saved state for current fade
         
-        if (!arraysInitialized) {
-            uint8_t maxCount = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
-            headlightOld = new CRGB[maxCount];
-            taillightOld = new CRGB[maxCount];
-            arraysInitialized = true;
-        }
-        
         // Handle fade transition (including 100% completion frame)
-        if (directionChangePending && directionFadeProgress >= 0.0 && directionFadeProgress <= 1.0) {
+        if (motionState.directionChangePending && motionState.directionFadeProgress >= 0.0 && motionState.directionFadeProgress <= 1.0 && frameArena.block != nullptr) {
             // During fade: blend between old and new directions
-            // Note: isMovingForward is still the OLD direction during fade
-            bool newDirection = !isMovingForward;
+            // Note: motionState.isMovingForward is still the OLD direction during fade
+            bool newDirection = !motionState.isMovingForward;
             
-            // Save current state on FIRST frame of fade (when fadeProgress is exactly 0.0)
-            // This captures what's currently displayed BEFORE we start blending
-            if (directionFadeProgress == 0.0 && !fadeStateSaved) {
-                // Save from the arrays that are currently being displayed (based on OLD direction)
-                CRGB* currentFrontLights = isMovingForward ? headlight : taillight;
-                CRGB* currentBackLights = isMovingForward ? taillight : headlight;
-                uint8_t currentFrontCount = isMovingForward ? headlightLedCount : taillightLedCount;
-                uint8_t currentBackCount = isMovingForward ? taillightLedCount : headlightLedCount;
-                
-                // Save to the appropriate old arrays
-                memcpy(isMovingForward ? headlightOld : taillightOld, currentFrontLights, currentFrontCount * sizeof(CRGB));
-                memcpy(isMovingForward ? taillightOld : headlightOld, currentBackLights, currentBackCount * sizeof(CRGB));
+            // Save current state on the first frame that sees the fade. Detectors run per
+            // sample, so progress has usually moved past 0 by then; the base frames still
+            // hold the last old-direction frame (without overlays) until we blend over them
+            if (!fadeStateSaved) {
+                memcpy(headlightOld, headlightBase, headlightLedCount * sizeof(CRGB));
+                memcpy(taillightOld, taillightBase, taillightLedCount * sizeof(CRGB));
                 fadeStateSaved = true;
             }
-            
-            // Reset flag when fade completes
-            if (directionFadeProgress >= 1.0 && !directionChangePending) {
-                fadeStateSaved = false;
-            }
-            CRGB* newFrontLights = newDirection ? headlight : taillight;
-            CRGB* newBackLights = newDirection ? taillight : headlight;
-            uint8_t newFrontCount = newDirection ? headlightLedCount : taillightLedCount;
-            uint8_t newBackCount = newDirection ? taillightLedCount : headlightLedCount;
-            uint8_t newFrontLedType = newDirection ? headlightLedType : taillightLedType;
-            uint8_t newBackLedType = newDirection ? taillightLedType : headlightLedType;
-            uint8_t newFrontColorOrder = newDirection ? headlightColorOrder : taillightColorOrder;
-            uint8_t newBackColorOrder = newDirection ? taillightColorOrder : headlightColorOrder;
+            uint16_t newFrontCount = newDirection ? headlightLedCount : taillightLedCount;
+            uint16_t newBackCount = newDirection ? taillightLedCount : headlightLedCount;
             EffectTiming& newFrontTiming = newDirection ? headlightTiming : taillightTiming;
             EffectTiming& newBackTiming = newDirection ? taillightTiming : headlightTiming;
             
-            // Render new direction effects to temporary arrays
-            CRGB* newFrontTemp = new CRGB[newFrontCount];
-            CRGB* newBackTemp = new CRGB[newBackCount];
+            // Render new direction effects to scratch frames
+            CRGB* newFrontTemp = frameArena.slot(FRAME_FRONT_NEW);
+            CRGB* newBackTemp = frameArena.slot(FRAME_BACK_NEW);
             
             // Apply front light effect (headlight mode: solid white or effect)
-            if (frontUpdate || backUpdate) {
-                if (headlightMode == 0) {
-                    // Solid white
-                    fillSolidWithColorOrder(newFrontTemp, newFrontCount, CRGB::White, newFrontLedType, newFrontColorOrder);
-                } else {
-                    // Headlight effect
-                    applyEffectToArray(newFrontTemp, newFrontCount, headlightEffect, headlightColor, newFrontTiming, newFrontLedType, newFrontColorOrder, headlightBackgroundColor, headlightBackgroundEnabled);
-                }
-                
-                // Apply back light effect (always taillight effect)
-                applyEffectToArray(newBackTemp, newBackCount, taillightEffect, taillightColor, newBackTiming, newBackLedType, newBackColorOrder, taillightBackgroundColor, taillightBackgroundEnabled);
+            if (rs.headlightMode == 0) {
+                // Solid white
+                fill_solid(newFrontTemp, newFrontCount, CRGB::White);
+            } else {
+                // Headlight effect
+                applyEffectToArray(newFrontTemp, newFrontCount, rs.headlightEffect, rs.headlightColor, newFrontTiming, rs.headlightBackgroundColor, rs.headlightBackgroundEnabled);
             }
             
+            // Apply back light effect (always taillight effect)
+            applyEffectToArray(newBackTemp, newBackCount, rs.taillightEffect, rs.taillightColor, newBackTiming, rs.taillightBackgroundColor, rs.taillightBackgroundEnabled);
+            
             // Blend old and new for both headlight and taillight
             // IMPORTANT: The physical arrays (headlight/taillight) don't change, only their roles do
             // When fading forward->backward:
@@ -1391,1110 +1953,78 @@ void updateEffects() {
             // - taillight array gets: newDirection's back effect (if forward) or front effect (if backward)
             CRGB* newHeadlightEffect = newDirection ? newFrontTemp : newBackTemp;  // Forward: front, Backward: back
             CRGB* newTaillightEffect = newDirection ? newBackTemp : newFrontTemp;  // Forward: back, Backward: front
-            uint8_t newHeadlightCount = newDirection ? newFrontCount : newBackCount;
-            uint8_t newTaillightCount = newDirection ? newBackCount : newFrontCount;
+            uint16_t newHeadlightCount = newDirection ? newFrontCount : newBackCount;
+            uint16_t newTaillightCount = newDirection ? newBackCount : newFrontCount;
             
-            // Always blend headlightOld -> headlight, taillightOld -> taillight
-            blendLEDArrays(headlight, headlightOld, newHeadlightEffect, newHeadlightCount, directionFadeProgress);
-            blendLEDArrays(taillight, taillightOld, newTaillightEffect, newTaillightCount, directionFadeProgress);
-            
-            delete[] newFrontTemp;
-            delete[] newBackTemp;
+            // Always blend headlightOld -> headlight, taillightOld -> taillight (base frames)
+            uint16_t fade256 = (uint16_t)(motionState.directionFadeProgress * 256.0f);
+            blendLEDArrays(headlightBase, headlightOld, newHeadlightEffect, newHeadlightCount, fade256);
+            blendLEDArrays(taillightBase, taillightOld, newTaillightEffect, newTaillightCount, fade256);
         } else {
             // Normal operation: apply effects based on current direction
             // Reset fade state saved flag when not in fade (so it's ready for next fade)
             fadeStateSaved = false;
-            if (frontUpdate && frontCount > 0) {
-                if (headlightMode == 0) {
+            if (frontCount > 0) {
+                if (rs.headlightMode == 0) {
                     // Solid white for headlight
-                    fillSolidWithColorOrder(frontLights, frontCount, CRGB::White, frontLedType, frontColorOrder);
+                    fill_solid(frontLights, frontCount, CRGB::White);
                 } else {
                     // Headlight effect
-                    applyEffectToArray(frontLights, frontCount, headlightEffect, headlightColor, frontTiming, frontLedType, frontColorOrder, headlightBackgroundColor, headlightBackgroundEnabled);
+                    applyEffectToArray(frontLights, frontCount, rs.headlightEffect, rs.headlightColor, frontTiming, rs.headlightBackgroundColor, rs.headlightBackgroundEnabled);
                 }
             }
             
-            if (backUpdate && backCount > 0) {
+            if (backCount > 0) {
                 // Taillight always gets taillight effect
-                applyEffectToArray(backLights, backCount, taillightEffect, taillightColor, backTiming, backLedType, backColorOrder, taillightBackgroundColor, taillightBackgroundEnabled);
+                applyEffectToArray(backLights, backCount, rs.taillightEffect, rs.taillightColor, backTiming, rs.taillightBackgroundColor, rs.taillightBackgroundEnabled);
             }
         }
     } else {
         // Normal mode: effects apply to fixed headlight/taillight
-        // Update headlight effect (only if timing allows)
-        if (headlightUpdate) {
-            applyEffectToArray(headlight, headlightLedCount, headlightEffect, headlightColor, headlightTiming, headlightLedType, headlightColorOrder, headlightBackgroundColor, headlightBackgroundEnabled);
-        }
-        
-        // Update taillight effect (only if timing allows)
-        if (taillightUpdate) {
-            applyEffectToArray(taillight, taillightLedCount, taillightEffect, taillightColor, taillightTiming, taillightLedType, taillightColorOrder, taillightBackgroundColor, taillightBackgroundEnabled);
-        }
-    }
-
-    // Priority 4: Braking effects (override taillight after base effects)
-    if (brakingActive) {
-        showBrakingEffect();
-    }
-
-    // Priority 5: Blinker effects (override base colors while active)
-    if (blinkerActive) {
-        fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::White, headlightLedType, headlightColorOrder);
-        fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::Red, taillightLedType, taillightColorOrder);
-        showBlinkerEffect(blinkerDirection);
-    }
-    
-    FastLED.show();
-}
-
-CRGB getEffectBackgroundColor() {
-    return effectBackgroundEnabled ? effectBackgroundColor : CRGB::Black;
-}
-
-CRGB mixColors(const CRGB& base, const CRGB& added) {
-    if (base.r == 0 && base.g == 0 && base.b == 0) {
-        return added;
+        applyEffectToArray(headlightBase, headlightLedCount, rs.headlightEffect, rs.headlightColor, headlightTiming, rs.headlightBackgroundColor, rs.headlightBackgroundEnabled);
+        applyEffectToArray(taillightBase, taillightLedCount, rs.taillightEffect, rs.taillightColor, taillightTiming, rs.taillightBackgroundColor, rs.taillightBackgroundEnabled);
     }
-    if (added.r == 0 && added.g == 0 && added.b == 0) {
-        return base;
-    }
-
-    CHSV baseHsv = rgb2hsv_approximate(base);
-    CHSV addedHsv = rgb2hsv_approximate(added);
-
-    uint16_t valueSum = baseHsv.value + addedHsv.value;
-    uint8_t weight = valueSum > 0 ? static_cast<uint8_t>((addedHsv.value * 255) / valueSum) : 128;
-    uint8_t blendedHue = blend8(baseHsv.hue, addedHsv.hue, weight);
-    uint8_t blendedSat = max(baseHsv.sat, addedHsv.sat);
-    uint8_t blendedVal = max(baseHsv.val, addedHsv.val);
-
-    return CHSV(blendedHue, blendedSat, blendedVal);
 }
 
-void effectBreath(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate breathing speed based on effectSpeed (0-255)
-    // Higher speed = faster breathing
-    uint16_t breathSpeed = map(effectSpeed, 0, 255, 15000, 1000); // 1s to 15s cycle (much slower)
-    uint8_t breathe = (sin(millis() / (breathSpeed / 1000.0)) + 1) * 127;
-    CRGB breatheColor = color;
-    breatheColor.nscale8(breathe);
-    fill_solid(leds, numLeds, breatheColor);
-}
+void setPreset(uint8_t preset) {
+    if (preset >= presetCount) return;
+    currentPreset = preset;
 
-void effectRainbow(CRGB* leds, uint8_t numLeds) {
-    // Calculate rainbow speed based on effectSpeed (0-255)
-    uint16_t rainbowSpeed = map(effectSpeed, 0, 255, 1000, 50); // 50ms to 1000ms per step (much slower)
-    uint16_t hue = (effectStep * 65536L / numLeds) + (millis() / rainbowSpeed);
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint16_t pixelHue = hue + (i * 65536L / numLeds);
-        leds[i] = CHSV(pixelHue >> 8, 255, 255);
-    }
-    effectStep += 2;
-}
+    PresetConfig& config = presets[preset];
+    globalBrightness = config.brightness;
+    effectSpeed = config.effectSpeed;
+    headlightEffect = config.headlightEffect;
+    taillightEffect = config.taillightEffect;
+    headlightColor = CRGB(config.headlightColor[0], config.headlightColor[1], config.headlightColor[2]);
+    taillightColor = CRGB(config.taillightColor[0], config.taillightColor[1], config.taillightColor[2]);
+    headlightBackgroundEnabled = config.headlightBackgroundEnabled;
+    taillightBackgroundEnabled = config.taillightBackgroundEnabled;
+    headlightBackgroundColor = CRGB(config.headlightBackgroundColor[0], config.headlightBackgroundColor[1], config.headlightBackgroundColor[2]);
+    taillightBackgroundColor = CRGB(config.taillightBackgroundColor[0], config.taillightBackgroundColor[1], config.taillightBackgroundColor[2]);
 
-// PEV-Friendly: Smooth Pulse Effect - rhythmic brightness pulsing like a heartbeat
-void effectPulse(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate pulse timing based on effectSpeed (slower = longer pulse cycle)
-    uint16_t pulseSpeed = map(effectSpeed, 0, 255, 4000, 500); // 500ms to 4s per cycle
-    
-    // Use sine wave for smooth pulsing
-    uint16_t phase = (millis() % pulseSpeed) * 256 / pulseSpeed;
-    uint8_t brightness = sin8(phase); // 0-255 sine wave
-    
-    // Ensure minimum visibility
-    brightness = map(brightness, 0, 255, 40, 255);
-    
-    CRGB pulseColor = color;
-    pulseColor.nscale8(brightness);
-    fill_solid(leds, numLeds, pulseColor);
+    Serial.printf("Preset applied: %s (index %d)\n", config.name, preset);
+    FastLED.setBrightness(globalBrightness);
 }
 
-void effectBlinkRainbow(CRGB* leds, uint8_t numLeds) {
-    // Calculate blink speed based on effectSpeed (0-255)
-    uint16_t blinkSpeed = map(effectSpeed, 0, 255, 10000, 800); // 800ms to 10s (much slower)l
-    bool blinkState = (millis() / blinkSpeed) % 2;
-    if (blinkState) {
-        effectRainbow(leds, numLeds);
-    } else {
-        fill_solid(leds, numLeds, getEffectBackgroundColor());
-    }
-}
-
-// PEV-Friendly: Gradient Shift Effect - smooth color gradient that moves along the strip
-void effectGradientShift(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate shift speed based on effectSpeed
-    uint16_t shiftSpeed = map(effectSpeed, 0, 255, 8000, 1000); // 1s to 8s per cycle
-    uint16_t phase = (millis() % shiftSpeed) * 256 / shiftSpeed;
-    
-    // Get hue from color for gradient variation
-    CHSV hsv = rgb2hsv_approximate(color);
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Create smooth gradient across the strip
-        uint8_t position = (i * 256 / numLeds + phase) % 256;
-        
-        // Vary brightness smoothly across the strip
-        uint8_t brightness = sin8(position);
-        brightness = map(brightness, 0, 255, 60, 255); // Minimum 60 brightness
-        
-        CRGB gradientColor = color;
-        gradientColor.nscale8(brightness);
-        leds[i] = gradientColor;
-    }
-}
-
-// Fire Effect
-void effectFire(CRGB* leds, uint8_t numLeds) {
-    // Fire simulation with heat and cooling
-    static uint8_t heat[200]; // Max LEDs supported
-    
-    // Calculate fire speed based on effectSpeed
-    uint8_t cooling = map(effectSpeed, 0, 255, 50, 200);
-    uint8_t sparking = map(effectSpeed, 0, 255, 50, 120);
-    
-    // Cool down every cell a little
-    for (uint8_t i = 0; i < numLeds; i++) {
-        heat[i] = qsub8(heat[i], random(0, ((cooling * 10) / numLeds) + 2));
-    }
-    
-    // Heat from each cell drifts 'up' and diffuses a little
-    for (uint8_t k = numLeds - 1; k >= 2; k--) {
-        heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
-    }
-    
-    // Randomly ignite new 'sparks' near the bottom
-    if (random(255) < sparking) {
-        uint8_t y = random(7);
-        heat[y] = qadd8(heat[y], random(160, 255));
-    }
-    
-    // Convert heat to LED colors
-    for (uint8_t j = 0; j < numLeds; j++) {
-        CRGB color = HeatColor(heat[j]);
-        leds[j] = color;
-    }
-}
-
-// Meteor Effect
-void effectMeteor(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Fade all LEDs
-    for (uint8_t i = 0; i < numLeds; i++) {
-        leds[i].nscale8(192); // Fade by 25%
-    }
-    
-    // Calculate meteor speed
-    uint8_t meteorSize = map(effectSpeed, 0, 255, 1, 5);
-    uint8_t meteorPos = (effectStep / 2) % (numLeds + meteorSize);
-    
-    // Draw meteor
-    for (uint8_t i = 0; i < meteorSize; i++) {
-        if (meteorPos - i >= 0 && meteorPos - i < numLeds) {
-            uint8_t brightness = 255 - (i * 255 / meteorSize);
-            CRGB meteorColor = color;
-            meteorColor.nscale8(brightness);
-            leds[meteorPos - i] = meteorColor;
-        }
-    }
-    
-    effectStep++;
-}
-
-// Wave Effect
-void effectWave(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate wave speed
-    uint16_t waveSpeed = map(effectSpeed, 0, 255, 1000, 100);
-    uint8_t wavePos = (millis() / waveSpeed) % (numLeds * 2);
-    
-    // Create wave pattern
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs(i - wavePos);
-        if (distance > numLeds) distance = (numLeds * 2) - distance;
-        
-        uint8_t brightness = 255 - (distance * 255 / numLeds);
-        if (brightness > 0) {
-            CRGB waveColor = color;
-            waveColor.nscale8(brightness);
-            leds[i] = waveColor;
-        } else {
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-// PEV-Friendly: Center Burst Effect - LEDs expand outward from center
-void effectCenterBurst(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate burst speed based on effectSpeed
-    uint16_t burstSpeed = map(effectSpeed, 0, 255, 3000, 500); // 500ms to 3s per cycle
-    uint16_t phase = (millis() % burstSpeed) * 256 / burstSpeed;
-    
-    // Use sine wave for smooth expansion/contraction
-    uint8_t expansion = sin8(phase); // 0-255
-    uint8_t maxRadius = numLeds / 2;
-    uint8_t radius = map(expansion, 0, 255, 0, maxRadius);
-    
-    uint8_t center = numLeds / 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs((int)i - (int)center);
-        
-        if (distance <= radius) {
-            // Inside the burst - calculate brightness based on distance from edge
-            uint8_t edgeDistance = radius - distance;
-            uint8_t brightness = map(edgeDistance, 0, radius > 0 ? radius : 1, 100, 255);
-            CRGB burstColor = color;
-            burstColor.nscale8(brightness);
-            leds[i] = burstColor;
-        } else {
-            // Outside the burst
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-// Candle Effect
-void effectCandle(CRGB* leds, uint8_t numLeds) {
-    // Calculate candle flicker speed
-    uint8_t flickerSpeed = map(effectSpeed, 0, 255, 50, 200);
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Base candle color (warm white/orange)
-        CRGB baseColor = CRGB(255, 147, 41); // Warm orange
-        
-        // Add random flicker
-        uint8_t flicker = random(0, flickerSpeed);
-        uint8_t brightness = 200 + flicker;
-        
-        CRGB candleColor = baseColor;
-        candleColor.nscale8(brightness);
-        leds[i] = candleColor;
-    }
-}
-
-// Static Rainbow Effect
-void effectStaticRainbow(CRGB* leds, uint8_t numLeds) {
-    // Static rainbow - no movement, just rainbow colors across the strip
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t hue = (i * 255) / numLeds;
-        leds[i] = CHSV(hue, 255, 255);
-    }
-}
-
-// Electrolyte-style Knight Rider Effect (KITT scanner)
-void effectKnightRider(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Fade all LEDs
-    for (uint8_t i = 0; i < numLeds; i++) {
-        leds[i].nscale8(200); // Fade by 22%
-    }
-    
-    // Calculate scanner speed and size
-    uint8_t scannerSize = map(effectSpeed / 2, 0, 255, 2, 6);
-    uint8_t scannerPos = (effectStep / 2) % ((numLeds + scannerSize) * 2);
-    
-    // Determine direction (forward or backward)
-    bool forward = (scannerPos < (numLeds + scannerSize));
-    uint8_t actualPos = forward ? scannerPos : ((numLeds + scannerSize) * 2) - scannerPos - 1;
-    
-    // Draw scanner
-    for (uint8_t i = 0; i < scannerSize; i++) {
-        if (actualPos - i >= 0 && actualPos - i < numLeds) {
-            uint8_t brightness = 255 - (i * 255 / scannerSize);
-            CRGB scannerColor = color;
-            scannerColor.nscale8(brightness);
-            leds[actualPos - i] = scannerColor;
-        }
-    }
-    
-    effectStep++;
-}
-
-// Electrolyte-style Police Effect (red/blue alternating)
-void effectPolice(CRGB* leds, uint8_t numLeds) {
-    // Calculate police flash speed
-    uint16_t flashSpeed = map(effectSpeed, 0, 255, 1000, 100);
-    bool flashState = (millis() / flashSpeed) % 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        if (flashState) {
-            // Red on odd positions, blue on even
-            leds[i] = (i % 2) ? CRGB::Red : CRGB::Blue;
-        } else {
-            // Blue on odd positions, red on even
-            leds[i] = (i % 2) ? CRGB::Blue : CRGB::Red;
-        }
-    }
-}
-
-// Electrolyte-style Strobe Effect
-void effectStrobe(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate strobe speed
-    uint16_t strobeSpeed = map(effectSpeed, 0, 255, 2000, 50);
-    bool strobeState = (millis() / strobeSpeed) % 2;
-    
-    if (strobeState) {
-        fill_solid(leds, numLeds, color);
-    } else {
-        fill_solid(leds, numLeds, getEffectBackgroundColor());
-    }
-}
-
-// Electrolyte-style Larson Scanner Effect
-void effectLarsonScanner(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Fade all LEDs
-    for (uint8_t i = 0; i < numLeds; i++) {
-        leds[i].nscale8(220); // Fade by 14%
-    }
-    
-    // Calculate scanner speed and size
-    uint8_t scannerSize = map(effectSpeed, 0, 255, 1, 4);
-    uint8_t scannerPos = (effectStep / 3) % ((numLeds + scannerSize) * 2);
-    
-    // Determine direction
-    bool forward = (scannerPos < (numLeds + scannerSize));
-    uint8_t actualPos = forward ? scannerPos : ((numLeds + scannerSize) * 2) - scannerPos - 1;
-    
-    // Draw scanner with fade
-    for (uint8_t i = 0; i < scannerSize; i++) {
-        if (actualPos - i >= 0 && actualPos - i < numLeds) {
-            uint8_t brightness = 255 - (i * 200 / scannerSize);
-            CRGB scannerColor = color;
-            scannerColor.nscale8(brightness);
-            leds[actualPos - i] = scannerColor;
-        }
-    }
-    
-    effectStep++;
-}
-
-// Electrolyte-style Color Wipe Effect
-void effectColorWipe(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate wipe speed
-    uint16_t wipeSpeed = map(effectSpeed, 0, 255, 2000, 200);
-    uint8_t wipePos = (millis() / wipeSpeed) % (numLeds * 2);
-    
-    // Determine direction
-    bool forward = (wipePos < numLeds);
-    uint8_t actualPos = forward ? wipePos : (numLeds * 2) - wipePos - 1;
-    
-    // Clear all LEDs
-    fill_solid(leds, numLeds, getEffectBackgroundColor());
-    
-    // Fill up to position
-    for (uint8_t i = 0; i <= actualPos && i < numLeds; i++) {
-        leds[i] = color;
-    }
-}
-
-// Electrolyte-style Theater Chase Effect
-// PEV-Friendly: Hazard Effect - alternating halves for high visibility
-void effectHazard(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate flash rate based on effectSpeed (not too fast to avoid strobe)
-    uint16_t flashRate = map(effectSpeed, 0, 255, 1500, 400); // 400ms to 1.5s per cycle
-    bool firstHalf = ((millis() / flashRate) % 2) == 0;
-    
-    uint8_t midPoint = numLeds / 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        bool isFirstHalf = (i < midPoint);
-        
-        if ((isFirstHalf && firstHalf) || (!isFirstHalf && !firstHalf)) {
-            leds[i] = color;
-        } else {
-            // Dim the other half instead of turning off completely
-            CRGB dimColor = color;
-            dimColor.nscale8(40); // 15% brightness
-            leds[i] = dimColor;
-        }
-    }
-}
-
-// Electrolyte-style Running Lights Effect
-void effectRunningLights(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate running speed
-    uint16_t runSpeed = map(effectSpeed, 0, 255, 2000, 200);
-    uint8_t runPos = (millis() / runSpeed) % numLeds;
-    
-    // Clear all LEDs
-    fill_solid(leds, numLeds, getEffectBackgroundColor());
-    
-    // Create running light pattern
-    for (uint8_t i = 0; i < 3; i++) {
-        uint8_t pos = (runPos + i) % numLeds;
-        uint8_t brightness = 255 - (i * 85); // Fade each light
-        CRGB runColor = color;
-        runColor.nscale8(brightness);
-        leds[pos] = runColor;
-    }
-}
-
-// Electrolyte-style Color Sweep Effect
-void effectColorSweep(CRGB* leds, uint8_t numLeds, CRGB color) {
-    // Calculate sweep speed
-    uint16_t sweepSpeed = map(effectSpeed, 0, 255, 3000, 300);
-    uint8_t sweepPos = (millis() / sweepSpeed) % (numLeds * 2);
-    
-    // Determine direction
-    bool forward = (sweepPos < numLeds);
-    uint8_t actualPos = forward ? sweepPos : (numLeds * 2) - sweepPos - 1;
-    
-    // Create sweep pattern
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs(i - actualPos);
-        if (distance < 5) {
-            uint8_t brightness = 255 - (distance * 50);
-            CRGB sweepColor = color;
-            sweepColor.nscale8(brightness);
-            leds[i] = sweepColor;
-        } else {
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-// ============================================================================
-// IMPROVED EFFECT FUNCTIONS WITH CONSISTENT TIMING
-// ============================================================================
-
-// Improved Breath Effect with consistent timing
-void effectBreathImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step-based timing for consistent speed across different strip lengths
-    uint8_t breathPhase = (step * 2) % 256; // 0-255 cycle
-    uint8_t brightness = sin8(breathPhase);
-    
-    CRGB breathColor = color;
-    breathColor.nscale8(brightness);
-    fill_solid(leds, numLeds, breathColor);
-}
-
-// Improved Rainbow Effect with consistent timing
-void effectRainbowImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    // Use step-based timing for consistent rainbow speed
-    // Apply speed multiplier: faster base speed for rainbow (multiply step by multiplier)
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_RAINBOW);
-    uint16_t hueOffset = (step * multiplier) % 256; // Faster rainbow movement
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t hue = (hueOffset + (i * 256 / numLeds)) % 256;
-        leds[i] = CHSV(hue, 255, 255);
-    }
-}
-
-// Improved Chase Effect with consistent timing
-// PEV-Friendly: Improved Pulse Effect with consistent timing
-void effectPulseImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step for consistent timing across synced devices
-    uint8_t phase = (step * 4) % 256; // Smooth cycle
-    uint8_t brightness = sin8(phase);
-    
-    // Ensure minimum visibility
-    brightness = map(brightness, 0, 255, 40, 255);
-    
-    CRGB pulseColor = color;
-    pulseColor.nscale8(brightness);
-    fill_solid(leds, numLeds, pulseColor);
-}
-
-// Improved Blink Rainbow Effect with consistent timing
-void effectBlinkRainbowImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    // Blink every 20 steps (adjustable)
-    bool blinkState = (step / 20) % 2;
-    if (blinkState) {
-        effectRainbowImproved(leds, numLeds, step);
-    } else {
-        fill_solid(leds, numLeds, getEffectBackgroundColor());
-    }
-}
-
-// Improved Twinkle Effect with consistent timing
-// PEV-Friendly: Improved Gradient Shift Effect with consistent timing
-void effectGradientShiftImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step for consistent timing across synced devices
-    uint8_t phase = (step * 2) % 256;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Create smooth gradient across the strip
-        uint8_t position = (i * 256 / numLeds + phase) % 256;
-        
-        // Vary brightness smoothly across the strip
-        uint8_t brightness = sin8(position);
-        brightness = map(brightness, 0, 255, 60, 255); // Minimum 60 brightness
-        
-        CRGB gradientColor = color;
-        gradientColor.nscale8(brightness);
-        leds[i] = gradientColor;
-    }
-}
-
-// Improved Fire Effect with consistent timing
-void effectFireImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    static uint8_t heat[200]; // Max LEDs supported
-    
-    // Use step for consistent fire behavior
-    uint8_t cooling = 50 + (step % 50);
-    uint8_t sparking = 50 + (step % 70);
-    
-    // Cool down every cell a little
-    for (uint8_t i = 0; i < numLeds; i++) {
-        heat[i] = qsub8(heat[i], random(0, ((cooling * 10) / numLeds) + 2));
-    }
-    
-    // Heat from each cell drifts 'up' and diffuses a little
-    for (uint8_t k = numLeds - 1; k >= 2; k--) {
-        heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
-    }
-    
-    // Randomly ignite new 'sparks' near the bottom
-    if (random(255) < sparking) {
-        uint8_t y = random(7);
-        heat[y] = qadd8(heat[y], random(160, 255));
-    }
-    
-    // Convert heat to LED colors
-    for (uint8_t j = 0; j < numLeds; j++) {
-        CRGB color = HeatColor(heat[j]);
-        leds[j] = color;
-    }
-}
-
-// Improved Meteor Effect with consistent timing
-void effectMeteorImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Fade all LEDs
-    for (uint8_t i = 0; i < numLeds; i++) {
-        leds[i].nscale8(192); // Fade by 25%
-    }
-    
-    // Apply speed multiplier for faster movement
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_METEOR);
-    // Use step for consistent meteor movement
-    uint8_t meteorSize = 3 + (step % 3);
-    uint8_t meteorPos = ((step * multiplier) / 2) % (numLeds + meteorSize);
-    
-    // Draw meteor
-    for (uint8_t i = 0; i < meteorSize; i++) {
-        if (meteorPos - i >= 0 && meteorPos - i < numLeds) {
-            uint8_t brightness = 255 - (i * 255 / meteorSize);
-            CRGB meteorColor = color;
-            meteorColor.nscale8(brightness);
-            leds[meteorPos - i] = meteorColor;
-        }
-    }
-}
-
-// Improved Wave Effect with consistent timing
-void effectWaveImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Apply speed multiplier for faster movement
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_WAVE);
-    // Use step for consistent wave movement
-    uint8_t wavePos = ((step * multiplier) / 2) % (numLeds * 2);
-    
-    // Create wave pattern
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs(i - wavePos);
-        if (distance > numLeds) distance = (numLeds * 2) - distance;
-        
-        uint8_t brightness = 255 - (distance * 255 / numLeds);
-        if (brightness > 0) {
-            CRGB waveColor = color;
-            waveColor.nscale8(brightness);
-            leds[i] = waveColor;
-        } else {
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-// Improved Comet Effect with consistent timing
-// PEV-Friendly: Improved Center Burst Effect with consistent timing
-void effectCenterBurstImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step for consistent timing across synced devices
-    uint8_t phase = (step * 3) % 256;
-    
-    // Use sine wave for smooth expansion/contraction
-    uint8_t expansion = sin8(phase);
-    uint8_t maxRadius = numLeds / 2;
-    uint8_t radius = map(expansion, 0, 255, 0, maxRadius);
-    
-    uint8_t center = numLeds / 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs((int)i - (int)center);
-        
-        if (distance <= radius) {
-            // Inside the burst - calculate brightness based on distance from edge
-            uint8_t edgeDistance = radius - distance;
-            uint8_t brightness = map(edgeDistance, 0, radius > 0 ? radius : 1, 100, 255);
-            CRGB burstColor = color;
-            burstColor.nscale8(brightness);
-            leds[i] = burstColor;
-        } else {
-            // Outside the burst
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-// Improved Candle Effect with consistent timing
-void effectCandleImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Base candle color (warm white/orange)
-        CRGB baseColor = CRGB(255, 147, 41); // Warm orange
-        
-        // Use step for consistent flicker pattern
-        uint8_t flicker = (step * 3 + i * 7) % 100;
-        uint8_t brightness = 150 + flicker;
-        
-        CRGB candleColor = baseColor;
-        candleColor.nscale8(brightness);
-        leds[i] = candleColor;
-    }
-}
-
-// Improved Knight Rider Effect with consistent timing (KITT scanner)
-void effectKnightRiderImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Fade all LEDs to black (preserves color better than nscale8)
-    // Use a slower fade to black to preserve color hue
-    for (uint8_t i = 0; i < numLeds; i++) {
-        // Fade each channel independently toward black (preserves color better)
-        // Fade by ~25% per frame for smoother trail
-        leds[i].r = (leds[i].r * 192) >> 8; // ~25% fade
-        leds[i].g = (leds[i].g * 192) >> 8;
-        leds[i].b = (leds[i].b * 192) >> 8;
-    }
-    
-    // Calculate scanner position (smooth back-and-forth motion)
-    // Slow down the scanner by dividing step (Knight Rider should be slower)
-    // Allow scanner to go "off-screen" past the edges for authentic KITT effect
-    // The scanner appears to leave the LED bar before turning around
-    uint16_t trailLength = numLeds / 3;
-    if (trailLength < 3) trailLength = 3;
-    if (trailLength > 8) trailLength = 8;
-    
-    // Extend the cycle to allow scanner to go past edges
-    // Forward: -trailLength to numLeds + trailLength
-    // Backward: numLeds + trailLength to -trailLength
-    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
-    uint16_t position = (step / 4) % cycleLength; // Divide by 4 to slow down scanner
-    
-    // Determine direction and actual position (can be negative or beyond numLeds)
-    int16_t scannerPos;
-    bool forward;
-    if (position < (numLeds + trailLength * 2)) {
-        // Forward direction: goes from -trailLength to numLeds + trailLength
-        scannerPos = (int16_t)position - trailLength;
-        forward = true;
-    } else {
-        // Backward direction: goes from numLeds + trailLength to -trailLength
-        scannerPos = (int16_t)(cycleLength - position) - trailLength;
-        forward = false;
-    }
-    
-    // Draw trail first (behind scanner) - only draw visible parts
-    for (uint8_t i = 1; i <= trailLength; i++) {
-        int16_t trailPos;
-        
-        if (forward) {
-            // Trail behind (to the left when going forward)
-            trailPos = scannerPos - i;
-        } else {
-            // Trail behind (to the right when going backward)
-            trailPos = scannerPos + i;
-        }
-        
-        // Only draw if position is visible (within LED bounds)
-        if (trailPos >= 0 && trailPos < numLeds) {
-            // Exponential fade for smooth trail (brighter closer to main light)
-            // Use a curve: brightness = 255 * (1 - (i/trailLength)^2)
-            float fadeRatio = (float)i / trailLength;
-            uint8_t brightness = 255 * (1.0 - fadeRatio * fadeRatio);
-            
-            // Scale color channels independently to preserve hue
-            CRGB trailColor;
-            trailColor.r = (color.r * brightness) >> 8;
-            trailColor.g = (color.g * brightness) >> 8;
-            trailColor.b = (color.b * brightness) >> 8;
-            leds[trailPos] = trailColor; // Overwrite (not blend) to prevent color mixing
-        }
-    }
-    
-    // Main scanner light (bright center) - only draw if visible
-    if (scannerPos >= 0 && scannerPos < numLeds) {
-        leds[scannerPos] = color; // Full brightness main light
-    }
-}
-
-// Improved Police Effect with consistent timing
-void effectPoliceImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    // Use step for consistent flash pattern
-    bool flashState = (step / 10) % 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        if (flashState) {
-            // Red on odd positions, blue on even
-            leds[i] = (i % 2) ? CRGB::Red : CRGB::Blue;
-        } else {
-            // Blue on odd positions, red on even
-            leds[i] = (i % 2) ? CRGB::Blue : CRGB::Red;
-        }
-    }
-}
-
-// Improved Strobe Effect with consistent timing
-void effectStrobeImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step for consistent strobe pattern
-    bool strobeState = (step / 5) % 2;
-    
-    if (strobeState) {
-        fill_solid(leds, numLeds, color);
-    } else {
-        fill_solid(leds, numLeds, getEffectBackgroundColor());
-    }
-}
-
-// Improved Larson Scanner Effect with consistent timing
-void effectLarsonScannerImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Fade all LEDs
-    for (uint8_t i = 0; i < numLeds; i++) {
-        leds[i].nscale8(220); // Fade by 14%
-    }
-    
-    // Use step for consistent scanner movement
-    uint8_t scannerSize = 2 + (step % 2);
-    uint8_t scannerPos = (step / 3) % ((numLeds + scannerSize) * 2);
-    
-    // Determine direction
-    bool forward = (scannerPos < (numLeds + scannerSize));
-    uint8_t actualPos = forward ? scannerPos : ((numLeds + scannerSize) * 2) - scannerPos - 1;
-    
-    // Draw scanner with fade
-    for (uint8_t i = 0; i < scannerSize; i++) {
-        if (actualPos - i >= 0 && actualPos - i < numLeds) {
-            uint8_t brightness = 255 - (i * 200 / scannerSize);
-            CRGB scannerColor = color;
-            scannerColor.nscale8(brightness);
-            leds[actualPos - i] = scannerColor;
-        }
-    }
-}
-
-// Improved Color Wipe Effect with consistent timing
-void effectColorWipeImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Apply speed multiplier for faster movement
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_COLOR_WIPE);
-    // Use step for consistent wipe movement
-    uint8_t wipePos = ((step * multiplier) / 3) % (numLeds * 2);
-    
-    // Determine direction
-    bool forward = (wipePos < numLeds);
-    uint8_t actualPos = forward ? wipePos : (numLeds * 2) - wipePos - 1;
-    
-    // Clear all LEDs
-    fill_solid(leds, numLeds, getEffectBackgroundColor());
-    
-    // Fill up to position
-    for (uint8_t i = 0; i <= actualPos && i < numLeds; i++) {
-        leds[i] = color;
-    }
-}
-
-// Rainbow Color Wipe Effect (single-direction sweep, alternating direction)
-void effectRainbowWipeImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_RAINBOW_WIPE);
-    uint16_t sweepStep = (step * multiplier) / 3;
-    uint16_t sweepIndex = sweepStep / numLeds;
-    uint8_t pos = sweepStep % numLeds;
-    bool forward = (sweepIndex % 2 == 0);
-
-    uint8_t prevHue = ((sweepIndex - 1) * 57 + 23) & 0xFF;
-    uint8_t currHue = (sweepIndex * 57 + 23) & 0xFF;
-    if (abs((int)prevHue - (int)currHue) < 32) {
-        currHue = (currHue + 64) & 0xFF;
-    }
-
-    CRGB backgroundColor = CHSV(prevHue, 255, 255);
-    CRGB wipeColor = CHSV(currHue, 255, 255);
-    fill_solid(leds, numLeds, backgroundColor);
-
-    if (forward) {
-        for (uint8_t i = 0; i <= pos && i < numLeds; i++) {
-            leds[i] = wipeColor;
-        }
-    } else {
-        uint8_t actualPos = (numLeds - 1) - pos;
-        for (uint8_t i = actualPos; i < numLeds; i++) {
-            leds[i] = wipeColor;
-        }
-    }
-}
-
-// Improved Theater Chase Effect with consistent timing
-// PEV-Friendly: Improved Hazard Effect with consistent timing
-void effectHazardImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Use step for consistent timing across synced devices
-    bool firstHalf = ((step / 15) % 2) == 0; // Toggle every ~15 steps
-    
-    uint8_t midPoint = numLeds / 2;
-    
-    for (uint8_t i = 0; i < numLeds; i++) {
-        bool isFirstHalf = (i < midPoint);
-        
-        if ((isFirstHalf && firstHalf) || (!isFirstHalf && !firstHalf)) {
-            leds[i] = color;
-        } else {
-            // Dim the other half instead of turning off completely
-            CRGB dimColor = color;
-            dimColor.nscale8(40); // 15% brightness
-            leds[i] = dimColor;
-        }
-    }
-}
-
-// Improved Running Lights Effect with consistent timing
-void effectRunningLightsImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Apply speed multiplier for faster movement
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_RUNNING_LIGHTS);
-    // Use step for consistent running movement
-    uint8_t runPos = ((step * multiplier) / 2) % numLeds;
-    
-    // Clear all LEDs
-    fill_solid(leds, numLeds, getEffectBackgroundColor());
-    
-    // Create running light pattern
-    for (uint8_t i = 0; i < 3; i++) {
-        uint8_t pos = (runPos + i) % numLeds;
-        uint8_t brightness = 255 - (i * 85); // Fade each light
-        CRGB runColor = color;
-        runColor.nscale8(brightness);
-        leds[pos] = runColor;
-    }
-}
-
-// Improved Color Sweep Effect with consistent timing
-void effectColorSweepImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    // Apply speed multiplier for faster movement
-    uint8_t multiplier = getEffectSpeedMultiplier(FX_COLOR_SWEEP);
-    // Use step for consistent sweep movement
-    uint8_t sweepPos = ((step * multiplier) / 2) % (numLeds * 2);
-    
-    // Determine direction
-    bool forward = (sweepPos < numLeds);
-    uint8_t actualPos = forward ? sweepPos : (numLeds * 2) - sweepPos - 1;
-    
-    // Create sweep pattern
-    for (uint8_t i = 0; i < numLeds; i++) {
-        uint8_t distance = abs(i - actualPos);
-        if (distance < 5) {
-            uint8_t brightness = 255 - (distance * 50);
-            CRGB sweepColor = color;
-            sweepColor.nscale8(brightness);
-            leds[i] = sweepColor;
-        } else {
-            leds[i] = getEffectBackgroundColor();
-        }
-    }
-}
-
-void effectRainbowKnightRiderImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    static bool lastForward = true;
-    static CRGB currentColor = CRGB::Red;
-
-    uint16_t trailLength = numLeds / 3;
-    if (trailLength < 3) trailLength = 3;
-    if (trailLength > 8) trailLength = 8;
-
-    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
-    uint16_t position = (step / 4) % cycleLength;
-
-    bool forward = (position < (numLeds + trailLength * 2));
-    int16_t scannerPos;
-    if (forward) {
-        scannerPos = (int16_t)position - trailLength;
-    } else {
-        scannerPos = (int16_t)(cycleLength - position) - trailLength;
-    }
-
-    if (forward != lastForward) {
-        currentColor = CHSV(random8(), 255, 255);
-        lastForward = forward;
-    }
-
-    fill_solid(leds, numLeds, getEffectBackgroundColor());
-
-    for (uint8_t i = 1; i <= trailLength; i++) {
-        int16_t trailPos = forward ? (scannerPos - i) : (scannerPos + i);
-        if (trailPos >= 0 && trailPos < numLeds) {
-            float fadeRatio = (float)i / trailLength;
-            uint8_t brightness = 255 * (1.0 - fadeRatio * fadeRatio);
-            CRGB trailColor;
-            trailColor.r = (currentColor.r * brightness) >> 8;
-            trailColor.g = (currentColor.g * brightness) >> 8;
-            trailColor.b = (currentColor.b * brightness) >> 8;
-            leds[trailPos] = trailColor;
-        }
-    }
-
-    if (scannerPos >= 0 && scannerPos < numLeds) {
-        leds[scannerPos] = currentColor;
-    }
-}
-
-void effectDualKnightRiderImproved(CRGB* leds, uint8_t numLeds, CRGB color, uint16_t step) {
-    CRGB secondaryColor = getEffectBackgroundColor();
-
-    uint16_t trailLength = numLeds;
-    if (trailLength < 4) trailLength = 4;
-    if (trailLength > 16) trailLength = 16;
-
-    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
-    uint16_t position = (step / 4) % cycleLength;
-
-    bool forward = (position < (numLeds + trailLength * 2));
-    bool oppositeForward = !forward;
-
-    int16_t primaryPos = forward
-        ? (int16_t)position - trailLength
-        : (int16_t)(cycleLength - position) - trailLength;
-
-    int16_t posMin = -static_cast<int16_t>(trailLength);
-    int16_t posMax = static_cast<int16_t>(numLeds - 1 + trailLength);
-    int16_t secondaryPos = posMin + posMax - primaryPos;
-
-    fill_solid(leds, numLeds, CRGB::Black);
-
-    for (uint8_t i = 1; i <= trailLength; i++) {
-        float fadeRatio = (float)i / trailLength;
-        uint8_t brightness = 255 * (1.0 - sqrtf(fadeRatio));
-
-        int16_t primaryTrail = forward ? (primaryPos - i) : (primaryPos + i);
-        if (primaryTrail >= 0 && primaryTrail < numLeds) {
-            CRGB trailColor;
-            trailColor.r = (color.r * brightness) >> 8;
-            trailColor.g = (color.g * brightness) >> 8;
-            trailColor.b = (color.b * brightness) >> 8;
-            leds[primaryTrail] = mixColors(leds[primaryTrail], trailColor);
-        }
-
-        int16_t secondaryTrail = oppositeForward ? (secondaryPos - i) : (secondaryPos + i);
-        if (secondaryTrail >= 0 && secondaryTrail < numLeds) {
-            CRGB trailColor;
-            trailColor.r = (secondaryColor.r * brightness) >> 8;
-            trailColor.g = (secondaryColor.g * brightness) >> 8;
-            trailColor.b = (secondaryColor.b * brightness) >> 8;
-            leds[secondaryTrail] = mixColors(leds[secondaryTrail], trailColor);
-        }
-    }
-
-    if (primaryPos >= 0 && primaryPos < numLeds) {
-        leds[primaryPos] = mixColors(leds[primaryPos], color);
-    }
-    if (secondaryPos >= 0 && secondaryPos < numLeds) {
-        leds[secondaryPos] = mixColors(leds[secondaryPos], secondaryColor);
-    }
-}
-
-void effectDualRainbowKnightRiderImproved(CRGB* leds, uint8_t numLeds, uint16_t step) {
-    static bool lastForward = true;
-    static bool lastOppositeForward = false;
-    static CRGB primaryColor = CHSV(0, 255, 255);
-    static CRGB secondaryColor = CHSV(160, 255, 255);
-
-    uint16_t trailLength = numLeds;
-    if (trailLength < 4) trailLength = 4;
-    if (trailLength > 16) trailLength = 16;
-
-    uint16_t cycleLength = (numLeds + trailLength * 2) * 2;
-    uint16_t position = (step / 4) % cycleLength;
-
-    bool forward = (position < (numLeds + trailLength * 2));
-    bool oppositeForward = !forward;
-
-    int16_t primaryPos = forward
-        ? (int16_t)position - trailLength
-        : (int16_t)(cycleLength - position) - trailLength;
-
-    int16_t posMin = -static_cast<int16_t>(trailLength);
-    int16_t posMax = static_cast<int16_t>(numLeds - 1 + trailLength);
-    int16_t secondaryPos = posMin + posMax - primaryPos;
-
-    if (forward != lastForward) {
-        primaryColor = CHSV(random8(), 255, 255);
-        lastForward = forward;
-    }
-    if (oppositeForward != lastOppositeForward) {
-        secondaryColor = CHSV(random8(), 255, 255);
-        lastOppositeForward = oppositeForward;
-    }
-
-    fill_solid(leds, numLeds, CRGB::Black);
-
-    for (uint8_t i = 1; i <= trailLength; i++) {
-        float fadeRatio = (float)i / trailLength;
-        uint8_t brightness = 255 * (1.0 - sqrtf(fadeRatio));
-
-        int16_t primaryTrail = forward ? (primaryPos - i) : (primaryPos + i);
-        if (primaryTrail >= 0 && primaryTrail < numLeds) {
-            CRGB trailColor;
-            trailColor.r = (primaryColor.r * brightness) >> 8;
-            trailColor.g = (primaryColor.g * brightness) >> 8;
-            trailColor.b = (primaryColor.b * brightness) >> 8;
-            leds[primaryTrail] = mixColors(leds[primaryTrail], trailColor);
-        }
-
-        int16_t secondaryTrail = oppositeForward ? (secondaryPos - i) : (secondaryPos + i);
-        if (secondaryTrail >= 0 && secondaryTrail < numLeds) {
-            CRGB trailColor;
-            trailColor.r = (secondaryColor.r * brightness) >> 8;
-            trailColor.g = (secondaryColor.g * brightness) >> 8;
-            trailColor.b = (secondaryColor.b * brightness) >> 8;
-            leds[secondaryTrail] = mixColors(leds[secondaryTrail], trailColor);
-        }
-    }
-
-    if (primaryPos >= 0 && primaryPos < numLeds) {
-        leds[primaryPos] = mixColors(leds[primaryPos], primaryColor);
-    }
-    if (secondaryPos >= 0 && secondaryPos < numLeds) {
-        leds[secondaryPos] = mixColors(leds[secondaryPos], secondaryColor);
-    }
-}
-
-void setPreset(uint8_t preset) {
-    if (preset >= presetCount) return;
-    currentPreset = preset;
-
-    PresetConfig& config = presets[preset];
-    globalBrightness = config.brightness;
-    effectSpeed = config.effectSpeed;
-    headlightEffect = config.headlightEffect;
-    taillightEffect = config.taillightEffect;
-    headlightColor = CRGB(config.headlightColor[0], config.headlightColor[1], config.headlightColor[2]);
-    taillightColor = CRGB(config.taillightColor[0], config.taillightColor[1], config.taillightColor[2]);
-    headlightBackgroundEnabled = config.headlightBackgroundEnabled;
-    taillightBackgroundEnabled = config.taillightBackgroundEnabled;
-    headlightBackgroundColor = CRGB(config.headlightBackgroundColor[0], config.headlightBackgroundColor[1], config.headlightBackgroundColor[2]);
-    taillightBackgroundColor = CRGB(config.taillightBackgroundColor[0], config.taillightBackgroundColor[1], config.taillightBackgroundColor[2]);
-
-    Serial.printf("Preset applied: %s (index %d)\n", config.name, preset);
-    FastLED.setBrightness(globalBrightness);
-}
-
-void captureCurrentPreset(PresetConfig& preset) {
-    preset.brightness = globalBrightness;
-    preset.effectSpeed = effectSpeed;
-    preset.headlightEffect = headlightEffect;
-    preset.taillightEffect = taillightEffect;
-    preset.headlightColor[0] = headlightColor.r;
-    preset.headlightColor[1] = headlightColor.g;
-    preset.headlightColor[2] = headlightColor.b;
-    preset.taillightColor[0] = taillightColor.r;
-    preset.taillightColor[1] = taillightColor.g;
-    preset.taillightColor[2] = taillightColor.b;
-    preset.headlightBackgroundEnabled = headlightBackgroundEnabled;
-    preset.taillightBackgroundEnabled = taillightBackgroundEnabled;
-    preset.headlightBackgroundColor[0] = headlightBackgroundColor.r;
-    preset.headlightBackgroundColor[1] = headlightBackgroundColor.g;
-    preset.headlightBackgroundColor[2] = headlightBackgroundColor.b;
-    preset.taillightBackgroundColor[0] = taillightBackgroundColor.r;
-    preset.taillightBackgroundColor[1] = taillightBackgroundColor.g;
-    preset.taillightBackgroundColor[2] = taillightBackgroundColor.b;
+void captureCurrentPreset(PresetConfig& preset) {
+    preset.brightness = globalBrightness;
+    preset.effectSpeed = effectSpeed;
+    preset.headlightEffect = headlightEffect;
+    preset.taillightEffect = taillightEffect;
+    preset.headlightColor[0] = headlightColor.r;
+    preset.headlightColor[1] = headlightColor.g;
+    preset.headlightColor[2] = headlightColor.b;
+    preset.taillightColor[0] = taillightColor.r;
+    preset.taillightColor[1] = taillightColor.g;
+    preset.taillightColor[2] = taillightColor.b;
+    preset.headlightBackgroundEnabled = headlightBackgroundEnabled;
+    preset.taillightBackgroundEnabled = taillightBackgroundEnabled;
+    preset.headlightBackgroundColor[0] = headlightBackgroundColor.r;
+    preset.headlightBackgroundColor[1] = headlightBackgroundColor.g;
+    preset.headlightBackgroundColor[2] = headlightBackgroundColor.b;
+    preset.taillightBackgroundColor[0] = taillightBackgroundColor.r;
+    preset.taillightBackgroundColor[1] = taillightBackgroundColor.g;
+    preset.taillightBackgroundColor[2] = taillightBackgroundColor.b;
 }
 
 void initDefaultPresets() {
@@ -2534,6 +2064,7 @@ void initDefaultPresets() {
 }
 
 void restoreDefaultsToStock() {
+    LEDLock lock;  // LED counts are reset along with the rest
     Serial.println("🔄 Restoring all settings to stock defaults...");
 
     // Lights
@@ -2570,6 +2101,7 @@ void restoreDefaultsToStock() {
     forwardAccelThreshold = 0.3f;
     brakingEnabled = false;
     brakingThreshold = -0.5f;
+    brakingLatency = BRAKING_DEFAULT_LATENCY_MS;
     brakingEffect = 0;
     brakingBrightness = 255;
 
@@ -2734,27 +2266,28 @@ void savePresetsToDoc(JsonDocument& doc) {
 void startStartupSequence() {
     startupActive = true;
     startupStartTime = millis();
-    startupStep = 0;
     Serial.printf("🎬 Starting %s sequence...\n", getStartupSequenceName(startupSequence).c_str());
 }
 
+// Runs in loop(): ends the sequence once its duration has passed. Normal
+// effects take over on the render task's next frame.
 void updateStartupSequence() {
     if (!startupActive) return;
     
-    unsigned long elapsed = millis() - startupStartTime;
-    
-    // Check if sequence should end
-    if (elapsed >= startupDuration) {
+    if (millis() - startupStartTime >= startupDuration) {
         startupActive = false;
-        // Set final colors
-        fill_solid(headlight, headlightLedCount, headlightColor);
-        fill_solid(taillight, taillightLedCount, taillightColor);
         Serial.println("✅ Startup sequence complete!");
-        return;
     }
+}
+
+// Draw the startup sequence into the base frames (render task). Animations
+// follow elapsed time, so they play the same at any frame rate.
+void renderStartupSequence() {
+    const RenderSettings& rs = renderSettings;
+    startupStep = (millis() - rs.startupStartTime) / FRAMETIME_FIXED;
+    FastLED.setBrightness(rs.brightness);
     
-    // Update sequence based on type
-    switch (startupSequence) {
+    switch (rs.startupSequence) {
         case STARTUP_POWER_ON:
             startupPowerOn();
             break;
@@ -2770,88 +2303,93 @@ void updateStartupSequence() {
         case STARTUP_CUSTOM:
             startupCustom();
             break;
+        default:
+            fill_solid(headlightBase, headlightLedCount, rs.headlightColor);
+            fill_solid(taillightBase, taillightLedCount, rs.taillightColor);
+            break;
     }
-    
-    startupStep++;
 }
 
 void startupPowerOn() {
+    const RenderSettings& rs = renderSettings;
     // Progressive power-on effect - LEDs turn on from center outward
-    uint8_t progress = map(millis() - startupStartTime, 0, startupDuration, 0, 255);
+    uint8_t progress = map(millis() - rs.startupStartTime, 0, rs.startupDuration, 0, 255);
     
     // Headlight - center outward
-    uint8_t headlightCenter = headlightLedCount / 2;
-    uint8_t headlightRadius = map(progress, 0, 255, 0, headlightCenter);
+    uint16_t headlightCenter = headlightLedCount / 2;
+    uint16_t headlightRadius = map(progress, 0, 255, 0, headlightCenter);
     
-    fill_solid(headlight, headlightLedCount, CRGB::Black);
-    for (uint8_t i = 0; i < headlightLedCount; i++) {
-        uint8_t distance = abs(i - headlightCenter);
+    fill_solid(headlightBase, headlightLedCount, CRGB::Black);
+    for (uint16_t i = 0; i < headlightLedCount; i++) {
+        uint16_t distance = abs(i - headlightCenter);
         if (distance <= headlightRadius) {
             uint8_t brightness = map(distance, 0, headlightRadius, 255, 100);
-            CRGB color = headlightColor;
+            CRGB color = rs.headlightColor;
             color.nscale8(brightness);
-            headlight[i] = color;
+            headlightBase[i] = color;
         }
     }
     
     // Taillight - center outward
-    uint8_t taillightCenter = taillightLedCount / 2;
-    uint8_t taillightRadius = map(progress, 0, 255, 0, taillightCenter);
+    uint16_t taillightCenter = taillightLedCount / 2;
+    uint16_t taillightRadius = map(progress, 0, 255, 0, taillightCenter);
     
-    fill_solid(taillight, taillightLedCount, CRGB::Black);
-    for (uint8_t i = 0; i < taillightLedCount; i++) {
-        uint8_t distance = abs(i - taillightCenter);
+    fill_solid(taillightBase, taillightLedCount, CRGB::Black);
+    for (uint16_t i = 0; i < taillightLedCount; i++) {
+        uint16_t distance = abs(i - taillightCenter);
         if (distance <= taillightRadius) {
             uint8_t brightness = map(distance, 0, taillightRadius, 255, 100);
-            CRGB color = taillightColor;
+            CRGB color = rs.taillightColor;
             color.nscale8(brightness);
-            taillight[i] = color;
+            taillightBase[i] = color;
         }
     }
 }
 
 void startupScan() {
+    const RenderSettings& rs = renderSettings;
     // KITT-style scanner effect
-    uint16_t scanSpeed = startupDuration / 4; // 4 scans total
-    uint8_t scanPhase = (millis() - startupStartTime) / scanSpeed;
-    uint8_t scanPos = (millis() - startupStartTime) % scanSpeed;
+    uint16_t scanSpeed = rs.startupDuration / 4; // 4 scans total
+    uint8_t scanPhase = (millis() - rs.startupStartTime) / scanSpeed;
+    uint16_t scanPos = (millis() - rs.startupStartTime) % scanSpeed;
     
     // Headlight scanner
-    fill_solid(headlight, headlightLedCount, CRGB::Black);
-    uint8_t headlightPos = map(scanPos, 0, scanSpeed, 0, headlightLedCount * 2);
+    fill_solid(headlightBase, headlightLedCount, CRGB::Black);
+    uint16_t headlightPos = map(scanPos, 0, scanSpeed, 0, headlightLedCount * 2);
     if (headlightPos >= headlightLedCount) headlightPos = (headlightLedCount * 2) - headlightPos - 1;
     
     for (uint8_t i = 0; i < 3; i++) {
         if (headlightPos - i >= 0 && headlightPos - i < headlightLedCount) {
             uint8_t brightness = 255 - (i * 85);
-            CRGB color = headlightColor;
+            CRGB color = rs.headlightColor;
             color.nscale8(brightness);
-            headlight[headlightPos - i] = color;
+            headlightBase[headlightPos - i] = color;
         }
     }
     
     // Taillight scanner
-    fill_solid(taillight, taillightLedCount, CRGB::Black);
-    uint8_t taillightPos = map(scanPos, 0, scanSpeed, 0, taillightLedCount * 2);
+    fill_solid(taillightBase, taillightLedCount, CRGB::Black);
+    uint16_t taillightPos = map(scanPos, 0, scanSpeed, 0, taillightLedCount * 2);
     if (taillightPos >= taillightLedCount) taillightPos = (taillightLedCount * 2) - taillightPos - 1;
     
     for (uint8_t i = 0; i < 3; i++) {
         if (taillightPos - i >= 0 && taillightPos - i < taillightLedCount) {
             uint8_t brightness = 255 - (i * 85);
-            CRGB color = taillightColor;
+            CRGB color = rs.taillightColor;
             color.nscale8(brightness);
-            taillight[taillightPos - i] = color;
+            taillightBase[taillightPos - i] = color;
         }
     }
 }
 
 void startupWave() {
+    const RenderSettings& rs = renderSettings;
     // Wave effect that builds up
-    uint8_t progress = map(millis() - startupStartTime, 0, startupDuration, 0, 255);
+    uint8_t progress = map(millis() - rs.startupStartTime, 0, rs.startupDuration, 0, 255);
     uint8_t waveCount = map(progress, 0, 255, 1, 4);
     
     // Headlight wave
-    fill_solid(headlight, headlightLedCount, CRGB::Black);
+    fill_solid(headlightBase, headlightLedCount, CRGB::Black);
     for (uint8_t wave = 0; wave < waveCount; wave++) {
         uint16_t wavePos = (startupStep * 2 + wave * (headlightLedCount / waveCount)) % (headlightLedCount * 2);
         if (wavePos >= headlightLedCount) wavePos = (headlightLedCount * 2) - wavePos - 1;
@@ -2859,15 +2397,15 @@ void startupWave() {
         for (uint8_t i = 0; i < 5; i++) {
             if (wavePos - i >= 0 && wavePos - i < headlightLedCount) {
                 uint8_t brightness = 255 - (i * 50);
-                CRGB color = headlightColor;
+                CRGB color = rs.headlightColor;
                 color.nscale8(brightness);
-                headlight[wavePos - i] = color;
+                headlightBase[wavePos - i] = color;
             }
         }
     }
     
     // Taillight wave
-    fill_solid(taillight, taillightLedCount, CRGB::Black);
+    fill_solid(taillightBase, taillightLedCount, CRGB::Black);
     for (uint8_t wave = 0; wave < waveCount; wave++) {
         uint16_t wavePos = (startupStep * 2 + wave * (taillightLedCount / waveCount)) % (taillightLedCount * 2);
         if (wavePos >= taillightLedCount) wavePos = (taillightLedCount * 2) - wavePos - 1;
@@ -2875,63 +2413,65 @@ void startupWave() {
         for (uint8_t i = 0; i < 5; i++) {
             if (wavePos - i >= 0 && wavePos - i < taillightLedCount) {
                 uint8_t brightness = 255 - (i * 50);
-                CRGB color = taillightColor;
+                CRGB color = rs.taillightColor;
                 color.nscale8(brightness);
-                taillight[wavePos - i] = color;
+                taillightBase[wavePos - i] = color;
             }
         }
     }
 }
 
 void startupRace() {
+    const RenderSettings& rs = renderSettings;
     // Racing lights effect - LEDs chase around the strip
-    uint16_t raceSpeed = startupDuration / 6; // 6 laps total
-    uint8_t racePos = (millis() - startupStartTime) % raceSpeed;
+    uint16_t raceSpeed = rs.startupDuration / 6; // 6 laps total
+    uint16_t racePos = (millis() - rs.startupStartTime) % raceSpeed;
     
     // Headlight race
-    fill_solid(headlight, headlightLedCount, CRGB::Black);
-    uint8_t headlightPos = map(racePos, 0, raceSpeed, 0, headlightLedCount);
+    fill_solid(headlightBase, headlightLedCount, CRGB::Black);
+    uint16_t headlightPos = map(racePos, 0, raceSpeed, 0, headlightLedCount);
     
     for (uint8_t i = 0; i < 4; i++) {
-        uint8_t pos = (headlightPos + i) % headlightLedCount;
+        uint16_t pos = (headlightPos + i) % headlightLedCount;
         uint8_t brightness = 255 - (i * 60);
-        CRGB color = headlightColor;
+        CRGB color = rs.headlightColor;
         color.nscale8(brightness);
-        headlight[pos] = color;
+        headlightBase[pos] = color;
     }
     
     // Taillight race
-    fill_solid(taillight, taillightLedCount, CRGB::Black);
-    uint8_t taillightPos = map(racePos, 0, raceSpeed, 0, taillightLedCount);
+    fill_solid(taillightBase, taillightLedCount, CRGB::Black);
+    uint16_t taillightPos = map(racePos, 0, raceSpeed, 0, taillightLedCount);
     
     for (uint8_t i = 0; i < 4; i++) {
-        uint8_t pos = (taillightPos + i) % taillightLedCount;
+        uint16_t pos = (taillightPos + i) % taillightLedCount;
         uint8_t brightness = 255 - (i * 60);
-        CRGB color = taillightColor;
+        CRGB color = rs.taillightColor;
         color.nscale8(brightness);
-        taillight[pos] = color;
+        taillightBase[pos] = color;
     }
 }
 
 void startupCustom() {
+    const RenderSettings& rs = renderSettings;
     // Custom sequence - rainbow fade-in with breathing effect
-    uint8_t progress = map(millis() - startupStartTime, 0, startupDuration, 0, 255);
+    uint8_t progress = map(millis() - rs.startupStartTime, 0, rs.startupDuration, 0, 255);
     
     // Breathing effect
     uint8_t breathe = (sin(millis() / 200.0) + 1) * 127;
     
     // Headlight - rainbow fade-in
-    for (uint8_t i = 0; i < headlightLedCount; i++) {
+    for (uint16_t i = 0; i < headlightLedCount; i++) {
         uint8_t hue = (i * 255 / headlightLedCount) + (startupStep * 2);
         CRGB color = CHSV(hue, 255, breathe);
-        headlight[i] = color;
+        headlightBase[i] = color;
     }
     
     // Taillight - rainbow fade-in
-    for (uint8_t i = 0; i < taillightLedCount; i++) {
+    for (uint16_t i = 0; i < taillightLedCount; i++) {
         uint8_t hue = (i * 255 / taillightLedCount) + (startupStep * 2);
         CRGB color = CHSV(hue, 255, breathe);
-        taillight[i] = color;
+        taillightBase[i] = color;
     }
 }
 
@@ -2962,10 +2502,14 @@ void initMotionControl() {
     Serial.println("✅ MPU6050 initialized successfully!");
     
     // Configure MPU6050
-    mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_2);
+    mpu.setFullScaleAccelRange(MPU6050_ACCEL_FS_8);  // +-8G so crash peaks no longer clip at +-2G (see MOTION_ACCEL_LSB_PER_G)
     mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_500);
     mpu.setDLPFMode(MPU6050_DLPF_BW_20);
     
+    // 400kHz I2C: a 2-sample burst read is ~0.7ms instead of ~2.5ms
+    Wire.setClock(400000);
+    startMotionSampling();
+    
     Serial.println("🎯 Motion control features:");
     Serial.println("  - Auto blinkers based on lean angle");
     Serial.println("  - Park mode when stationary and tilted");
@@ -2973,140 +2517,553 @@ void initMotionControl() {
     Serial.println("  - Calibration system for orientation independence");
 }
 
-MotionData getMotionData() {
-    int16_t ax, ay, az, gx, gy, gz;
-    mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-    
-    // Convert raw values to meaningful units
-    float accelX = ax / 16384.0; // 2G range
-    float accelY = ay / 16384.0;
-    float accelZ = az / 16384.0;
-    float gyroX = gx / 65.5; // 500 deg/s range
-    float gyroY = gy / 65.5;
-    float gyroZ = gz / 65.5;
-    
-    // Calculate pitch and roll from accelerometer
-    float pitch = atan2(-accelX, sqrt(accelY * accelY + accelZ * accelZ)) * 180.0 / PI;
-    float roll = atan2(accelY, accelZ) * 180.0 / PI;
-    float yaw = gyroZ;
-    
-    return {
-        pitch,
-        roll,
-        yaw,
-        accelX,
-        accelY,
-        accelZ,
-        gyroX,
-        gyroY,
-        gyroZ
-    };
+void IRAM_ATTR onMotionDataReady() {
+    motionInterrupts++;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sensorTaskHandle, &woken);
+    portYIELD_FROM_ISR(woken);
 }
 
-void updateMotionControl() {
-    // Handle calibration mode - only show debug info, don't auto-capture
-    if (calibrationMode) {
-        MotionData data = getMotionData();
-        // Show current motion data for debugging during calibration
-        static unsigned long lastCalibrationDebug = 0;
-        if (millis() - lastCalibrationDebug >= 1000) { // Update every second
-            Serial.printf("Calibration Step %d - Accel: X=%.2f, Y=%.2f, Z=%.2f\n", 
-                         calibrationStep + 1, data.accelX, data.accelY, data.accelZ);
-            lastCalibrationDebug = millis();
-        }
+// Read whatever whole samples the FIFO holds and queue them for loop()
+void readMotionFifo() {
+    uint16_t fifoBytes = mpu.getFIFOCount();
+    if (fifoBytes > MOTION_FIFO_BYTES - MOTION_SAMPLE_BYTES || mpu.getIntFIFOBufferOverflowStatus()) {
+        // A full FIFO drops bytes and loses record alignment - start over
+        mpu.resetFIFO();
+        motionFifoOverflows++;
         return;
     }
     
-    if (!motionEnabled) return;
-    
-    MotionData data = getMotionData();
+    uint16_t available = fifoBytes / MOTION_SAMPLE_BYTES;
+    if (available < MOTION_FIFO_BATCH) return;
     
-    // Process motion features
-    if (directionBasedLighting) {
-        processDirectionDetection(data);
+    // The newest sample was taken at most one period ago; older ones are a period apart
+    uint32_t newestUs = micros();
+    uint8_t buffer[MOTION_SAMPLE_BYTES * MOTION_FIFO_READ_SAMPLES];
+    uint16_t read = 0;
+    while (read < available) {
+        uint16_t count = available - read;
+        if (count > MOTION_FIFO_READ_SAMPLES) count = MOTION_FIFO_READ_SAMPLES;
+        mpu.getFIFOBytes(buffer, count * MOTION_SAMPLE_BYTES);
+        
+        for (uint16_t i = 0; i < count; i++) {
+            const uint8_t* record = buffer + i * MOTION_SAMPLE_BYTES;
+            MotionSample sample;
+            sample.timeUs = newestUs - (available - 1 - (read + i)) * MOTION_SAMPLE_PERIOD_US;
+            sample.ax = (int16_t)((record[0] << 8) | record[1]);
+            sample.ay = (int16_t)((record[2] << 8) | record[3]);
+            sample.az = (int16_t)((record[4] << 8) | record[5]);
+            sample.gx = (int16_t)((record[6] << 8) | record[7]);
+            sample.gy = (int16_t)((record[8] << 8) | record[9]);
+            sample.gz = (int16_t)((record[10] << 8) | record[11]);
+            if (!ringPush(motionRing, sample)) {
+                motionSamplesDropped++;
+            }
+        }
+        read += count;
+    }
+    motionSamplesRead += available;
+    wakeLoop(LOOP_EVENT_MOTION);
+}
+
+// Park the sensor: accel-only cycle mode, interrupt on motion (sensor task)
+void enterMotionStandby() {
+    mpu.setIntDataReadyEnabled(false);
+    mpu.setFIFOEnabled(false);
+    
+    // Motion detection compares high-passed accel against MOT_THR
+    mpu.setDHPFMode(MPU6050_DHPF_5);
+    mpu.setMotionDetectionThreshold(motionWakeThreshold);
+    mpu.setMotionDetectionDuration(MOTION_WAKE_DURATION);
+    mpu.getIntStatus();  // Drop anything pending
+    mpu.setIntMotionEnabled(true);
+    
+    // Gyros off - they clock the chip, so switch to the internal oscillator first
+    mpu.setClockSource(MPU6050_CLOCK_INTERNAL);
+    mpu.setStandbyXGyroEnabled(true);
+    mpu.setStandbyYGyroEnabled(true);
+    mpu.setStandbyZGyroEnabled(true);
+    mpu.setWakeFrequency(MOTION_WAKE_FREQ);
+    mpu.setWakeCycleEnabled(true);
+    
+    motionStandby = true;
+    motionStandbyEntries++;
+}
+
+// Back to full-rate FIFO sampling (sensor task)
+void exitMotionStandby() {
+    mpu.setWakeCycleEnabled(false);
+    mpu.setStandbyXGyroEnabled(false);
+    mpu.setStandbyYGyroEnabled(false);
+    mpu.setStandbyZGyroEnabled(false);
+    mpu.setClockSource(MPU6050_CLOCK_PLL_XGYRO);
+    mpu.setIntMotionEnabled(false);
+    
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
+    mpu.setIntDataReadyEnabled(true);
+    motionStandby = false;
+}
+
+// Sensor task - sleeps until the MPU6050 raises data-ready, then drains its
+// FIFO. While parked it sleeps until the motion interrupt instead.
+void sensorTask(void* arg) {
+    for (;;) {
+        if (motionStandby) {
+            // The slow poll only matters when the INT pin isn't wired
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MOTION_STANDBY_POLL_MS));
+            bool moved = mpu.getIntMotionStatus();
+            if (moved || !motionStandbyRequested) {
+                exitMotionStandby();
+            }
+            if (moved) {
+                motionWakes++;
+                motionWoke = true;
+                wakeLoop(LOOP_EVENT_MOTION);
+            }
+            continue;
+        }
+        
+        // Timeout keeps samples flowing (in batches) when the INT pin isn't wired
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MOTION_FIFO_POLL_MS));
+        if (motionStandbyRequested && !motionWoke) {
+            enterMotionStandby();
+            continue;
+        }
+        PerfScope perf(perfStats[PERF_IMU_READ]);
+        readMotionFifo();
     }
+}
+
+// Park the sensor while park mode holds, and end park mode when it wakes on
+// motion - the detectors only see samples again once it does (loop)
+void serviceMotionStandby() {
+    if (sensorTaskHandle == nullptr) return;
     
-    if (brakingEnabled) {
-        processBrakingDetection(data);
+    if (motionWoke) {
+        if (motion.parkModeActive) {
+            motion.parkModeActive = false;
+            motion.parkStartTime = 0;
+            publishMotionState();
+            #if DEBUG_ENABLED
+            Serial.println("🅿️ Park mode deactivated (woke on motion)");
+            #endif
+        }
+        motionStandbyRequested = false;
+        motionWoke = false;
     }
     
-    if (blinkerEnabled) {
-        processBlinkers(data);
+    // Recording and calibration need the full sample stream
+    bool wanted = motion.parkModeActive && motionEnabled && parkModeEnabled && !recording && !calibrationMode;
+    if (wanted != motionStandbyRequested) {
+        if (wanted) {
+            motionWakeThreshold = (uint8_t)constrain((int)(parkAccelNoiseThreshold * 1000 / MOTION_WAKE_MG_PER_LSB), 1, 255);
+        }
+        motionStandbyRequested = wanted;
+        xTaskNotifyGive(sensorTaskHandle);
     }
+}
+
+// Route accel + gyro through the FIFO at MOTION_SAMPLE_RATE_HZ and start the sensor task
+void startMotionSampling() {
+    // Sample rate = 1kHz gyro output rate (DLPF on) / (1 + divider)
+    mpu.setRate(1000 / MOTION_SAMPLE_RATE_HZ - 1);
+    mpu.setAccelFIFOEnabled(true);
+    mpu.setXGyroFIFOEnabled(true);
+    mpu.setYGyroFIFOEnabled(true);
+    mpu.setZGyroFIFOEnabled(true);
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
     
-    if (parkModeEnabled) {
-        processParkMode(data);
-    }
+    // Active-high 50us pulse per sample; status is cleared by reading it
+    mpu.setInterruptMode(false);
+    mpu.setInterruptLatch(false);
+    mpu.setIntDataReadyEnabled(true);
     
-    if (impactDetectionEnabled) {
-        processImpactDetection(data);
+    BaseType_t created = xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_TASK_STACK_SIZE, nullptr,
+                                                 SENSOR_TASK_PRIORITY, &sensorTaskHandle, SENSOR_TASK_CORE);
+    if (created != pdPASS) {
+        sensorTaskHandle = nullptr;
+        Serial.println("❌ Failed to start sensor task - motion control disabled");
+        motionEnabled = false;
+        return;
     }
+    
+    pinMode(MPU_INT_PIN, INPUT_PULLDOWN);  // INT is active-high push-pull; an unwired pad must not float
+    attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), onMotionDataReady, RISING);
+    Serial.printf("📈 Sensor task sampling MPU6050 FIFO at %dHz (INT on GPIO %d, core %d)\n",
+                  MOTION_SAMPLE_RATE_HZ, MPU_INT_PIN, SENSOR_TASK_CORE);
 }
 
-void processBrakingDetection(MotionData& data) {
-    if (manualBrakeActive) return;
-    if (!brakingEnabled || !motionEnabled) return;
+// Latest sample the detectors saw (calibration captures read it from loop())
+MotionData getMotionData() {
+    return latestMotionData;
+}
+
+// Drain the sample ring, feeding every sample to the detectors in order and
+// publishing their results to the render task after each one
+void processMotionSamples() {
+    if (sensorTaskHandle == nullptr) return;
     
-    unsigned long currentTime = millis();
-    float forwardAccel = calibration.valid ? getCalibratedForwardAccel(data) : data.accelX;
+    static uint32_t rateWindowStart = 0;
+    static uint32_t rateWindowSamples = 0;
     
-    // Only detect braking when moving forward (negative acceleration = deceleration)
-    // Also check if we're not in park mode (stationary)
-    bool isDecelerating = isMovingForward && forwardAccel < brakingThreshold && !parkModeActive;
+    MotionConfig config;
+    buildMotionConfig(config);
     
-    if (isDecelerating) {
-        if (brakingDetectedTime == 0) {
-            // Start tracking sustained deceleration
-            brakingDetectedTime = currentTime;
-        } else {
-            unsigned long elapsed = currentTime - brakingDetectedTime;
-            if (elapsed >= BRAKING_SUSTAIN_TIME && !brakingActive) {
-                // Deceleration sustained long enough - activate braking
-                brakingActive = true;
-                brakingStartTime = currentTime;
-                brakingFlashCount = 0;
-                brakingPulseCount = 0;
-                lastBrakingFlash = currentTime;
-                lastBrakingPulse = currentTime;
-                #if DEBUG_ENABLED
-                Serial.printf("🛑 Braking detected! Deceleration: %.2fG (sustained for %dms)\n", 
-                             forwardAccel, elapsed);
-                #endif
+    MotionSample sample;
+    while (ringPop(motionRing, sample)) {
+        motionSamplesProcessed++;
+        rateWindowSamples++;
+        
+        // Samples are exactly one sensor period apart (the FIFO is paced by the MPU's clock)
+        MotionData data = motionFuseSample(motion.attitude, sample, MOTION_SAMPLE_PERIOD_US / 1000000.0f);
+        latestMotionData = data;
+        impactHistory[impactHistoryCount++ & (IMPACT_PRE_SAMPLES - 1)] = sample;
+        if (recording || impactCaptureRemaining > 0) {
+            recordMotionSample(sample);
+        }
+        
+        // Detector timers run on the sample's own time, as they do in a replay
+        uint32_t sampleMs = millis() - (micros() - sample.timeUs) / 1000;
+        updateMotionControl(config, data, sampleMs);
+        publishMotionState();
+    }
+    
+    uint32_t nowMs = millis();
+    if (nowMs - rateWindowStart >= 1000) {
+        motionSampleRateHz = (uint16_t)(rateWindowSamples * 1000UL / (nowMs - rateWindowStart));
+        rateWindowStart = nowMs;
+        rateWindowSamples = 0;
+    }
+}
+
+// Recorder writer - moves full chunks from PSRAM to SPIFFS and hands them back
+void recorderTask(void* arg) {
+    File file;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint8_t index;
+        while (ringPop(recorderFull, index)) {
+            RecorderChunk& chunk = recorderChunks[index];
+            if (chunk.first) {
+                file = SPIFFS.open(chunk.path, "w");
+                recordingBytesWritten = 0;
+                if (!file) recordingWriteErrors++;
             }
+            if (file && chunk.bytes > 0) {
+                size_t written = file.write(chunk.data, chunk.bytes);
+                if (written != chunk.bytes) recordingWriteErrors++;
+                recordingBytesWritten += written;
+            }
+            bool closed = chunk.last;
+            if (closed && file) file.close();
+            ringPush(recorderFree, index);
+            // Every chunk is back before the next log may start
+            if (closed) recorderFileOpen = false;
         }
+    }
+}
+
+// Queue the chunk being filled for the writer
+void submitRecorderChunk(bool last) {
+    recorderChunk->last = last;
+    ringPush(recorderFull, recorderChunkIndex);
+    recorderChunk = nullptr;
+    xTaskNotifyGive(recorderTaskHandle);
+}
+
+bool takeRecorderChunk() {
+    if (!ringPop(recorderFree, recorderChunkIndex)) return false;
+    recorderChunk = &recorderChunks[recorderChunkIndex];
+    recorderChunk->bytes = 0;
+    recorderChunk->first = false;
+    recorderChunk->last = false;
+    return true;
+}
+
+// PSRAM chunks and the writer task, on first use
+bool initRecorder() {
+    if (recorderChunks != nullptr) return true;
+    recorderChunks = (RecorderChunk*)ps_malloc(sizeof(RecorderChunk) * RECORDER_CHUNKS);
+    if (recorderChunks == nullptr) {
+        Serial.println("❌ Recording needs PSRAM for its sample buffer");
+        return false;
+    }
+    for (uint8_t i = 0; i < RECORDER_CHUNKS; i++) {
+        ringPush(recorderFree, i);
+    }
+    BaseType_t created = xTaskCreatePinnedToCore(recorderTask, "recorder", RECORDER_TASK_STACK_SIZE, nullptr,
+                                                 RECORDER_TASK_PRIORITY, &recorderTaskHandle, RECORDER_TASK_CORE);
+    if (created != pdPASS) {
+        free(recorderChunks);
+        recorderChunks = nullptr;
+        recorderFree.head = 0;
+        recorderFree.tail = 0;
+        recorderTaskHandle = nullptr;
+        Serial.println("❌ Failed to start recorder task");
+        return false;
+    }
+    return true;
+}
+
+// Open a log: header into the first chunk. previousUs is the time the
+// first sample's delta counts from.
+bool startRecorderLog(const char* path, uint32_t startMs, uint32_t previousUs) {
+    if (!takeRecorderChunk()) return false;
+    recorderChunk->first = true;
+    recorderChunk->path = path;
+    
+    MotionLogHeader header;
+    MotionConfig config;
+    buildMotionConfig(config);
+    motionLogInitHeader(header, MOTION_SAMPLE_RATE_HZ, startMs, config);
+    memcpy(recorderChunk->data, &header, sizeof(header));
+    recorderChunk->bytes = sizeof(header);
+    
+    recorderPreviousUs = previousUs;
+    recorderBytesQueued = sizeof(header);
+    recordingBytesWritten = 0;
+    recordingWriteErrors = 0;
+    recorderFileOpen = true;
+    return true;
+}
+
+// Close the open log
+void finishRecorderLog() {
+    if (recorderChunk != nullptr || takeRecorderChunk()) {
+        submitRecorderChunk(true);
     } else {
-        // Not decelerating - reset detection timer
-        if (brakingDetectedTime > 0) {
-            brakingDetectedTime = 0;
+        // Every chunk is queued; serviceRecorder() sends the close once one comes back
+        recorderClosePending = true;
+    }
+}
+
+// false when no chunk was free (writer behind)
+bool appendRecorderSample(const MotionSample& sample) {
+    if (recorderChunk != nullptr && recorderChunk->bytes + sizeof(MotionLogRecord) > RECORDER_CHUNK_BYTES) {
+        submitRecorderChunk(false);
+    }
+    if (recorderChunk == nullptr && !takeRecorderChunk()) return false;
+    
+    MotionLogRecord record = motionLogEncode(sample, recorderPreviousUs);
+    memcpy(recorderChunk->data + recorderChunk->bytes, &record, sizeof(record));
+    recorderChunk->bytes += sizeof(record);
+    recorderBytesQueued += sizeof(record);
+    return true;
+}
+
+bool startRecording() {
+    if (recording) return true;
+    if (sensorTaskHandle == nullptr) {
+        Serial.println("❌ Recording needs the MPU6050");
+        return false;
+    }
+    if (recorderFileOpen || recorderClosePending) {
+        Serial.println("❌ Previous recording is still being written");
+        return false;
+    }
+    if (!initRecorder()) return false;
+    
+    // The previous log is overwritten, so its space counts as free
+    uint32_t freeBytes = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    File previous = SPIFFS.open(RECORDER_PATH, "r");
+    if (previous) {
+        freeBytes += previous.size();
+        previous.close();
+    }
+    recorderLimitBytes = freeBytes > RECORDER_FS_MARGIN ? freeBytes - RECORDER_FS_MARGIN : 0;
+    if (recorderLimitBytes > RECORDER_MAX_BYTES) recorderLimitBytes = RECORDER_MAX_BYTES;
+    if (recorderLimitBytes < RECORDER_CHUNK_BYTES) {
+        Serial.println("❌ Not enough SPIFFS space to record");
+        return false;
+    }
+    
+    if (!startRecorderLog(RECORDER_PATH, millis(), micros())) return false;
+    recordingSamples = 0;
+    recordingDropped = 0;
+    recording = true;
+    Serial.printf("⏺️ Recording IMU samples to %s (up to %luKB)\n", RECORDER_PATH,
+                  (unsigned long)(recorderLimitBytes / 1024));
+    return true;
+}
+
+// Save the samples around an impact (IMPACT_PRE_SAMPLES before, including
+// the trigger, IMPACT_POST_SAMPLES after) to IMPACT_CAPTURE_PATH
+void startImpactCapture() {
+    if (recording) return;  // The ride log already has it
+    if (recorderFileOpen || recorderClosePending || impactCaptureRemaining > 0) return;
+    if (!initRecorder()) return;
+    
+    uint32_t count = impactHistoryCount < IMPACT_PRE_SAMPLES ? impactHistoryCount : IMPACT_PRE_SAMPLES;
+    if (count == 0) return;
+    uint32_t oldest = impactHistoryCount - count;
+    const MotionSample& first = impactHistory[oldest & (IMPACT_PRE_SAMPLES - 1)];
+    if (!startRecorderLog(IMPACT_CAPTURE_PATH, millis() - (micros() - first.timeUs) / 1000, first.timeUs)) return;
+    for (uint32_t i = oldest; i < impactHistoryCount; i++) {
+        appendRecorderSample(impactHistory[i & (IMPACT_PRE_SAMPLES - 1)]);
+    }
+    impactCaptureRemaining = IMPACT_POST_SAMPLES;
+    impactCaptures++;
+}
+
+void stopRecording() {
+    if (!recording) return;
+    recording = false;
+    finishRecorderLog();
+    Serial.printf("⏹️ Recording stopped: %lu samples, %lu dropped\n",
+                  (unsigned long)recordingSamples, (unsigned long)recordingDropped);
+}
+
+void serviceRecorder() {
+    if (recorderClosePending && takeRecorderChunk()) {
+        recorderClosePending = false;
+        submitRecorderChunk(true);
+    }
+}
+
+void recordMotionSample(const MotionSample& sample) {
+    bool appended = appendRecorderSample(sample);
+    
+    if (!recording) {
+        // Impact capture - dropped samples just shorten the window
+        if (--impactCaptureRemaining == 0) {
+            finishRecorderLog();
+            Serial.printf("💥 Impact samples saved to %s\n", IMPACT_CAPTURE_PATH);
         }
-        
-        // Stop braking if:
-        // 1. Acceleration becomes positive (starting to go forward again)
-        // 2. Or we're in park mode (stopped)
-        if (brakingActive && (forwardAccel >= 0 || parkModeActive)) {
-            brakingActive = false;
-            brakingFlashCount = 0;
-            brakingPulseCount = 0;
-            #if DEBUG_ENABLED
-            Serial.println("🛑 Braking ended");
-            #endif
+        return;
+    }
+    
+    if (!appended) {
+        recordingDropped++;
+        return;
+    }
+    recordingSamples++;
+    if (recorderBytesQueued + sizeof(MotionLogRecord) > recorderLimitBytes) {
+        Serial.println("⏺️ Recording reached its size limit");
+        stopRecording();
+    }
+}
+
+// Detector settings from the user settings (once per batch of samples)
+void buildMotionConfig(MotionConfig& config) {
+    config.directionBasedLighting = directionBasedLighting;
+    config.brakingEnabled = brakingEnabled;
+    config.blinkerEnabled = blinkerEnabled;
+    config.parkModeEnabled = parkModeEnabled;
+    config.impactDetectionEnabled = impactDetectionEnabled;
+    config.forwardAccelThreshold = forwardAccelThreshold;
+    config.brakingThreshold = brakingThreshold;
+    config.brakingLatencyMs = brakingLatency;
+    config.sampleRateHz = MOTION_SAMPLE_RATE_HZ;
+    config.motionSensitivity = motionSensitivity;
+    config.blinkerTimeout = blinkerTimeout;
+    config.parkAccelNoiseThreshold = parkAccelNoiseThreshold;
+    config.parkGyroNoiseThreshold = parkGyroNoiseThreshold;
+    config.parkStationaryTime = parkStationaryTime;
+    config.impactThreshold = impactThreshold;
+    config.calibration = calibration;
+}
+
+void updateMotionControl(const MotionConfig& config, MotionData& data, uint32_t nowMs) {
+    // Handle calibration mode - only show debug info, don't auto-capture
+    if (calibrationMode) {
+        // Show current motion data for debugging during calibration
+        static unsigned long lastCalibrationDebug = 0;
+        if (millis() - lastCalibrationDebug >= 1000) { // Update every second
+            Serial.printf("Calibration Step %d - Accel: X=%.2f, Y=%.2f, Z=%.2f\n", 
+                         calibrationStep + 1, data.accelX, data.accelY, data.accelZ);
+            lastCalibrationDebug = millis();
         }
+        return;
     }
+    
+    if (!motionEnabled) return;
+    
+    uint16_t events = motionDetect(motion, config, data, nowMs);
+    if (events == 0) return;
+    
+    if (events & MOTION_EVENT_IMPACT) {
+        startImpactCapture();
+    }
+    if (events & MOTION_EVENT_IMPACT_PEAK) {
+        Serial.printf("💥 Impact detected! Peak G-force: %.1f\n", motion.lastImpactG);
+    }
+    if (events & MOTION_EVENT_BLINKER_OFF) {
+        Serial.println("🔄 Blinker deactivated");
+    }
+    #if DEBUG_ENABLED
+    if (events & MOTION_EVENT_BRAKE_ON) {
+        Serial.printf("🛑 Braking detected! (%lums after the deceleration reached the threshold)\n", (unsigned long)(nowMs - motion.brakingDetectedTime));
+    }
+    if (events & MOTION_EVENT_BRAKE_OFF) Serial.println("🛑 Braking ended");
+    if (events & MOTION_EVENT_BLINKER_ON) {
+        Serial.printf("🔄 Blinker activated: %s\n", motion.blinkerDirection > 0 ? "Right" : "Left");
+    }
+    if (events & MOTION_EVENT_PARK_ON) {
+        Serial.printf("🅿️ Park mode activated (stationary for %dms)\n", parkStationaryTime);
+    }
+    if (events & MOTION_EVENT_PARK_OFF) Serial.println("🅿️ Park mode deactivated (motion detected)");
+    if (events & MOTION_EVENT_DIRECTION_FADE) {
+        Serial.printf("🔄 Direction change confirmed - starting fade to %s\n", motion.isMovingForward ? "Backward" : "Forward");
+    }
+    if (events & MOTION_EVENT_DIRECTION) {
+        Serial.printf("🔄 Direction switched: %s\n", motion.isMovingForward ? "Forward" : "Backward");
+    }
+    #endif
 }
 
+// Brake overlay: renders the flash/pulse pattern into the brake layer of
+// whichever strip is currently at the back
 void showBrakingEffect() {
-    if (!brakingActive) return;
+    const RenderSettings& rs = renderSettings;
+    static unsigned long cycleStartTime = 0;
+    static bool wasBraking = false;
+    Layer& headlightBrake = headlightLayers.layers[LAYER_BRAKE];
+    Layer& taillightBrake = taillightLayers.layers[LAYER_BRAKE];
+    
+    if (!motionState.brakingActive || motionState.parkModeActive) {
+        wasBraking = false;
+        // Release: fade the last brake frame out over the base effect
+        layerFadeTo(headlightBrake, 0, BRAKE_RELEASE_FADE_RATE);
+        layerFadeTo(taillightBrake, 0, BRAKE_RELEASE_FADE_RATE);
+        return;
+    }
     
     unsigned long currentTime = millis();
-    unsigned long brakingElapsed = currentTime - brakingStartTime;
+    unsigned long brakingElapsed = currentTime - motionState.brakingStartTime;
+    
+    // New brake event (detected or manual): restart the flash/pulse cycles.
+    // The cycle counters are only touched here, on the render task.
+    if (!wasBraking || motionState.brakingStartTime != cycleStartTime) {
+        cycleStartTime = motionState.brakingStartTime;
+        brakingFlashCount = 0;
+        brakingPulseCount = 0;
+        lastBrakingFlash = currentTime;
+        lastBrakingPulse = currentTime;
+    }
+    wasBraking = true;
     
     // Determine which lights are taillight (based on direction)
-    CRGB* targetLights = isMovingForward ? taillight : headlight;
-    uint8_t targetCount = isMovingForward ? taillightLedCount : headlightLedCount;
-    uint8_t targetLedType = isMovingForward ? taillightLedType : headlightLedType;
-    uint8_t targetColorOrder = isMovingForward ? taillightColorOrder : headlightColorOrder;
+    Layer& brake = motionState.isMovingForward ? taillightBrake : headlightBrake;
+    Layer& otherBrake = motionState.isMovingForward ? headlightBrake : taillightBrake;
+    uint16_t targetCount = motionState.isMovingForward ? taillightLedCount : headlightLedCount;
+    
+    // Brake light comes on immediately; the other strip's brake layer fades out as solid red
+    layerFadeTo(brake, 255, LAYER_FADE_INSTANT);
+    otherBrake.pixels = nullptr;
+    layerFadeTo(otherBrake, 0, BRAKE_RELEASE_FADE_RATE);
+    
+    if (brakeFrame == nullptr) {
+        // No frame arena: plain solid red brake light
+        brake.pixels = nullptr;
+        FastLED.setBrightness(rs.brakingBrightness);
+        return;
+    }
+    brake.pixels = brakeFrame;
+    CRGB* targetLights = brakeFrame;
     
-    if (brakingEffect == 0) {
+    if (rs.brakingEffect == 0) {
         // Flash mode: Flash 3 times then stay solid red
         if (brakingFlashCount < BRAKING_CYCLE_COUNT) {
             // Still in flash phase
@@ -3114,11 +3071,11 @@ void showBrakingEffect() {
             bool flashOn = (flashElapsed % (BRAKING_FLASH_INTERVAL * 2)) < BRAKING_FLASH_INTERVAL;
             
             if (flashOn) {
-                FastLED.setBrightness(brakingBrightness);
-                fillSolidWithColorOrder(targetLights, targetCount, CRGB::Red, targetLedType, targetColorOrder);
+                FastLED.setBrightness(rs.brakingBrightness);
+                fill_solid(targetLights, targetCount, CRGB::Red);
             } else {
                 // Off phase
-                fillSolidWithColorOrder(targetLights, targetCount, CRGB::Black, targetLedType, targetColorOrder);
+                fill_solid(targetLights, targetCount, CRGB::Black);
             }
             
             // Check if we've completed a flash cycle
@@ -3128,8 +3085,8 @@ void showBrakingEffect() {
             }
         } else {
             // Flash phase complete - stay solid red
-            FastLED.setBrightness(brakingBrightness);
-            fillSolidWithColorOrder(targetLights, targetCount, CRGB::Red, targetLedType, targetColorOrder);
+            FastLED.setBrightness(rs.brakingBrightness);
+            fill_solid(targetLights, targetCount, CRGB::Red);
         }
     } else {
         // Pulse mode: Pulse from center 3 times then stay solid red
@@ -3139,457 +3096,117 @@ void showBrakingEffect() {
             float pulseProgress = (float)pulseElapsed / BRAKING_PULSE_DURATION;
             
             // Clear taillight first
-            fillSolidWithColorOrder(targetLights, targetCount, CRGB::Black, targetLedType, targetColorOrder);
+            fill_solid(targetLights, targetCount, CRGB::Black);
             
             // Pulse from center outward
-            uint8_t center = targetCount / 2;
+            uint16_t center = targetCount / 2;
             float pulseWidth = sin(pulseProgress * PI) * (targetCount / 2.0);
-            uint8_t pulseStart = center - (uint8_t)pulseWidth;
-            uint8_t pulseEnd = center + (uint8_t)pulseWidth;
+            uint16_t pulseStart = center - (uint16_t)pulseWidth;
+            uint16_t pulseEnd = center + (uint16_t)pulseWidth;
             
             // Clamp to array bounds
             if (pulseStart < 0) pulseStart = 0;
             if (pulseEnd > targetCount) pulseEnd = targetCount;
             
             // Fill pulse region with red
-            for (uint8_t i = pulseStart; i < pulseEnd; i++) {
+            for (uint16_t i = pulseStart; i < pulseEnd; i++) {
                 float distanceFromCenter = abs((float)(i - center));
                 float normalizedDistance = pulseWidth > 0 ? distanceFromCenter / pulseWidth : 0;
-                uint8_t brightness = brakingBrightness * (1.0 - normalizedDistance);
+                uint8_t brightness = rs.brakingBrightness * (1.0 - normalizedDistance);
                 CRGB red = CRGB::Red;
                 red.nscale8(brightness);
                 targetLights[i] = red;
             }
             
-            // Apply color order
-            applyColorOrderToArray(targetLights, targetCount, targetLedType, targetColorOrder);
-            
             // Check if we've completed a pulse cycle (when pulseProgress wraps back to 0)
-            if (pulseElapsed < 50 && currentTime - lastBrakingPulse >= BRAKING_PULSE_DURATION) {
-                brakingPulseCount++;
-                lastBrakingPulse = currentTime;
-            }
-        } else {
-            // Pulse phase complete - stay solid red
-            FastLED.setBrightness(brakingBrightness);
-            fillSolidWithColorOrder(targetLights, targetCount, CRGB::Red, targetLedType, targetColorOrder);
-        }
-    }
-}
-
-void processBlinkers(MotionData& data) {
-    unsigned long currentTime = millis();
-    if (manualBlinkerActive) return;
-    
-    // Use calibrated values if available
-    float leftRightAccel = calibration.valid ? getCalibratedLeftRightAccel(data) : data.accelY;
-    
-    // Detect turn intent based on lateral acceleration
-    float turnThreshold = 1.5 * motionSensitivity;
-    bool turnIntent = abs(leftRightAccel) > turnThreshold;
-    
-    if (turnIntent) {
-        int direction = (leftRightAccel > 0) ? 1 : -1; // 1 = right, -1 = left
-        
-        if (!blinkerActive) {
-            blinkerActive = true;
-            blinkerDirection = direction;
-            blinkerStartTime = currentTime;
-            #if DEBUG_ENABLED
-            Serial.printf("🔄 Blinker activated: %s\n", direction > 0 ? "Right" : "Left");
-            #endif
-        }
-    } else if (blinkerActive && currentTime - blinkerStartTime > blinkerTimeout) {
-        blinkerActive = false;
-        blinkerDirection = 0;
-        Serial.println("🔄 Blinker deactivated");
-    }
-    
-    // Blinker effect is now handled in updateEffects() with proper priority
-}
-
-void processParkMode(MotionData& data) {
-    unsigned long currentTime = millis();
-    
-    // Calculate motion magnitude from accelerometer and gyroscope
-    // For acceleration, we want to detect changes from the baseline (gravity)
-    // So we calculate the deviation from 1G (gravity)
-    float accelMagnitude = sqrt(data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ);
-    float accelDeviation = abs(accelMagnitude - 1.0); // Deviation from 1G (gravity)
-    float gyroMagnitude = sqrt(data.gyroX * data.gyroX + data.gyroY * data.gyroY + data.gyroZ * data.gyroZ);
-    
-    // Convert gyro to deg/s for easier threshold setting
-    float gyroDegPerSec = gyroMagnitude;
-    
-    // Define noise thresholds (adjustable via settings)
-    float accelNoiseThreshold = parkAccelNoiseThreshold; // G-force threshold for acceleration noise
-    float gyroNoiseThreshold = parkGyroNoiseThreshold;  // deg/s threshold for gyro noise
-    
-    // Debug output every 2 seconds
-    #if DEBUG_ENABLED
-    static unsigned long lastDebugTime = 0;
-    if (currentTime - lastDebugTime > 2000) {
-        Serial.printf("🔍 Park Debug - Accel: %.3fG (dev: %.3f), Gyro: %.1f°/s, Thresholds: %.3fG, %.1f°/s\n", 
-                     accelMagnitude, accelDeviation, gyroDegPerSec, accelNoiseThreshold, gyroNoiseThreshold);
-        lastDebugTime = currentTime;
-    }
-    #endif
-    
-    // Check if device is stationary (below noise thresholds)
-    // Use acceleration deviation from gravity instead of total magnitude
-    bool isStationary = (accelDeviation < accelNoiseThreshold) && (gyroDegPerSec < gyroNoiseThreshold);
-    
-    if (isStationary) {
-        if (!parkModeActive) {
-            if (parkStartTime == 0) {
-                // Start park mode timer
-                parkStartTime = currentTime;
-                #if DEBUG_ENABLED
-                Serial.printf("🅿️ Starting park timer (stationary detected)\n");
-                #endif
-            } else {
-                // Check if we've been stationary long enough
-                if (currentTime - parkStartTime > parkStationaryTime) {
-                    parkModeActive = true;
-                    #if DEBUG_ENABLED
-                    Serial.printf("🅿️ Park mode activated (stationary for %dms)\n", parkStationaryTime);
-                    #endif
-                    showParkEffect();
-                }
-            }
-        }
-    } else {
-        // Motion detected - deactivate park mode
-        if (parkModeActive) {
-            parkModeActive = false;
-            parkStartTime = 0;
-            #if DEBUG_ENABLED
-            Serial.println("🅿️ Park mode deactivated (motion detected)");
-            #endif
-        } else if (parkStartTime > 0) {
-            // Reset timer if we were counting down but motion detected
-            parkStartTime = 0;
-            #if DEBUG_ENABLED
-            Serial.println("🅿️ Park timer reset (motion detected)");
-            #endif
-        }
-    }
-}
-
-void processImpactDetection(MotionData& data) {
-    unsigned long currentTime = millis();
-    
-    // Calculate total acceleration magnitude
-    float accelMagnitude = sqrt(data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ);
-    
-    // Convert to G-force (assuming 9.8 m/s² = 1G)
-    float gForce = accelMagnitude / 9.8;
-    
-    // Detect impact (sudden high acceleration)
-    if (gForce > impactThreshold && currentTime - lastImpactTime > 1000) {
-        lastImpactTime = currentTime;
-        Serial.printf("💥 Impact detected! G-force: %.1f\n", gForce);
-        showImpactEffect();
-    }
-}
-
-void processDirectionDetection(MotionData& data) {
-    if (!directionBasedLighting || !motionEnabled) return;
-    
-    unsigned long currentTime = millis();
-    float rawForwardAccel = calibration.valid ? getCalibratedForwardAccel(data) : data.accelX;
-    
-    // Apply low-pass filter to reduce noise
-    filteredForwardAccel = FILTER_ALPHA * filteredForwardAccel + (1.0 - FILTER_ALPHA) * rawForwardAccel;
-    float forwardAccel = filteredForwardAccel;
-    
-    // Debug output only when direction changes or every 5 seconds
-    #if DEBUG_ENABLED
-    static unsigned long lastDebugTime = 0;
-    static bool lastDirectionState = isMovingForward;
-    if (currentTime - lastDebugTime > 5000 || lastDirectionState != isMovingForward) {
-        Serial.printf("🔄 Direction Debug - Raw: %.3fG, Filtered: %.3fG, Threshold: ±%.3fG, Current: %s\n", 
-                     rawForwardAccel, filteredForwardAccel, forwardAccelThreshold, isMovingForward ? "Forward" : "Backward");
-        lastDebugTime = currentTime;
-        lastDirectionState = isMovingForward;
-    }
-    #endif
-    
-    // Determine desired direction based on filtered forward acceleration
-    // Use hysteresis to prevent rapid switching (different thresholds for forward vs backward)
-    // Positive = forward, negative = backward
-    float forwardThreshold = forwardAccelThreshold;
-    float backwardThreshold = -forwardAccelThreshold;
-    
-    // Add hysteresis: once moving in a direction, require more force to change
-    if (isMovingForward) {
-        backwardThreshold = -forwardAccelThreshold * 0.7;  // Easier to detect backward when currently forward
-    } else {
-        forwardThreshold = forwardAccelThreshold * 0.7;  // Easier to detect forward when currently backward
-    }
-    
-    bool desiredForward = forwardAccel > forwardThreshold;
-    bool desiredBackward = forwardAccel < backwardThreshold;
-    
-    // If we're in a fade transition, continue it (don't check for new changes)
-    if (directionChangePending) {
-        unsigned long fadeElapsed = currentTime - directionFadeStartTime;
-        
-        if (fadeElapsed < DIRECTION_FADE_DURATION) {
-            // Still fading - update progress
-            directionFadeProgress = (float)fadeElapsed / DIRECTION_FADE_DURATION;
-            if (directionFadeProgress > 1.0) directionFadeProgress = 1.0;
-            
-            // Debug fade progress every 100ms
-            #if DEBUG_ENABLED
-            static unsigned long lastFadeDebug = 0;
-            if (currentTime - lastFadeDebug > 100) {
-                Serial.printf("🔄 Fade progress: %.1f%% (%d/%dms)\n", 
-                             directionFadeProgress * 100.0, fadeElapsed, DIRECTION_FADE_DURATION);
-                lastFadeDebug = currentTime;
-            }
-            #endif
-            // Continue to updateEffects() to render the fade
-        } else {
-            // Fade duration reached - set to 100% and keep fading for one more frame
-            if (directionFadeProgress < 1.0) {
-                directionFadeProgress = 1.0;
-                #if DEBUG_ENABLED
-                Serial.printf("🔄 Fade reached 100%% - rendering final blend frame\n");
-                #endif
-                // Continue to updateEffects() to render the 100% blend
-            } else {
-                // Fade complete (100% rendered for at least one frame) - now apply direction change
-                isMovingForward = !isMovingForward;
-                directionChangePending = false;
-                directionFadeProgress = 0.0;
-                directionChangeDetectedTime = 0;
-                #if DEBUG_ENABLED
-                Serial.printf("🔄 Direction switched: %s (fade complete after %dms)\n", 
-                             isMovingForward ? "Forward" : "Backward", fadeElapsed);
-                #endif
+            if (pulseElapsed < 50 && currentTime - lastBrakingPulse >= BRAKING_PULSE_DURATION) {
+                brakingPulseCount++;
+                lastBrakingPulse = currentTime;
             }
-        }
-        // During fade, don't process new direction changes
-        return;
-    }
-    
-    // Check if direction change is needed
-    bool needsChange = false;
-    if (isMovingForward && desiredBackward) {
-        needsChange = true;
-    } else if (!isMovingForward && desiredForward) {
-        needsChange = true;
-    }
-    
-    if (needsChange) {
-        if (directionChangeDetectedTime == 0) {
-            // Start tracking sustained direction change
-            directionChangeDetectedTime = currentTime;
-            #if DEBUG_ENABLED
-            Serial.printf("🔄 Direction change detected! Desired: %s, Current: %s, Accel: %.3fG\n", 
-                         desiredForward ? "Forward" : "Backward", isMovingForward ? "Forward" : "Backward", forwardAccel);
-            #endif
         } else {
-            unsigned long elapsed = currentTime - directionChangeDetectedTime;
-            if (elapsed >= DIRECTION_SUSTAIN_TIME) {
-                // Direction has been sustained long enough - start fade transition
-                // Only start if not already fading
-                if (!directionChangePending) {
-                    directionChangePending = true;
-                    directionFadeStartTime = currentTime;
-                    directionFadeProgress = 0.0;
-                    #if DEBUG_ENABLED
-                    Serial.printf("🔄 Direction change confirmed (sustained for %dms) - starting fade to %s\n", 
-                                 DIRECTION_SUSTAIN_TIME, desiredForward ? "Forward" : "Backward");
-                    #endif
-                }
-            }
-        }
-    } else {
-        // Direction matches current state - reset detection timer
-        if (directionChangeDetectedTime > 0) {
-            unsigned long elapsed = currentTime - directionChangeDetectedTime;
-            #if DEBUG_ENABLED
-            Serial.printf("🔄 Direction change cancelled after %dms - direction reverted (accel: %.3fG)\n", 
-                         elapsed, forwardAccel);
-            #endif
-            directionChangeDetectedTime = 0;
+            // Pulse phase complete - stay solid red
+            FastLED.setBrightness(rs.brakingBrightness);
+            fill_solid(targetLights, targetCount, CRGB::Red);
         }
     }
 }
 
+// Blinker overlay: flashes the turn-side half of each strip over the base effect
 void showBlinkerEffect(int direction) {
     static bool blinkState = false;
     static unsigned long lastBlinkTime = 0;
     
+    Layer& headlightBlinker = headlightLayers.layers[LAYER_BLINKER];
+    Layer& taillightBlinker = taillightLayers.layers[LAYER_BLINKER];
+    
+    if (!motionState.blinkerActive || motionState.parkModeActive) {
+        blinkState = false;
+        layerFadeTo(headlightBlinker, 0, BLINKER_FADE_RATE);
+        layerFadeTo(taillightBlinker, 0, BLINKER_FADE_RATE);
+        return;
+    }
+    
     if (millis() - lastBlinkTime > 500) { // 500ms blink interval
         blinkState = !blinkState;
         lastBlinkTime = millis();
     }
     
-    if (!blinkState) return;
-    
     // Calculate which half of each strip to blink
-    uint8_t headlightHalf = headlightLedCount / 2;
-    uint8_t taillightHalf = taillightLedCount / 2;
+    uint16_t headlightHalf = headlightLedCount / 2;
+    uint16_t taillightHalf = taillightLedCount / 2;
     
     // Blink the appropriate half based on direction
     if (direction > 0) { // Right turn
         // Blink right half of headlight, left half of taillight
-        for (uint8_t i = headlightHalf; i < headlightLedCount; i++) {
-            headlight[i] = CRGB::Yellow;
-        }
-        for (uint8_t i = 0; i < taillightHalf; i++) {
-            taillight[i] = CRGB::Yellow;
-        }
+        layerSetRange(headlightBlinker, headlightHalf, headlightLedCount);
+        layerSetRange(taillightBlinker, 0, taillightHalf);
     } else { // Left turn
         // Blink left half of headlight, right half of taillight
-        for (uint8_t i = 0; i < headlightHalf; i++) {
-            headlight[i] = CRGB::Yellow;
-        }
-        for (uint8_t i = taillightHalf; i < taillightLedCount; i++) {
-            taillight[i] = CRGB::Yellow;
-        }
+        layerSetRange(headlightBlinker, 0, headlightHalf);
+        layerSetRange(taillightBlinker, taillightHalf, taillightLedCount);
     }
+    
+    uint8_t opacity = blinkState ? 255 : 0;
+    layerFadeTo(headlightBlinker, opacity, BLINKER_FADE_RATE);
+    layerFadeTo(taillightBlinker, opacity, BLINKER_FADE_RATE);
 }
 
 void showParkEffect() {
+    const RenderSettings& rs = renderSettings;
     // Apply park mode brightness
-    FastLED.setBrightness(parkBrightness);
-    
-    // Temporarily store original effect speed and set park speed
-    uint8_t originalSpeed = effectSpeed;
-    effectSpeed = parkEffectSpeed;
-    
-    // Show configurable park effect
-    switch (parkEffect) {
-        case FX_SOLID:
-            fillSolidWithColorOrder(headlight, headlightLedCount, parkHeadlightColor, headlightLedType, headlightColorOrder);
-            fillSolidWithColorOrder(taillight, taillightLedCount, parkTaillightColor, taillightLedType, taillightColorOrder);
-            break;
-        case FX_BREATH:
-            effectBreathImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectBreathImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_RAINBOW:
-            effectRainbowImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectRainbowImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_PULSE:
-            effectPulseImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectPulseImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_BLINK_RAINBOW:
-            effectBlinkRainbowImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectBlinkRainbowImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_GRADIENT_SHIFT:
-            effectGradientShiftImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectGradientShiftImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_FIRE:
-            effectFireImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectFireImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_METEOR:
-            effectMeteorImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectMeteorImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_WAVE:
-            effectWaveImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectWaveImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_CENTER_BURST:
-            effectCenterBurstImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectCenterBurstImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_CANDLE:
-            effectCandleImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectCandleImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_STATIC_RAINBOW:
-            effectStaticRainbow(headlight, headlightLedCount);
-            effectStaticRainbow(taillight, taillightLedCount);
-            break;
-        case FX_KNIGHT_RIDER:
-            effectKnightRiderImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectKnightRiderImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_POLICE:
-            effectPoliceImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectPoliceImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_STROBE:
-            effectStrobeImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectStrobeImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_LARSON_SCANNER:
-            effectLarsonScannerImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectLarsonScannerImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_COLOR_WIPE:
-            effectColorWipeImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectColorWipeImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_HAZARD:
-            effectHazardImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectHazardImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_RUNNING_LIGHTS:
-            effectRunningLightsImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectRunningLightsImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_COLOR_SWEEP:
-            effectColorSweepImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectColorSweepImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_RAINBOW_KNIGHT_RIDER:
-            effectRainbowKnightRiderImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectRainbowKnightRiderImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-        case FX_DUAL_KNIGHT_RIDER:
-            effectDualKnightRiderImproved(headlight, headlightLedCount, parkHeadlightColor, headlightTiming.step);
-            effectDualKnightRiderImproved(taillight, taillightLedCount, parkTaillightColor, taillightTiming.step);
-            break;
-        case FX_DUAL_RAINBOW_KNIGHT_RIDER:
-            effectDualRainbowKnightRiderImproved(headlight, headlightLedCount, headlightTiming.step);
-            effectDualRainbowKnightRiderImproved(taillight, taillightLedCount, taillightTiming.step);
-            break;
-    }
-    
-    // Apply color order conversion for RGBW LEDs in park mode (FX_SOLID already handles this)
-    if (parkEffect != FX_SOLID) {
-        applyColorOrderToArray(headlight, headlightLedCount, headlightLedType, headlightColorOrder);
-        applyColorOrderToArray(taillight, taillightLedCount, taillightLedType, taillightColorOrder);
-    }
+    FastLED.setBrightness(rs.parkBrightness);
     
-    // Restore original effect speed
-    effectSpeed = originalSpeed;
+    // Show configurable park effect on the base layer (dispatched through the effect table).
+    // The effect clocks already run at parkEffectSpeed while parked (see updateEffects).
+    applyEffectToArray(headlightBase, headlightLedCount, rs.parkEffect, rs.parkHeadlightColor, headlightTiming, CRGB::Black, false);
+    applyEffectToArray(taillightBase, taillightLedCount, rs.parkEffect, rs.parkTaillightColor, taillightTiming, CRGB::Black, false);
 }
 
-void showImpactEffect() {
-    // Flash all lights white briefly
-    fill_solid(headlight, headlightLedCount, CRGB::White);
-    fill_solid(taillight, taillightLedCount, CRGB::White);
-    FastLED.show();
-    delay(200);
+// Impact overlay (render task): full white on a new impact, then fade back
+// out to the running effects (no blocking delay)
+void updateImpactLayer() {
+    static uint32_t shownImpactCount = 0;
+    if (motionState.impactCount != shownImpactCount) {
+        shownImpactCount = motionState.impactCount;
+        impactFlashActive = true;
+        impactFlashStart = millis();
+        layerFadeTo(headlightLayers.layers[LAYER_IMPACT], 255, LAYER_FADE_INSTANT);
+        layerFadeTo(taillightLayers.layers[LAYER_IMPACT], 255, LAYER_FADE_INSTANT);
+    }
     
-    // Restore normal colors
-    fill_solid(headlight, headlightLedCount, headlightColor);
-    fill_solid(taillight, taillightLedCount, taillightColor);
+    if (impactFlashActive && millis() - impactFlashStart >= IMPACT_FLASH_DURATION) {
+        impactFlashActive = false;
+        layerFadeTo(headlightLayers.layers[LAYER_IMPACT], 0, IMPACT_FADE_RATE);
+        layerFadeTo(taillightLayers.layers[LAYER_IMPACT], 0, IMPACT_FADE_RATE);
+    }
 }
 
 void resetToNormalEffects() {
     // Reset brightness to normal level
     FastLED.setBrightness(globalBrightness);
     
-    // Reset effect speed to normal
-    effectSpeed = effectSpeed; // Keep current effect speed
-    
-    // Apply normal headlight and taillight effects immediately
-    updateEffects();
-    FastLED.show();
+    // Apply normal headlight and taillight effects on the next render frame
+    publishRenderSettings();
     
     Serial.println("🔄 Reset to normal effects");
 }
@@ -3719,28 +3336,6 @@ void resetCalibration() {
     Serial.println("Motion calibration reset and saved to filesystem.");
 }
 
-float getCalibratedForwardAccel(MotionData& data) {
-    if (!calibration.valid) return data.accelX;
-    
-    switch(calibration.forwardAxis) {
-        case 'X': return data.accelX * calibration.forwardSign;
-        case 'Y': return data.accelY * calibration.forwardSign;
-        case 'Z': return data.accelZ * calibration.forwardSign;
-        default: return data.accelX;
-    }
-}
-
-float getCalibratedLeftRightAccel(MotionData& data) {
-    if (!calibration.valid) return data.accelY;
-    
-    switch(calibration.leftRightAxis) {
-        case 'X': return data.accelX * calibration.leftRightSign;
-        case 'Y': return data.accelY * calibration.leftRightSign;
-        case 'Z': return data.accelZ * calibration.leftRightSign;
-        default: return data.accelY;
-    }
-}
-
 // OTA Update Implementation
 void startOTAUpdate(String url) {
     if (url.isEmpty()) {
@@ -3751,6 +3346,7 @@ void startOTAUpdate(String url) {
     }
     
     Serial.printf("🔄 Starting OTA update from: %s\n", url.c_str());
+    flushSettings();
     
     otaInProgress = true;
     otaProgress = 0;
@@ -3759,9 +3355,13 @@ void startOTAUpdate(String url) {
     otaStartTime = millis();
     
     // Show downloading effect on LEDs
-    fill_solid(headlight, headlightLedCount, CRGB::Blue);
-    fill_solid(taillight, taillightLedCount, CRGB::Blue);
-    FastLED.show();
+    {
+        LEDLock lock;
+        publishRenderSettings();  // Hold the render task off the LEDs
+        fill_solid(headlight, headlightLedCount, CRGB::Blue);
+        fill_solid(taillight, taillightLedCount, CRGB::Blue);
+        showLEDs();
+    }
     
     // Start the update process
     httpUpdate.setLedPin(-1); // Disable built-in LED
@@ -3799,14 +3399,15 @@ void updateOTAProgress(unsigned int progress, unsigned int total) {
     Serial.printf("📥 OTA Progress: %d%% (%d/%d bytes)\n", otaProgress, progress, total);
     
     // Update LED progress indicator
-    uint8_t ledProgress = (progress * headlightLedCount) / total;
-    for (uint8_t i = 0; i < headlightLedCount; i++) {
+    LEDLock lock;
+    uint16_t ledProgress = (progress * headlightLedCount) / total;
+    for (uint16_t i = 0; i < headlightLedCount; i++) {
         headlight[i] = (i < ledProgress) ? CRGB::Green : CRGB::Blue;
     }
-    for (uint8_t i = 0; i < taillightLedCount; i++) {
+    for (uint16_t i = 0; i < taillightLedCount; i++) {
         taillight[i] = (i < ledProgress) ? CRGB::Green : CRGB::Blue;
     }
-    FastLED.show();
+    showLEDs();
 }
 
 void handleOTAError(int error) {
@@ -3847,9 +3448,12 @@ void handleOTAError(int error) {
     otaInProgress = false;
     
     // Show error on LEDs
-    fill_solid(headlight, headlightLedCount, CRGB::Red);
-    fill_solid(taillight, taillightLedCount, CRGB::Red);
-    FastLED.show();
+    {
+        LEDLock lock;
+        fill_solid(headlight, headlightLedCount, CRGB::Red);
+        fill_solid(taillight, taillightLedCount, CRGB::Red);
+        showLEDs();
+    }
 }
 
 // File Upload Handler for OTA
@@ -3877,6 +3481,7 @@ void handleOTAUpload() {
         
         // Start OTA update
         Serial.println("🔄 Starting OTA update");
+        flushSettings();
         size_t freeSpace = ESP.getFreeSketchSpace();
         Serial.printf("💾 Free sketch space: %d bytes\n", freeSpace);
         
@@ -3892,9 +3497,13 @@ void handleOTAUpload() {
         Serial.println("✅ OTA update started successfully");
         
         // Show uploading effect on LEDs
-        fill_solid(headlight, headlightLedCount, CRGB::Blue);
-        fill_solid(taillight, taillightLedCount, CRGB::Blue);
-        FastLED.show();
+        {
+            LEDLock lock;
+            publishRenderSettings();  // Hold the render task off the LEDs
+            fill_solid(headlight, headlightLedCount, CRGB::Blue);
+            fill_solid(taillight, taillightLedCount, CRGB::Blue);
+            showLEDs();
+        }
         
     } else if (upload.status == UPLOAD_FILE_WRITE) {
         // Write data (no return value check)
@@ -3909,14 +3518,15 @@ void handleOTAUpload() {
                 lastProgressUpdate = upload.currentSize;
                 
                 // Update LED progress indicator
-                uint8_t ledProgress = (upload.currentSize * headlightLedCount) / upload.totalSize;
-                for (uint8_t i = 0; i < headlightLedCount; i++) {
+                LEDLock lock;
+                uint16_t ledProgress = (upload.currentSize * headlightLedCount) / upload.totalSize;
+                for (uint16_t i = 0; i < headlightLedCount; i++) {
                     headlight[i] = (i < ledProgress) ? CRGB::Green : CRGB::Blue;
                 }
-                for (uint8_t i = 0; i < taillightLedCount; i++) {
+                for (uint16_t i = 0; i < taillightLedCount; i++) {
                     taillight[i] = (i < ledProgress) ? CRGB::Green : CRGB::Blue;
                 }
-                FastLED.show();
+                showLEDs();
             }
         }
         
@@ -3929,9 +3539,12 @@ void handleOTAUpload() {
             otaProgress = 100;
             
             // Show success on LEDs
-            fill_solid(headlight, headlightLedCount, CRGB::Green);
-            fill_solid(taillight, taillightLedCount, CRGB::Green);
-            FastLED.show();
+            {
+                LEDLock lock;
+                fill_solid(headlight, headlightLedCount, CRGB::Green);
+                fill_solid(taillight, taillightLedCount, CRGB::Green);
+                showLEDs();
+            }
             
             // Send success response to client before restart
             server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -3939,6 +3552,7 @@ void handleOTAUpload() {
             
             // Give the client time to receive the response
             delay(1500);
+            flushSettings();
             ESP.restart();
         } else {
             String errorMsg = Update.errorString();
@@ -3948,9 +3562,12 @@ void handleOTAUpload() {
             otaInProgress = false;
             
             // Show error on LEDs
-            fill_solid(headlight, headlightLedCount, CRGB::Red);
-            fill_solid(taillight, taillightLedCount, CRGB::Red);
-            FastLED.show();
+            {
+                LEDLock lock;
+                fill_solid(headlight, headlightLedCount, CRGB::Red);
+                fill_solid(taillight, taillightLedCount, CRGB::Red);
+                showLEDs();
+            }
         }
     }
 }
@@ -3958,15 +3575,21 @@ void handleOTAUpload() {
 // Start OTA update from uploaded file
 void startOTAUpdateFromFile(String filename) {
     Serial.printf("🔄 Starting OTA update from file: %s\n", filename.c_str());
+    flushSettings();
     
+    otaInProgress = true;
     otaStatus = "Installing";
     otaProgress = 0;
     otaError = "";
     
     // Show installing effect on LEDs
-    fill_solid(headlight, headlightLedCount, CRGB::Yellow);
-    fill_solid(taillight, taillightLedCount, CRGB::Yellow);
-    FastLED.show();
+    {
+        LEDLock lock;
+        publishRenderSettings();  // Hold the render task off the LEDs
+        fill_solid(headlight, headlightLedCount, CRGB::Yellow);
+        fill_solid(taillight, taillightLedCount, CRGB::Yellow);
+        showLEDs();
+    }
     
     // Start the update process from file
     Update.onProgress(updateOTAProgress);
@@ -4039,11 +3662,15 @@ void startOTAUpdateFromFile(String filename) {
     otaProgress = 100;
     
     // Show success on LEDs
-    fill_solid(headlight, headlightLedCount, CRGB::Green);
-    fill_solid(taillight, taillightLedCount, CRGB::Green);
-    FastLED.show();
+    {
+        LEDLock lock;
+        fill_solid(headlight, headlightLedCount, CRGB::Green);
+        fill_solid(taillight, taillightLedCount, CRGB::Green);
+        showLEDs();
+    }
     
     delay(2000);
+    flushSettings();
     ESP.restart();
 }
 
@@ -4109,6 +3736,18 @@ void handleSerialCommands() {
             resetCalibration();
             Serial.println("Motion calibration reset");
         }
+        else if (command == "output_async") {
+            asyncLedOutput = true;
+            Serial.println("LED output: async (render overlaps transmission)");
+        }
+        else if (command == "output_sync") {
+            asyncLedOutput = false;
+            Serial.println("LED output: sync (render waits for FastLED.show())");
+        }
+        else if (command == "power_save") {
+            powerSaveEnabled = !powerSaveEnabled;
+            Serial.printf("Idle power mode %s\n", powerSaveEnabled ? "on" : "off");
+        }
         else if (command == "motion_on") {
             motionEnabled = true;
             Serial.println("Motion control enabled");
@@ -4286,6 +3925,44 @@ void handleSerialCommands() {
         else if (command == "status") {
             printStatus();
         }
+        else if (command == "frames") {
+            printFrameStats();
+        }
+        else if (command == "save") {
+            flushSettings();
+            Serial.println("Settings written to flash");
+        }
+        else if (command == "perf") {
+            printPerfStats();
+        }
+        else if (command == "perf_reset") {
+            resetPerfStats();
+            Serial.println("Stage profiler reset");
+        }
+        else if (command == "latency") {
+            commandLatencyReport = !commandLatencyReport;
+            Serial.printf("Command-to-light latency logging %s\n", commandLatencyReport ? "on" : "off");
+        }
+        else if (command == "record") {
+            if (recording) {
+                stopRecording();
+            } else {
+                startRecording();
+            }
+        }
+        else if (command == "frames_reset") {
+            frameStatsResetPending = true;
+            Serial.println("Frame statistics reset");
+        }
+        else if (command.startsWith("fps ")) {
+            int fps = command.substring(4).toInt();
+            if (fps >= FRAME_CLOCK_MIN_FPS && fps <= FRAME_CLOCK_MAX_FPS) {
+                targetFps = fps;
+                Serial.printf("Target frame rate set to %d fps\n", fps);
+            } else {
+                Serial.printf("Invalid frame rate (%d-%d)\n", FRAME_CLOCK_MIN_FPS, FRAME_CLOCK_MAX_FPS);
+            }
+        }
         else if (command == "list_files" || command == "ls") {
             Serial.println("📁 SPIFFS File Listing:");
             listSPIFFSFiles();
@@ -4313,6 +3990,86 @@ void printStatus() {
     Serial.printf("Headlight: Effect %d, Color 0x%06X\n", headlightEffect, headlightColor);
     Serial.printf("Taillight: Effect %d, Color 0x%06X\n", taillightEffect, taillightColor);
     Serial.printf("Startup: %s (%d), Duration: %dms\n", getStartupSequenceName(startupSequence).c_str(), startupSequence, startupDuration);
+    Serial.printf("Frames: %lu sent, %lu skipped (unchanged)\n", (unsigned long)framesSent, (unsigned long)framesSkipped);
+    Serial.printf("Frame Arena: %d LEDs/slot, %d bytes, %lu allocations since boot\n", frameArena.slotLeds, frameArena.bytes, (unsigned long)frameArena.allocations);
+    Serial.printf("Render task: %s (core %d), %lu frames, %lu snapshot retries\n",
+                  renderTaskHandle != nullptr ? "running" : "not running - loop() fallback",
+                  RENDER_TASK_CORE, (unsigned long)renderFrames, (unsigned long)renderSnapshotRetries);
+    Serial.printf("Boot: first frame %lums, setup done %lums, first API response %lums\n",
+                  (unsigned long)bootFirstFrameMs, (unsigned long)bootSetupMs, (unsigned long)bootFirstApiMs);
+    Serial.printf("LED output: %s, last show %luus, %lu fence waits\n",
+                  (asyncLedOutput && ledOutputTaskHandle != nullptr) ? "async" : "sync",
+                  (unsigned long)ledOutputShowUs, (unsigned long)ledOutputFenceWaits);
+    Serial.printf("Power: idle mode %s (%s), %lums parked over %lu idle periods, light sleep %s\n",
+                  powerSaveEnabled ? "on" : "off", renderIdle ? "idle" : "rendering",
+                  (unsigned long)renderParkedMs, (unsigned long)powerIdleEntries, powerLightSleep ? "on" : "off");
+    Serial.printf("Settings: %s, %lu flash commits (%lu failed), %lu writes avoided\n", settingsDirty ? "pending" : "saved",
+                  (unsigned long)settingsCommits, (unsigned long)settingsCommitFailures, (unsigned long)settingsWritesAvoided);
+    Serial.printf("Motion sampling: %dHz measured (%dHz configured), %lu samples, %lu dropped, %lu FIFO overflows, %lu interrupts\n",
+                  motionSampleRateHz, MOTION_SAMPLE_RATE_HZ, (unsigned long)motionSamplesProcessed,
+                  (unsigned long)motionSamplesDropped, (unsigned long)motionFifoOverflows, (unsigned long)motionInterrupts);
+    Serial.printf("Wake on motion: %s, %lu standby periods, %lu wakes\n", motionStandby ? "parked" : "sampling",
+                  (unsigned long)motionStandbyEntries, (unsigned long)motionWakes);
+    Serial.printf("Recorder: %s, %lu samples, %lu bytes written, %lu dropped, %lu write errors\n",
+                  recording ? "recording" : (recorderFileOpen ? "writing" : "idle"), (unsigned long)recordingSamples,
+                  (unsigned long)recordingBytesWritten, (unsigned long)recordingDropped,
+                  (unsigned long)recordingWriteErrors);
+    Serial.printf("Impacts: %lu detected, last peak %.1fG, %lu captured to %s\n", (unsigned long)motion.impactCount,
+                  motion.lastImpactG, (unsigned long)impactCaptures, IMPACT_CAPTURE_PATH);
+}
+
+void printFrameHistogram(const char* name, const FrameHistogram& histogram) {
+    Serial.printf("%-9s n=%lu min=%luus avg=%luus p50=%luus p90=%luus p99=%luus max=%luus\n", name,
+                  (unsigned long)histogram.samples,
+                  (unsigned long)(histogram.samples > 0 ? histogram.minUs : 0),
+                  (unsigned long)frameHistogramMeanUs(histogram),
+                  (unsigned long)frameHistogramPercentile(histogram, 50),
+                  (unsigned long)frameHistogramPercentile(histogram, 90),
+                  (unsigned long)frameHistogramPercentile(histogram, 99),
+                  (unsigned long)histogram.maxUs);
+    Serial.print("          ");
+    for (uint8_t b = 0; b < FRAME_HISTOGRAM_BUCKETS; b++) {
+        if (histogram.counts[b] == 0) continue;
+        if (b == FRAME_HISTOGRAM_BUCKETS - 1) {
+            Serial.printf(" >%lu:%lu", (unsigned long)frameHistogramBoundsUs[b - 1], (unsigned long)histogram.counts[b]);
+        } else {
+            Serial.printf(" <=%lu:%lu", (unsigned long)frameHistogramBoundsUs[b], (unsigned long)histogram.counts[b]);
+        }
+    }
+    Serial.println();
+}
+
+void printFrameStats() {
+    Serial.println("=== Frame Statistics ===");
+    Serial.printf("Target: %d fps (%luus period), %lu frames, %lu deadlines dropped\n",
+                  frameClockFps(frameClock), (unsigned long)frameClock.periodUs,
+                  (unsigned long)frameClock.frames, (unsigned long)frameClock.dropped);
+    printFrameHistogram("Interval", frameIntervalHistogram);
+    printFrameHistogram("Render", renderTimeHistogram);
+    printFrameHistogram("Show", showTimeHistogram);
+    printFrameHistogram("Command", commandLatencyHistogram);
+    Serial.printf("Loop: %lu wakeups\n", (unsigned long)loopWakeups);
+}
+
+void printPerfStats() {
+    uint32_t mhz = getCpuFrequencyMhz();
+    Serial.printf("=== Stage Profile (cycles, us at %luMHz) ===\n", (unsigned long)mhz);
+    for (uint8_t i = 0; i < PERF_STAGE_COUNT; i++) {
+        const PerfStats& stats = perfStats[i];
+        uint32_t minCycles = stats.samples > 0 ? stats.minCycles : 0;
+        uint32_t avg = perfMeanCycles(stats);
+        uint32_t p99 = perfPercentile(stats, 99);
+        Serial.printf("%-15s n=%-8lu min=%lu avg=%lu p99=%lu max=%lu cycles (avg %luus, p99 %luus, max %luus)\n",
+                      perfStageNames[i], (unsigned long)stats.samples, (unsigned long)minCycles,
+                      (unsigned long)avg, (unsigned long)p99, (unsigned long)stats.maxCycles,
+                      (unsigned long)(avg / mhz), (unsigned long)(p99 / mhz), (unsigned long)(stats.maxCycles / mhz));
+    }
+}
+
+void resetPerfStats() {
+    for (uint8_t i = 0; i < PERF_STAGE_COUNT; i++) {
+        perfRequestReset(perfStats[i]);
+    }
 }
 
 void printHelp() {
@@ -4352,6 +4109,14 @@ void printHelp() {
     Serial.println("");
     Serial.println("System:");
     Serial.println("  status: Show current status");
+    Serial.println("  frames/frames_reset: Show/reset frame interval, render, show and command latency histograms");
+    Serial.println("  latency: Toggle logging of each command-to-light latency");
+    Serial.printf("  record: Start/stop recording raw IMU samples to %s (GET /api/recording)\n", RECORDER_PATH);
+    Serial.println("  save: Write pending settings to flash now");
+    Serial.println("  perf/perf_reset: Show/reset per-stage cycle counts (min/avg/p99/max)");
+    Serial.printf("  fps <%d-%d>: Set target frame rate (not saved)\n", FRAME_CLOCK_MIN_FPS, FRAME_CLOCK_MAX_FPS);
+    Serial.println("  output_async/output_sync: Overlap LED transmission with rendering, or not");
+    Serial.println("  power_save: Toggle idle power mode (render task sleeps while the frame is static)");
     Serial.println("  list_files/ls: List SPIFFS files");
     Serial.println("  show_settings/cat_settings: Display settings.json contents");
     Serial.println("  clean_duplicates: Remove duplicate UI files");
@@ -4638,6 +4403,7 @@ void processBLEHTTPRequest(String request) {
             portENTER_CRITICAL(&blePendingMutex);
             blePendingJson = jsonBody;
             blePendingApply = true;
+            bleCommandArrivalUs = micros();
             portEXIT_CRITICAL(&blePendingMutex);
             String body = "{\"queued\":true}";
             String response = "HTTP/1.1 202 Accepted\r\nContent-Type: application/json\r\nContent-Length: ";
@@ -4704,6 +4470,9 @@ void setupWebServer() {
     // API endpoints
     server.on("/api", HTTP_POST, handleAPI);
     server.on("/api/status", HTTP_GET, handleStatus);
+    server.on("/api/frames", HTTP_GET, handleFrameStats);
+    server.on("/api/perf", HTTP_GET, handlePerf);
+    server.on("/api/recording", HTTP_GET, handleRecordingDownload);
     server.on("/api/led-config", HTTP_POST, handleLEDConfig);
     server.on("/api/led-test", HTTP_POST, handleLEDTest);
     server.on("/api/settings", HTTP_GET, handleGetSettings);
@@ -5545,44 +5314,57 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
         effectSpeed = doc["effectSpeed"];
         saveSettings(); // Auto-save
     }
+    if (doc.containsKey("async_output")) {
+        asyncLedOutput = doc["async_output"];  // Runtime only; takes effect on the next frame
+    }
+    if (doc.containsKey("power_save")) {
+        powerSaveEnabled = doc["power_save"];  // Runtime only
+    }
+    if (doc.containsKey("target_fps")) {
+        targetFps = constrain((int)doc["target_fps"], FRAME_CLOCK_MIN_FPS, FRAME_CLOCK_MAX_FPS);  // Runtime only
+    }
 
-    bool configChanged = false;
-    if (doc.containsKey("headlightLedCount")) {
-        uint8_t newHeadlightCount = doc["headlightLedCount"];
-        if (newHeadlightCount != headlightLedCount) {
-            Serial.printf("LED Config: Headlight count changed from %d to %d\n", headlightLedCount, newHeadlightCount);
-            headlightLedCount = newHeadlightCount;
+    {
+        // Counts change before the buffers are reallocated: keep the render task out until both are done
+        LEDLock lock;
+        bool configChanged = false;
+        if (doc.containsKey("headlightLedCount")) {
+            uint16_t newHeadlightCount = clampLedCount(doc["headlightLedCount"]);
+            if (newHeadlightCount != headlightLedCount) {
+                Serial.printf("LED Config: Headlight count changed from %d to %d\n", headlightLedCount, newHeadlightCount);
+                headlightLedCount = newHeadlightCount;
+                configChanged = true;
+            }
+        }
+        if (doc.containsKey("taillightLedCount")) {
+            uint16_t newTaillightCount = clampLedCount(doc["taillightLedCount"]);
+            if (newTaillightCount != taillightLedCount) {
+                Serial.printf("LED Config: Taillight count changed from %d to %d\n", taillightLedCount, newTaillightCount);
+                taillightLedCount = newTaillightCount;
+                configChanged = true;
+            }
+        }
+        if (doc.containsKey("headlightLedType")) {
+            headlightLedType = doc["headlightLedType"];
             configChanged = true;
         }
-    }
-    if (doc.containsKey("taillightLedCount")) {
-        uint8_t newTaillightCount = doc["taillightLedCount"];
-        if (newTaillightCount != taillightLedCount) {
-            Serial.printf("LED Config: Taillight count changed from %d to %d\n", taillightLedCount, newTaillightCount);
-            taillightLedCount = newTaillightCount;
+        if (doc.containsKey("taillightLedType")) {
+            taillightLedType = doc["taillightLedType"];
             configChanged = true;
         }
-    }
-    if (doc.containsKey("headlightLedType")) {
-        headlightLedType = doc["headlightLedType"];
-        configChanged = true;
-    }
-    if (doc.containsKey("taillightLedType")) {
-        taillightLedType = doc["taillightLedType"];
-        configChanged = true;
-    }
-    if (doc.containsKey("headlightColorOrder")) {
-        headlightColorOrder = doc["headlightColorOrder"];
-        configChanged = true;
-    }
-    if (doc.containsKey("taillightColorOrder")) {
-        taillightColorOrder = doc["taillightColorOrder"];
-        configChanged = true;
-    }
-    if (configChanged) {
-        saveSettings();
-        initializeLEDs();
-        Serial.println("LED configuration updated and applied!");
+        if (doc.containsKey("headlightColorOrder")) {
+            headlightColorOrder = doc["headlightColorOrder"];
+            configChanged = true;
+        }
+        if (doc.containsKey("taillightColorOrder")) {
+            taillightColorOrder = doc["taillightColorOrder"];
+            configChanged = true;
+        }
+        if (configChanged) {
+            saveSettings();
+            initializeLEDs();
+            Serial.println("LED configuration updated and applied!");
+        }
     }
     if (doc.containsKey("startup_sequence")) {
         startupSequence = doc["startup_sequence"];
@@ -5598,8 +5380,8 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
     }
     if (doc.containsKey("testParkMode") && doc["testParkMode"]) {
         // Temporarily activate park mode for testing
-        parkModeActive = true;
-        parkStartTime = millis(); // Reset timer
+        motion.parkModeActive = true;
+        motion.parkStartTime = millis(); // Reset timer
         Serial.println("🅿️ Test park mode activated");
     }
     if (doc.containsKey("testLEDs") && doc["testLEDs"]) {
@@ -5612,16 +5394,16 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
         
         // If motion control is being disabled, deactivate all motion features
         if (motionEnabled && !newMotionEnabled) {
-            if (parkModeActive) {
-                parkModeActive = false;
-                parkStartTime = 0;
+            if (motion.parkModeActive) {
+                motion.parkModeActive = false;
+                motion.parkStartTime = 0;
                 resetToNormalEffects(); // Reset LEDs to normal state
                 Serial.println("🅿️ Motion control disabled - deactivating park mode");
             }
-            if (blinkerActive) {
-                blinkerActive = false;
-                blinkerStartTime = 0;
-                manualBlinkerActive = false;
+            if (motion.blinkerActive) {
+                motion.blinkerActive = false;
+                motion.blinkerStartTime = 0;
+                motion.manualBlinkerActive = false;
                 resetToNormalEffects(); // Reset LEDs to normal state
                 Serial.println("🚦 Motion control disabled - deactivating blinkers");
             }
@@ -5634,10 +5416,10 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
         bool newBlinkerEnabled = doc["blinker_enabled"];
         
         // If blinkers are being disabled and they're currently active, deactivate them
-        if (blinkerEnabled && !newBlinkerEnabled && blinkerActive) {
-            blinkerActive = false;
-            blinkerStartTime = 0;
-            manualBlinkerActive = false;
+        if (blinkerEnabled && !newBlinkerEnabled && motion.blinkerActive) {
+            motion.blinkerActive = false;
+            motion.blinkerStartTime = 0;
+            motion.manualBlinkerActive = false;
             resetToNormalEffects(); // Reset LEDs to normal state
             Serial.println("🚦 Blinkers disabled - deactivating current blinker");
         }
@@ -5649,9 +5431,9 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
         bool newParkModeEnabled = doc["park_mode_enabled"];
         
         // If park mode is being disabled and it's currently active, deactivate it
-        if (parkModeEnabled && !newParkModeEnabled && parkModeActive) {
-            parkModeActive = false;
-            parkStartTime = 0;
+        if (parkModeEnabled && !newParkModeEnabled && motion.parkModeActive) {
+            motion.parkModeActive = false;
+            motion.parkStartTime = 0;
             resetToNormalEffects(); // Reset LEDs to normal state
             Serial.println("🅿️ Park mode disabled - deactivating current park mode");
         }
@@ -5678,15 +5460,15 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
     if (doc.containsKey("manualBlinker")) {
         String manual = doc["manualBlinker"].as<String>();
         if (manual == "left" || manual == "right") {
-            manualBlinkerActive = true;
-            blinkerActive = true;
-            blinkerDirection = (manual == "right") ? 1 : -1;
-            blinkerStartTime = millis();
+            motion.manualBlinkerActive = true;
+            motion.blinkerActive = true;
+            motion.blinkerDirection = (manual == "right") ? 1 : -1;
+            motion.blinkerStartTime = millis();
         } else if (manual == "off") {
-            manualBlinkerActive = false;
-            blinkerActive = false;
-            blinkerDirection = 0;
-            blinkerStartTime = 0;
+            motion.manualBlinkerActive = false;
+            motion.blinkerActive = false;
+            motion.blinkerDirection = 0;
+            motion.blinkerStartTime = 0;
             resetToNormalEffects();
         }
     }
@@ -5748,19 +5530,28 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
     }
     if (doc.containsKey("manualBrake")) {
         bool manual = doc["manualBrake"];
-        manualBrakeActive = manual;
-        brakingActive = manual;
-        brakingStartTime = millis();
-        brakingFlashCount = 0;
-        brakingPulseCount = 0;
+        motion.manualBrakeActive = manual;
+        motion.brakingActive = manual;
+        motion.brakingStartTime = millis();
         if (!manual) {
             resetToNormalEffects();
         }
     }
+    if (doc.containsKey("imu_record")) {
+        if (doc["imu_record"]) {
+            startRecording();
+        } else {
+            stopRecording();
+        }
+    }
     if (doc.containsKey("braking_threshold")) {
         brakingThreshold = doc["braking_threshold"];
         saveSettings(); // Auto-save
     }
+    if (doc.containsKey("braking_latency")) {
+        brakingLatency = constrain((int)doc["braking_latency"], BRAKING_MIN_LATENCY_MS, BRAKING_MAX_LATENCY_MS);
+        saveSettings(); // Auto-save
+    }
     if (doc.containsKey("braking_effect")) {
         brakingEffect = doc["braking_effect"];
         saveSettings(); // Auto-save
@@ -5958,6 +5749,7 @@ bool applyApiJson(DynamicJsonDocument& doc, bool allowRestart, bool& shouldResta
     if (doc.containsKey("restoreDefaults") && doc["restoreDefaults"]) {
         restoreDefaultsToStock();
         delay(500);  // Allow response to be sent
+        flushSettings();
         ESP.restart();
         return true;
     }
@@ -6044,6 +5836,7 @@ void sendBleResponse(const String& response) {
         pCharacteristic->notify();
         delay(10);
     }
+    noteApiResponse("BLE");
 }
 
 uint16_t crc16Ccitt(const uint8_t* data, size_t length) {
@@ -6144,6 +5937,7 @@ void sendBleFrame(uint8_t type, uint8_t seq, uint8_t flags, const uint8_t* paylo
         pCharacteristic->notify();
         delay(10);
     }
+    noteApiResponse("BLE");
 }
 
 void sendBleAck(uint8_t seq) {
@@ -6176,6 +5970,7 @@ String getOtaStatusJSON() {
 // Old handleRoot function removed - now using external UI files
 void handleAPI() {
     if (server.hasArg("plain")) {
+        commandArrivalUs = micros();  // Request fully received; timed until its first frame is sent
         DynamicJsonDocument doc(2048);
         deserializeJson(doc, server.arg("plain"));
         
@@ -6212,6 +6007,15 @@ void handleAPI() {
             effectSpeed = doc["effectSpeed"];
             saveSettings(); // Auto-save
         }
+        if (doc.containsKey("async_output")) {
+            asyncLedOutput = doc["async_output"];  // Runtime only; takes effect on the next frame
+        }
+        if (doc.containsKey("power_save")) {
+            powerSaveEnabled = doc["power_save"];  // Runtime only
+        }
+        if (doc.containsKey("target_fps")) {
+            targetFps = constrain((int)doc["target_fps"], FRAME_CLOCK_MIN_FPS, FRAME_CLOCK_MAX_FPS);  // Runtime only
+        }
         if (doc.containsKey("startup_sequence")) {
             startupSequence = doc["startup_sequence"];
             startupEnabled = (startupSequence != STARTUP_NONE);
@@ -6226,8 +6030,8 @@ void handleAPI() {
         }
         if (doc.containsKey("testParkMode") && doc["testParkMode"]) {
             // Temporarily activate park mode for testing
-            parkModeActive = true;
-            parkStartTime = millis(); // Reset timer
+            motion.parkModeActive = true;
+            motion.parkStartTime = millis(); // Reset timer
             Serial.println("🅿️ Test park mode activated");
         }
         
@@ -6237,15 +6041,15 @@ void handleAPI() {
             
             // If motion control is being disabled, deactivate all motion features
             if (motionEnabled && !newMotionEnabled) {
-                if (parkModeActive) {
-                    parkModeActive = false;
-                    parkStartTime = 0;
+                if (motion.parkModeActive) {
+                    motion.parkModeActive = false;
+                    motion.parkStartTime = 0;
                     resetToNormalEffects(); // Reset LEDs to normal state
                     Serial.println("🅿️ Motion control disabled - deactivating park mode");
                 }
-                if (blinkerActive) {
-                    blinkerActive = false;
-                    blinkerStartTime = 0;
+                if (motion.blinkerActive) {
+                    motion.blinkerActive = false;
+                    motion.blinkerStartTime = 0;
                     resetToNormalEffects(); // Reset LEDs to normal state
                     Serial.println("🚦 Motion control disabled - deactivating blinkers");
                 }
@@ -6258,9 +6062,9 @@ void handleAPI() {
             bool newBlinkerEnabled = doc["blinker_enabled"];
             
             // If blinkers are being disabled and they're currently active, deactivate them
-            if (blinkerEnabled && !newBlinkerEnabled && blinkerActive) {
-                blinkerActive = false;
-                blinkerStartTime = 0;
+            if (blinkerEnabled && !newBlinkerEnabled && motion.blinkerActive) {
+                motion.blinkerActive = false;
+                motion.blinkerStartTime = 0;
                 resetToNormalEffects(); // Reset LEDs to normal state
                 Serial.println("🚦 Blinkers disabled - deactivating current blinker");
             }
@@ -6272,9 +6076,9 @@ void handleAPI() {
             bool newParkModeEnabled = doc["park_mode_enabled"];
             
             // If park mode is being disabled and it's currently active, deactivate it
-            if (parkModeEnabled && !newParkModeEnabled && parkModeActive) {
-                parkModeActive = false;
-                parkStartTime = 0;
+            if (parkModeEnabled && !newParkModeEnabled && motion.parkModeActive) {
+                motion.parkModeActive = false;
+                motion.parkStartTime = 0;
                 resetToNormalEffects(); // Reset LEDs to normal state
                 Serial.println("🅿️ Park mode disabled - deactivating current park mode");
             }
@@ -6401,6 +6205,13 @@ void handleAPI() {
             Serial.printf("🛑 Braking threshold: %.2fG\n", brakingThreshold);
             #endif
         }
+        if (doc.containsKey("braking_latency")) {
+            brakingLatency = constrain((int)doc["braking_latency"], BRAKING_MIN_LATENCY_MS, BRAKING_MAX_LATENCY_MS);
+            saveSettings(); // Auto-save
+            #if DEBUG_ENABLED
+            Serial.printf("🛑 Braking latency budget: %dms\n", brakingLatency);
+            #endif
+        }
         if (doc.containsKey("braking_effect")) {
             brakingEffect = doc["braking_effect"] | 0;
             saveSettings(); // Auto-save
@@ -6418,29 +6229,34 @@ void handleAPI() {
         if (doc.containsKey("manualBlinker")) {
             String manual = doc["manualBlinker"].as<String>();
             if (manual == "left" || manual == "right") {
-                manualBlinkerActive = true;
-                blinkerActive = true;
-                blinkerDirection = (manual == "right") ? 1 : -1;
-                blinkerStartTime = millis();
+                motion.manualBlinkerActive = true;
+                motion.blinkerActive = true;
+                motion.blinkerDirection = (manual == "right") ? 1 : -1;
+                motion.blinkerStartTime = millis();
             } else if (manual == "off") {
-                manualBlinkerActive = false;
-                blinkerActive = false;
-                blinkerDirection = 0;
-                blinkerStartTime = 0;
+                motion.manualBlinkerActive = false;
+                motion.blinkerActive = false;
+                motion.blinkerDirection = 0;
+                motion.blinkerStartTime = 0;
                 resetToNormalEffects();
             }
         }
         if (doc.containsKey("manualBrake")) {
             bool manual = doc["manualBrake"];
-            manualBrakeActive = manual;
-            brakingActive = manual;
-            brakingStartTime = millis();
-            brakingFlashCount = 0;
-            brakingPulseCount = 0;
+            motion.manualBrakeActive = manual;
+            motion.brakingActive = manual;
+            motion.brakingStartTime = millis();
             if (!manual) {
                 resetToNormalEffects();
             }
         }
+        if (doc.containsKey("imu_record")) {
+            if (doc["imu_record"]) {
+                startRecording();
+            } else {
+                stopRecording();
+            }
+        }
         
         // RGBW white channel control
         if (doc.containsKey("rgbw_white_mode")) {
@@ -6480,12 +6296,14 @@ void handleAPI() {
             server.sendHeader("Access-Control-Allow-Origin", "*");
             server.send(200, "application/json", "{\"success\":true,\"message\":\"Defaults restored, restarting...\"}");
             delay(1000);
+            flushSettings();
             ESP.restart();
         }
         if (doc.containsKey("restart") && doc["restart"]) {
             // Restart the device after a delay
             server.send(200, "application/json", "{\"status\":\"restarting\"}");
             delay(1000);
+            flushSettings();
             ESP.restart();
         }
                 if (doc.containsKey("headlightColor")) {
@@ -6626,6 +6444,7 @@ void handleAPI() {
         
         server.sendHeader("Access-Control-Allow-Origin", "*");
         server.send(200, "application/json", "{\"status\":\"ok\"}");
+        noteApiResponse("HTTP");
     } else {
         server.send(400, "application/json", "{\"error\":\"No data\"}");
     }
@@ -6645,20 +6464,36 @@ void buildStatusDocument(DynamicJsonDocument& doc) {
     doc["park_mode_enabled"] = parkModeEnabled;
     doc["impact_detection_enabled"] = impactDetectionEnabled;
     doc["motion_sensitivity"] = motionSensitivity;
+    // Sensor task sampling (interrupts stay 0 when the MPU INT pin isn't wired)
+    doc["motion_sample_rate"] = motionSampleRateHz;
+    doc["motion_samples"] = motionSamplesProcessed;
+    doc["motion_samples_dropped"] = motionSamplesDropped;
+    doc["motion_fifo_overflows"] = motionFifoOverflows;
+    doc["motion_interrupts"] = motionInterrupts;
+    doc["motion_standby"] = motionStandby;
+    doc["motion_wakes"] = motionWakes;
+    doc["recording"] = recording;
+    doc["recording_samples"] = recordingSamples;
+    doc["recording_bytes"] = recordingBytesWritten;
+    doc["recording_dropped"] = recordingDropped;
+    doc["impact_count"] = motion.impactCount;
+    doc["impact_captures"] = impactCaptures;
+    doc["last_impact_g"] = motion.lastImpactG;
 
     // Direction-based lighting status
     doc["direction_based_lighting"] = directionBasedLighting;
     doc["headlight_mode"] = headlightMode;
-    doc["is_moving_forward"] = isMovingForward;
+    doc["is_moving_forward"] = motion.isMovingForward;
     doc["forward_accel_threshold"] = forwardAccelThreshold;
 
     // Braking detection status
     doc["braking_enabled"] = brakingEnabled;
-    doc["braking_active"] = brakingActive;
+    doc["braking_active"] = motion.brakingActive;
     doc["braking_threshold"] = brakingThreshold;
+    doc["braking_latency"] = brakingLatency;
     doc["braking_effect"] = brakingEffect;
     doc["braking_brightness"] = brakingBrightness;
-    doc["manual_brake_active"] = manualBrakeActive;
+    doc["manual_brake_active"] = motion.manualBrakeActive;
 
     doc["blinker_delay"] = blinkerDelay;
     doc["blinker_timeout"] = blinkerTimeout;
@@ -6676,10 +6511,10 @@ void buildStatusDocument(DynamicJsonDocument& doc) {
     doc["park_taillight_color_g"] = parkTaillightColor.g;
     doc["park_taillight_color_b"] = parkTaillightColor.b;
     doc["park_brightness"] = parkBrightness;
-    doc["blinker_active"] = blinkerActive;
-    doc["blinker_direction"] = blinkerDirection;
-    doc["manual_blinker_active"] = manualBlinkerActive;
-    doc["park_mode_active"] = parkModeActive;
+    doc["blinker_active"] = motion.blinkerActive;
+    doc["blinker_direction"] = motion.blinkerDirection;
+    doc["manual_blinker_active"] = motion.manualBlinkerActive;
+    doc["park_mode_active"] = motion.parkModeActive;
     doc["calibration_complete"] = calibrationComplete;
     doc["calibration_mode"] = calibrationMode;
     doc["calibration_step"] = calibrationStep;
@@ -6713,6 +6548,39 @@ void buildStatusDocument(DynamicJsonDocument& doc) {
     doc["headlightColorOrder"] = headlightColorOrder;
     doc["taillightColorOrder"] = taillightColorOrder;
 
+    // LED output (frames with no pixel/brightness change are not re-sent)
+    doc["frames_sent"] = framesSent;
+    doc["frames_skipped"] = framesSkipped;
+    doc["render_task"] = renderTaskHandle != nullptr;
+    doc["render_frames"] = renderFrames;
+    doc["render_snapshot_retries"] = renderSnapshotRetries;
+    doc["async_output"] = asyncLedOutput;
+    doc["output_show_us"] = ledOutputShowUs;
+    doc["output_fence_waits"] = ledOutputFenceWaits;
+    doc["target_fps"] = frameClockFps(frameClock);
+    doc["frames_dropped"] = frameClock.dropped;
+    doc["command_latency_us"] = lastCommandLatencyUs;
+    doc["loop_wakeups"] = loopWakeups;
+    // Idle power mode (render_parked_ms = render task parked; power_light_sleep says if it could sleep)
+    doc["power_save"] = powerSaveEnabled;
+    doc["power_idle"] = (bool)renderIdle;
+    doc["render_parked_ms"] = renderParkedMs;
+    doc["power_idle_entries"] = powerIdleEntries;
+    doc["power_light_sleep"] = powerLightSleep;
+    // Write-behind settings (flash writes performed vs. saves coalesced)
+    doc["settings_pending"] = settingsDirty;
+    doc["settings_commits"] = settingsCommits;
+    doc["settings_commit_failures"] = settingsCommitFailures;
+    doc["settings_writes_avoided"] = settingsWritesAvoided;
+    // Boot timing (ms since boot, 0 = not reached yet)
+    doc["boot_first_frame_ms"] = bootFirstFrameMs;
+    doc["boot_setup_ms"] = bootSetupMs;
+    doc["boot_first_api_ms"] = bootFirstApiMs;
+
+    // Render memory (arena allocations only change when the LED config does)
+    doc["frame_arena_bytes"] = frameArena.bytes;
+    doc["frame_arena_allocations"] = frameArena.allocations;
+
     // ESPNow status
     doc["enableESPNow"] = enableESPNow;
     doc["useESPNowSync"] = useESPNowSync;
@@ -6758,6 +6626,88 @@ void handleStatus() {
     sendJSONResponse(doc);
 }
 
+void appendFrameHistogram(JsonObject out, const FrameHistogram& histogram) {
+    out["samples"] = histogram.samples;
+    out["min_us"] = histogram.samples > 0 ? histogram.minUs : 0;
+    out["avg_us"] = frameHistogramMeanUs(histogram);
+    out["p50_us"] = frameHistogramPercentile(histogram, 50);
+    out["p90_us"] = frameHistogramPercentile(histogram, 90);
+    out["p99_us"] = frameHistogramPercentile(histogram, 99);
+    out["max_us"] = histogram.maxUs;
+    JsonArray counts = out.createNestedArray("counts");
+    for (uint8_t b = 0; b < FRAME_HISTOGRAM_BUCKETS; b++) {
+        counts.add(histogram.counts[b]);
+    }
+}
+
+void buildFrameStatsDocument(DynamicJsonDocument& doc) {
+    doc["target_fps"] = frameClockFps(frameClock);
+    doc["period_us"] = frameClock.periodUs;
+    doc["frames"] = frameClock.frames;
+    doc["dropped"] = frameClock.dropped;
+    // Bucket upper bounds; the last bucket is open-ended
+    JsonArray bounds = doc.createNestedArray("bucket_bounds_us");
+    for (uint8_t b = 0; b < FRAME_HISTOGRAM_BUCKETS - 1; b++) {
+        bounds.add(frameHistogramBoundsUs[b]);
+    }
+    appendFrameHistogram(doc.createNestedObject("interval"), frameIntervalHistogram);
+    appendFrameHistogram(doc.createNestedObject("render"), renderTimeHistogram);
+    appendFrameHistogram(doc.createNestedObject("show"), showTimeHistogram);
+    appendFrameHistogram(doc.createNestedObject("command_latency"), commandLatencyHistogram);
+}
+
+// Per-stage cycle counts (?reset clears them after this report)
+void handlePerf() {
+    uint32_t mhz = getCpuFrequencyMhz();
+    DynamicJsonDocument doc(2048);
+    doc["cpu_mhz"] = mhz;
+    JsonObject stages = doc.createNestedObject("stages");
+    for (uint8_t i = 0; i < PERF_STAGE_COUNT; i++) {
+        const PerfStats& stats = perfStats[i];
+        JsonObject stage = stages.createNestedObject(perfStageNames[i]);
+        stage["samples"] = stats.samples;
+        stage["min_cycles"] = stats.samples > 0 ? stats.minCycles : 0;
+        stage["avg_cycles"] = perfMeanCycles(stats);
+        stage["p99_cycles"] = perfPercentile(stats, 99);
+        stage["max_cycles"] = stats.maxCycles;
+        stage["avg_us"] = perfMeanCycles(stats) / mhz;
+        stage["p99_us"] = perfPercentile(stats, 99) / mhz;
+        stage["max_us"] = stats.maxCycles / mhz;
+    }
+    if (server.hasArg("reset")) {
+        resetPerfStats();
+    }
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+    sendJSONResponse(doc);
+}
+
+// Last ride log (see RECORDER_PATH), or with ?impact the last impact
+// capture, for the host replay harness
+void handleRecordingDownload() {
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+    if (recording || recorderFileOpen) {
+        server.send(409, "text/plain", "Recording in progress");
+        return;
+    }
+    File file = SPIFFS.open(server.hasArg("impact") ? IMPACT_CAPTURE_PATH : RECORDER_PATH, "r");
+    if (!file) {
+        server.send(404, "text/plain", "No recording");
+        return;
+    }
+    server.streamFile(file, "application/octet-stream");
+    file.close();
+}
+
+void handleFrameStats() {
+    DynamicJsonDocument doc(3072);
+    buildFrameStatsDocument(doc);
+    if (server.hasArg("reset")) {
+        frameStatsResetPending = true;
+    }
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+    sendJSONResponse(doc);
+}
+
 String getStatusJSON() {
     // Full status for both HTTP and BLE - single source of truth
     DynamicJsonDocument doc(4096);
@@ -6769,13 +6719,14 @@ String getStatusJSON() {
 
 void handleLEDConfig() {
     if (server.hasArg("plain")) {
+        LEDLock lock;  // Counts and buffers change together
         DynamicJsonDocument doc(1024);
         deserializeJson(doc, server.arg("plain"));
         
         bool configChanged = false;
         
         if (doc.containsKey("headlightLedCount")) {
-            uint8_t newHeadlightCount = doc["headlightLedCount"];
+            uint16_t newHeadlightCount = clampLedCount(doc["headlightLedCount"]);
             if (newHeadlightCount != headlightLedCount) {
                 Serial.printf("LED Config: Headlight count changed from %d to %d\n", headlightLedCount, newHeadlightCount);
                 headlightLedCount = newHeadlightCount;
@@ -6783,7 +6734,7 @@ void handleLEDConfig() {
             }
         }
         if (doc.containsKey("taillightLedCount")) {
-            uint8_t newTaillightCount = doc["taillightLedCount"];
+            uint16_t newTaillightCount = clampLedCount(doc["taillightLedCount"]);
             if (newTaillightCount != taillightLedCount) {
                 Serial.printf("LED Config: Taillight count changed from %d to %d\n", taillightLedCount, newTaillightCount);
                 taillightLedCount = newTaillightCount;
@@ -6872,76 +6823,75 @@ void handleGetSettings() {
     
     server.sendHeader("Access-Control-Allow-Origin", "*");
     server.send(200, "application/json", settingsJson);
+    noteApiResponse("HTTP");
 }
 
 void sendJSONResponse(DynamicJsonDocument& doc) {
     String response;
     serializeJson(doc, response);
     server.send(200, "application/json", response);
+    noteApiResponse("HTTP");
 }
 
-// LED Configuration Implementation
-// RGBW controllers for SK6812 RGBW LEDs - dynamically created based on color order
-
-// Function to convert CRGB color based on color order for RGBW LEDs
-CRGB convertColorOrder(CRGB color, uint8_t colorOrder) {
-    switch (colorOrder) {
-        case 0: // RGB - no conversion needed
-            return color;
-        case 1: // GRB - swap R and G
-            return CRGB(color.g, color.r, color.b);
-        case 2: // BGR - swap R and B
-            return CRGB(color.b, color.g, color.r);
-        default:
-            return color;
-    }
-}
-
-// Helper function to set LED color with proper color order conversion
-void setLEDColor(CRGB* leds, uint8_t index, CRGB color, uint8_t ledType, uint8_t colorOrder) {
-    if (ledType == 0) { // RGBW LEDs need color order conversion
-        leds[index] = convertColorOrder(color, colorOrder);
-    } else {
-        leds[index] = color;
-    }
+// Record how long after boot the first API response went out
+void noteApiResponse(const char* transport) {
+    if (bootFirstApiMs != 0) return;
+    bootFirstApiMs = millis();
+    Serial.printf("⏱️ First API response (%s) %lums after boot\n", transport, (unsigned long)bootFirstApiMs);
 }
 
-// Wrapper functions for RGBW color order handling
-void fillSolidWithColorOrder(CRGB* leds, uint8_t numLeds, CRGB color, uint8_t ledType, uint8_t colorOrder) {
-    if (ledType == 0) { // RGBW LEDs - convert color order in software
-        // RGBWEmulatedController uses RGB internally, so we need to convert
-        // the color to match what the physical LEDs expect
-        CRGB convertedColor = convertColorOrder(color, colorOrder);
-        fill_solid(leds, numLeds, convertedColor);
-    } else {
-        // For RGB-only LEDs, FastLED handles color order via template parameter
-        fill_solid(leds, numLeds, color);
-    }
+// LED Configuration Implementation
+// LED counts from the API or saved settings are limited to 1..MAX_LEDS_PER_STRIP
+uint16_t clampLedCount(long count) {
+    return constrain(count, 1L, (long)MAX_LEDS_PER_STRIP);
+}
+
+// RGBW controllers for SK6812 RGBW LEDs - one static controller per pin and color order.
+// RGBWEmulatedController's ORDER parameter reorders each pixel while the frame is
+// packed for output (the device controller underneath must stay RGB), so frames
+// stay in plain RGB and no separate color order pass over the buffer is needed.
+template <uint8_t PIN, EOrder ORDER>
+CLEDController* addRGBWLeds(CRGB* leds, uint16_t count) {
+    typedef SK6812<PIN, RGB> DeviceControllerT;
+    static RGBWEmulatedController<DeviceControllerT, ORDER> controller(
+        Rgbw(kRGBWDefaultColorTemp, kRGBWNullWhitePixel, W3)
+    );
+    return &FastLED.addLeds(&controller, leds, count);
 }
 
-// Apply color order conversion to entire LED array (for effects that write directly)
-void applyColorOrderToArray(CRGB* leds, uint8_t numLeds, uint8_t ledType, uint8_t colorOrder) {
-    if (ledType == 0) { // RGBW LEDs need color order conversion
-        for (uint8_t i = 0; i < numLeds; i++) {
-            leds[i] = convertColorOrder(leds[i], colorOrder);
-        }
+template <uint8_t PIN>
+CLEDController* addRGBWLedsForOrder(uint8_t colorOrder, CRGB* leds, uint16_t count) {
+    switch (colorOrder) {
+        case 1: return addRGBWLeds<PIN, GRB>(leds, count);
+        case 2: return addRGBWLeds<PIN, BGR>(leds, count);
+        default: return addRGBWLeds<PIN, RGB>(leds, count);
     }
-    // For RGB-only LEDs, color order is handled by FastLED template parameter
 }
 
-void fillRainbowWithColorOrder(CRGB* leds, uint8_t numLeds, uint8_t initialHue, uint8_t deltaHue, uint8_t ledType, uint8_t colorOrder) {
-    if (ledType == 0) { // RGBW LEDs need color order conversion
-        fill_rainbow(leds, numLeds, initialHue, deltaHue);
-        for (uint8_t i = 0; i < numLeds; i++) {
-            leds[i] = convertColorOrder(leds[i], colorOrder);
-        }
-    } else {
-        fill_rainbow(leds, numLeds, initialHue, deltaHue);
+// FastLED keeps every controller registered once added. When a strip moves to a
+// different controller (type or color order change), park the old one on an
+// empty buffer so it stops reading the freed LED array.
+void detachLEDController(CLEDController* previous, CLEDController* current) {
+    static CRGB detachedPixel;
+    if (previous != nullptr && previous != current) {
+        previous->setLeds(&detachedPixel, 0);
     }
 }
 
 void initializeLEDs() {
+    LEDLock lock;  // Arrays and controllers are replaced - keep the render task out
+    CLEDController* previousHeadlightController = headlightController;
+    CLEDController* previousTaillightController = taillightController;
+    
     // Clean up existing memory if arrays exist
+    if (headlightBack != nullptr && headlightBack != headlight) {
+        delete[] headlightBack;
+    }
+    if (taillightBack != nullptr && taillightBack != taillight) {
+        delete[] taillightBack;
+    }
+    headlightBack = nullptr;
+    taillightBack = nullptr;
     if (headlight != nullptr) {
         delete[] headlight;
         headlight = nullptr;
@@ -6957,19 +6907,39 @@ void initializeLEDs() {
     
     Serial.printf("LED Init: Allocated %d headlight LEDs and %d taillight LEDs\n", headlightLedCount, taillightLedCount);
     
+    // Size the render scratch frames and effect state once for this config (rendering itself never allocates)
+    uint16_t maxLedCount = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
+    uint16_t headlightStateBytes = effectStateBytes(headlightLedCount);
+    uint16_t taillightStateBytes = effectStateBytes(taillightLedCount);
+    if (!frameArenaReserve(frameArena, maxLedCount, headlightStateBytes + taillightStateBytes)) {
+        Serial.println("❌ LED Init: Failed to allocate render frame arena");
+        effectStateBind(headlightTiming.state, nullptr, 0);
+        effectStateBind(taillightTiming.state, nullptr, 0);
+    } else {
+        // Each strip gets its own effect state, sized to its LED count
+        effectStateBind(headlightTiming.state, frameArena.statePool(), headlightStateBytes);
+        effectStateBind(taillightTiming.state, frameArena.statePool() + headlightStateBytes, taillightStateBytes);
+        Serial.printf("LED Init: Frame arena %d slots x %d LEDs + %d state bytes (%d bytes)\n", FRAME_SLOT_COUNT, frameArena.slotLeds, frameArena.stateBytes, frameArena.bytes);
+    }
+    
+    // Back frames for double-buffered output. Without the arena the base
+    // effects render straight into the output arrays, so there is nothing to swap.
+    if (frameArena.block != nullptr) {
+        headlightBack = new CRGB[headlightLedCount];
+        taillightBack = new CRGB[taillightLedCount];
+    } else {
+        headlightBack = headlight;
+        taillightBack = taillight;
+    }
+    bindLayerStacks();
+    
     // Clear FastLED
     FastLED.clear();
     
     // Add LED strips based on configuration
     switch (headlightLedType) {
-        case 0: // SK6812 RGBW - Use RGBW emulation
-            // RGBWEmulatedController requires underlying controller to use RGB order
-            // Color order conversion is handled in software via fillSolidWithColorOrder
-            typedef SK6812<HEADLIGHT_PIN, RGB> HeadlightControllerT;
-            static RGBWEmulatedController<HeadlightControllerT, RGB> headlightRGBWController(
-                Rgbw(kRGBWDefaultColorTemp, kRGBWNullWhitePixel, W3)
-            );
-            headlightController = &FastLED.addLeds(&headlightRGBWController, headlight, headlightLedCount);
+        case 0: // SK6812 RGBW - Use RGBW emulation (color order applied on output)
+            headlightController = addRGBWLedsForOrder<HEADLIGHT_PIN>(headlightColorOrder, headlight, headlightLedCount);
             break;
         case 1: // SK6812 RGB - Use RGB only
             if (headlightColorOrder == 0) headlightController = &FastLED.addLeds<SK6812, HEADLIGHT_PIN, RGB>(headlight, headlightLedCount);
@@ -6984,14 +6954,8 @@ void initializeLEDs() {
     }
     
     switch (taillightLedType) {
-        case 0: // SK6812 RGBW - Use RGBW emulation
-            // RGBWEmulatedController requires underlying controller to use RGB order
-            // Color order conversion is handled in software via fillSolidWithColorOrder
-            typedef SK6812<TAILLIGHT_PIN, RGB> TaillightControllerT;
-            static RGBWEmulatedController<TaillightControllerT, RGB> taillightRGBWController(
-                Rgbw(kRGBWDefaultColorTemp, kRGBWNullWhitePixel, W3)
-            );
-            taillightController = &FastLED.addLeds(&taillightRGBWController, taillight, taillightLedCount);
+        case 0: // SK6812 RGBW - Use RGBW emulation (color order applied on output)
+            taillightController = addRGBWLedsForOrder<TAILLIGHT_PIN>(taillightColorOrder, taillight, taillightLedCount);
             break;
         case 1: // SK6812 RGB - Use RGB only
             if (taillightColorOrder == 0) taillightController = &FastLED.addLeds<SK6812, TAILLIGHT_PIN, RGB>(taillight, taillightLedCount);
@@ -7004,13 +6968,73 @@ void initializeLEDs() {
             else if (taillightColorOrder == 2) taillightController = &FastLED.addLeds<WS2812B, TAILLIGHT_PIN, BGR>(taillight, taillightLedCount);
             break;
     }
+    detachLEDController(previousHeadlightController, headlightController);
+    detachLEDController(previousTaillightController, taillightController);
 
     applyRgbwWhiteChannelMode();
     
     FastLED.setBrightness(globalBrightness);
+    invalidateShownFrames();
     Serial.printf("LED strips initialized successfully! Headlight: %d LEDs, Taillight: %d LEDs\n", headlightLedCount, taillightLedCount);
 }
 
+// Point the layer stacks at this LED config's frames. Without a frame arena
+// the base effects render straight into the output arrays (composited in place).
+void bindLayerStacks() {
+    bool haveArena = frameArena.block != nullptr;
+    headlightBase = haveArena ? frameArena.slot(FRAME_HEADLIGHT_BASE) : headlight;
+    taillightBase = haveArena ? frameArena.slot(FRAME_TAILLIGHT_BASE) : taillight;
+    brakeFrame = haveArena ? frameArena.slot(FRAME_BRAKE) : nullptr;
+    
+    LayerStack* stacks[] = { &headlightLayers, &taillightLayers };
+    CRGB* bases[] = { headlightBase, taillightBase };
+    for (uint8_t s = 0; s < 2; s++) {
+        Layer* layers = stacks[s]->layers;
+        layers[LAYER_BASE].pixels = bases[s];
+        layerFadeTo(layers[LAYER_BASE], 255, LAYER_FADE_INSTANT);
+        layers[LAYER_BRAKE].pixels = nullptr;
+        layers[LAYER_BRAKE].color = CRGB::Red;
+        layerFadeTo(layers[LAYER_BRAKE], 0, LAYER_FADE_INSTANT);
+        layers[LAYER_BLINKER].color = CRGB::Yellow;
+        layerFadeTo(layers[LAYER_BLINKER], 0, LAYER_FADE_INSTANT);
+        layers[LAYER_IMPACT].color = CRGB::White;
+        layerFadeTo(layers[LAYER_IMPACT], 0, LAYER_FADE_INSTANT);
+    }
+}
+
+// Push the current frame to the strips, but only if a strip's pixels or the
+// global brightness changed since the last frame that went out.
+// FastLED's ESP32 RMT driver only transmits once every registered controller
+// has been shown, so a dirty strip still goes out through FastLED.show().
+void showLEDs() {
+    if (headlight == nullptr || taillight == nullptr) {
+        FastLED.show();
+        return;
+    }
+
+    if (ledFramesDirty()) {
+        PerfScope perf(perfStats[PERF_SHOW]);
+        FastLED.show();
+        framesSent++;
+    } else {
+        framesSkipped++;
+    }
+}
+
+// True if either strip's front frame (or the brightness) changed since the last frame sent
+bool ledFramesDirty() {
+    uint8_t brightness = FastLED.getBrightness();
+    // Evaluate both so each strip's hash stays current
+    bool headlightDirty = stripFrameChanged(headlightShown, headlight, headlightLedCount, brightness);
+    bool taillightDirty = stripFrameChanged(taillightShown, taillight, taillightLedCount, brightness);
+    return headlightDirty || taillightDirty;
+}
+
+void invalidateShownFrames() {
+    stripFrameInvalidate(headlightShown);
+    stripFrameInvalidate(taillightShown);
+}
+
 void applyRgbwWhiteChannelMode() {
     Rgbw rgbwMode = Rgbw(kRGBWDefaultColorTemp, kRGBWNullWhitePixel, W3);
 
@@ -7035,6 +7059,9 @@ void applyRgbwWhiteChannelMode() {
     if (taillightController) {
         taillightController->setRgbw(rgbwMode);
     }
+
+    // White channel mapping changed - same pixels produce different output
+    invalidateShownFrames();
 }
 
 void setRgbwWhiteMode(uint8_t mode) {
@@ -7045,29 +7072,30 @@ void setRgbwWhiteMode(uint8_t mode) {
 
 void testLEDConfiguration() {
     Serial.println("Testing LED configuration...");
+    LEDLock lock;  // Render task waits until the test pattern is done
     
-    // Test red - use fillSolidWithColorOrder to respect color order settings
-    fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::Red, headlightLedType, headlightColorOrder);
-    fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::Red, taillightLedType, taillightColorOrder);
-    FastLED.show();
+    // Test red (color order is applied by the strip's controller)
+    fill_solid(headlight, headlightLedCount, CRGB::Red);
+    fill_solid(taillight, taillightLedCount, CRGB::Red);
+    showLEDs();
     delay(1000);
     
     // Test green
-    fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::Green, headlightLedType, headlightColorOrder);
-    fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::Green, taillightLedType, taillightColorOrder);
-    FastLED.show();
+    fill_solid(headlight, headlightLedCount, CRGB::Green);
+    fill_solid(taillight, taillightLedCount, CRGB::Green);
+    showLEDs();
     delay(1000);
     
     // Test blue
-    fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::Blue, headlightLedType, headlightColorOrder);
-    fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::Blue, taillightLedType, taillightColorOrder);
-    FastLED.show();
+    fill_solid(headlight, headlightLedCount, CRGB::Blue);
+    fill_solid(taillight, taillightLedCount, CRGB::Blue);
+    showLEDs();
     delay(1000);
     
     // Test white (using white channel for RGBW LEDs)
-    fillSolidWithColorOrder(headlight, headlightLedCount, CRGB::White, headlightLedType, headlightColorOrder);
-    fillSolidWithColorOrder(taillight, taillightLedCount, CRGB::White, taillightLedType, taillightColorOrder);
-    FastLED.show();
+    fill_solid(headlight, headlightLedCount, CRGB::White);
+    fill_solid(taillight, taillightLedCount, CRGB::White);
+    showLEDs();
     delay(1000);
     
     Serial.println("LED test complete!");
@@ -7114,7 +7142,49 @@ void initFilesystem() {
 }
 
 // Save all settings to filesystem
+// Mark the settings for saving; loop() writes them out once changes stop
 bool saveSettings() {
+    uint32_t now = millis();
+    if (settingsDirty) {
+        settingsWritesAvoided++;
+    } else {
+        settingsDirty = true;
+        settingsFirstChangeMs = now;
+    }
+    settingsLastChangeMs = now;
+    return true;
+}
+
+// Commit pending settings once they've been quiet long enough (called by loop())
+void serviceSettingsCache() {
+    if (!settingsDirty || otaInProgress) return;
+    uint32_t now = millis();
+    if (now - settingsLastChangeMs >= SETTINGS_QUIET_MS || now - settingsFirstChangeMs >= SETTINGS_MAX_DELAY_MS) {
+        commitSettings();
+    }
+}
+
+// Commit pending settings now (before a restart or OTA update)
+bool flushSettings() {
+    if (!settingsDirty) return true;
+    return commitSettings();
+}
+
+// Write the settings out, keeping them pending for another try if neither
+// NVS nor SPIFFS took them
+bool commitSettings() {
+    PerfScope perf(perfStats[PERF_SAVE_SETTINGS]);
+    settingsDirty = false;  // Changes made while writing mark it dirty again
+    settingsCommits++;
+    if (writeSettings()) return true;
+    settingsCommitFailures++;
+    settingsDirty = true;
+    settingsFirstChangeMs = settingsLastChangeMs = millis();  // Retry after SETTINGS_QUIET_MS, not every pass
+    return false;
+}
+
+// Write the settings to NVS and SPIFFS
+bool writeSettings() {
     DynamicJsonDocument doc(8192);
     
     // Light settings
@@ -7165,6 +7235,7 @@ bool saveSettings() {
     // Braking detection settings
     doc["braking_enabled"] = brakingEnabled;
     doc["braking_threshold"] = brakingThreshold;
+    doc["braking_latency"] = brakingLatency;
     doc["braking_effect"] = brakingEffect;
     doc["braking_brightness"] = brakingBrightness;
     
@@ -7330,6 +7401,7 @@ bool saveSettingsToNVS() {
     // Braking detection settings
     doc["braking_enabled"] = brakingEnabled;
     doc["braking_threshold"] = brakingThreshold;
+    doc["braking_latency"] = brakingLatency;
     doc["braking_effect"] = brakingEffect;
     doc["braking_brightness"] = brakingBrightness;
     
@@ -7544,6 +7616,7 @@ bool loadSettings() {
     // Load braking detection settings
     brakingEnabled = doc["braking_enabled"] | false;  // Default to disabled
     brakingThreshold = doc["braking_threshold"] | -0.5;
+    brakingLatency = constrain((int)(doc["braking_latency"] | BRAKING_DEFAULT_LATENCY_MS), BRAKING_MIN_LATENCY_MS, BRAKING_MAX_LATENCY_MS);
     brakingEffect = doc["braking_effect"] | 0;
     brakingBrightness = doc["braking_brightness"] | 255;
     
@@ -7566,8 +7639,8 @@ bool loadSettings() {
     otaUpdateURL = doc["ota_update_url"] | "";
     
     // Load LED configuration
-    headlightLedCount = doc["headlight_count"] | 11;
-    taillightLedCount = doc["taillight_count"] | 11;
+    headlightLedCount = clampLedCount(doc["headlight_count"] | 11);
+    taillightLedCount = clampLedCount(doc["taillight_count"] | 11);
     headlightLedType = doc["headlight_type"] | 0;  // SK6812
     taillightLedType = doc["taillight_type"] | 0;  // SK6812
     headlightColorOrder = doc["headlight_order"] | 1;  // GRB - Default for SK6812 RGBW
@@ -7766,6 +7839,7 @@ bool loadSettingsFromNVS() {
     // Braking detection settings
     brakingEnabled = doc["braking_enabled"] | false;
     brakingThreshold = doc["braking_threshold"] | -0.5;
+    brakingLatency = constrain((int)(doc["braking_latency"] | BRAKING_DEFAULT_LATENCY_MS), BRAKING_MIN_LATENCY_MS, BRAKING_MAX_LATENCY_MS);
     brakingEffect = doc["braking_effect"] | 0;
     brakingBrightness = doc["braking_brightness"] | 255;
     
@@ -7784,8 +7858,8 @@ bool loadSettingsFromNVS() {
     otaUpdateURL = doc["ota_update_url"] | "";
     
     // Load LED configuration
-    headlightLedCount = doc["headlight_count"] | 11;
-    taillightLedCount = doc["taillight_count"] | 11;
+    headlightLedCount = clampLedCount(doc["headlight_count"] | 11);
+    taillightLedCount = clampLedCount(doc["taillight_count"] | 11);
     headlightLedType = doc["headlight_type"] | 0;
     taillightLedType = doc["taillight_type"] | 0;
     headlightColorOrder = doc["headlight_order"] | 1;
@@ -8016,6 +8090,12 @@ const char* espNowErrorName(esp_err_t error) {
     return name ? name : "UNKNOWN";
 }
 
+// esp_now_send, timed into the profiler (the radio sends asynchronously; this is the queueing cost)
+esp_err_t espNowSend(const uint8_t* peer, const uint8_t* data, size_t len) {
+    PerfScope perf(perfStats[PERF_ESPNOW_SEND]);
+    return esp_now_send(peer, data, len);
+}
+
 void sendESPNowData() {
     if (!enableESPNow || !useESPNowSync || espNowState != 1) {
         return;
@@ -8026,7 +8106,7 @@ void sendESPNowData() {
     }
     
     // Only send if not in motion-based effects (blinkers, park mode)
-    if (blinkerActive || parkModeActive) {
+    if (motion.blinkerActive || motion.parkModeActive) {
         return;
     }
     
@@ -8088,7 +8168,9 @@ void sendESPNowData() {
     // Add timing coordination data
     data.syncTimestamp = currentTime;
     data.masterStep = (headlightTiming.step > taillightTiming.step) ? headlightTiming.step : taillightTiming.step;
-    data.stripLength = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
+    // stripLength stays 8-bit on the wire for older peers; longer strips saturate
+    uint16_t maxLength = (headlightLedCount > taillightLedCount) ? headlightLedCount : taillightLedCount;
+    data.stripLength = min(maxLength, (uint16_t)255);
     
     // Calculate checksum
     data.checksum = 0;
@@ -8097,7 +8179,7 @@ void sendESPNowData() {
         data.checksum ^= dataPtr[i];
     }
     
-    esp_err_t result = esp_now_send(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
+    esp_err_t result = espNowSend(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
     if (result == ESP_OK) {
         lastESPNowSend = currentTime;
         lastSyncState.brightness = globalBrightness;
@@ -8288,7 +8370,7 @@ void sendGroupHeartbeat() {
         data.checksum ^= dataPtr[i];
     }
     
-    esp_err_t result = esp_now_send(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
+    esp_err_t result = espNowSend(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
     if (result != ESP_OK) {
         espNowLastError = result;
         if (result == ESP_ERR_ESPNOW_NOT_INIT || result == ESP_ERR_INVALID_STATE) {
@@ -8330,7 +8412,7 @@ void sendJoinRequest() {
         data.checksum ^= dataPtr[i];
     }
     
-    esp_err_t result = esp_now_send(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
+    esp_err_t result = espNowSend(espNowBroadcastAddress, (uint8_t*)&data, sizeof(data));
     if (result != ESP_OK) {
         espNowLastError = result;
         if (result == ESP_ERR_ESPNOW_NOT_INIT || result == ESP_ERR_INVALID_STATE) {
@@ -8368,7 +8450,7 @@ void sendJoinResponse(const uint8_t* mac_addr, bool accept) {
         data.checksum ^= dataPtr[i];
     }
     
-    esp_now_send(mac_addr, (uint8_t*)&data, sizeof(data));
+    espNowSend(mac_addr, (uint8_t*)&data, sizeof(data));
     Serial.printf("Group: Sent join %s to %02x:%02x:%02x:%02x:%02x:%02x\n", 
                   accept ? "accept" : "reject", mac_addr[0], mac_addr[1], mac_addr[2], 
                   mac_addr[3], mac_addr[4], mac_addr[5]);